@@ -0,0 +1,176 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+#include "BenchScenes.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "core/Engine.h"
+#include "core/renderer/IGraphicsDevice.h"
+
+namespace RedPlasma::Bench {
+    namespace {
+        constexpr float Identity[16] = {
+            1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+
+        // The default frame as the editor draws it, measures the fixed per-frame overhead.
+        class TriangleScene : public BenchScene {
+        public:
+            [[nodiscard]] const char* GetName() const override { return "triangle"; }
+
+            int Setup(Engine& engine, BenchHost&) override {
+                std::vector<Vertex> triangle = {
+                    {0.0f, -0.5f, 0.0f},
+                    {0.5f, 0.5f, 0.0f},
+                    {-0.5f, 0.5f, 0.0f}
+                };
+                m_Mesh = engine.GetGraphicsDevice()->UploadMeshData(triangle);
+                return m_Mesh < 0 ? m_Mesh : 0;
+            }
+
+            void Update(Engine& engine, BenchHost&, uint32_t) override {
+                engine.GetGraphicsDevice()->SubmitDraw(m_Mesh, 0, Identity);
+            }
+
+        private:
+            int m_Mesh = 0;
+        };
+
+        // Changes the surface size every 64 frames, measures the cost of swapchain recreation.
+        class ResizeScene : public TriangleScene {
+        public:
+            [[nodiscard]] const char* GetName() const override { return "resize"; }
+
+            void Update(Engine& engine, BenchHost& host, uint32_t frame) override {
+                TriangleScene::Update(engine, host, frame);
+                if (frame % 64 == 63) {
+                    bool large = (frame / 64) % 2 == 0;
+                    host.Resize(large ? 1600 : 960, large ? 900 : 540);
+                }
+            }
+        };
+
+        // A grid of small indexed quads, one draw each. Measures upload throughput in Setup and per-draw cost afterwards.
+        class MeshesScene : public BenchScene {
+        public:
+            MeshesScene(const char* name, uint32_t gridSize) : m_Name(name), m_GridSize(gridSize) {}
+
+            [[nodiscard]] const char* GetName() const override { return m_Name; }
+
+            int Setup(Engine& engine, BenchHost&) override {
+                const uint32_t gridSize = m_GridSize;
+                const float cell = 2.0f / gridSize;
+                const uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+                for (uint32_t y = 0; y < gridSize; y++) {
+                    for (uint32_t x = 0; x < gridSize; x++) {
+                        float left = -1.0f + x * cell + cell * 0.1f;
+                        float top = -1.0f + y * cell + cell * 0.1f;
+                        float size = cell * 0.8f;
+                        const Vertex quad[] = {
+                            {left, top, 0.0f},
+                            {left + size, top, 0.0f},
+                            {left + size, top + size, 0.0f},
+                            {left, top + size, 0.0f}
+                        };
+                        int mesh = engine.GetGraphicsDevice()->UploadMeshData(quad, 4, indices, 6);
+                        if (mesh < 0) {
+                            return mesh;
+                        }
+                        m_Meshes.push_back(mesh);
+                    }
+                }
+                return 0;
+            }
+
+            void Update(Engine& engine, BenchHost&, uint32_t) override {
+                for (int mesh : m_Meshes) {
+                    engine.GetGraphicsDevice()->SubmitDraw(mesh, 0, Identity);
+                }
+            }
+
+        private:
+            const char* m_Name;
+            uint32_t m_GridSize;
+            std::vector<int> m_Meshes;
+        };
+
+        // The same grid as one quad mesh drawn at every cell with a handful of materials. The draw list merges it
+        // into one instanced draw per material, so this measures submission and sorting rather than draw calls.
+        class InstancesScene : public BenchScene {
+        public:
+            explicit InstancesScene(uint32_t gridSize) : m_GridSize(gridSize) {}
+
+            [[nodiscard]] const char* GetName() const override { return "instances"; }
+
+            int Setup(Engine& engine, BenchHost&) override {
+                const float size = 2.0f / m_GridSize * 0.8f;
+                const Vertex quad[] = {
+                    {0.0f, 0.0f, 0.0f},
+                    {size, 0.0f, 0.0f},
+                    {size, size, 0.0f},
+                    {0.0f, size, 0.0f}
+                };
+                const uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+                m_Mesh = engine.GetGraphicsDevice()->UploadMeshData(quad, 4, indices, 6);
+                if (m_Mesh < 0) {
+                    return m_Mesh;
+                }
+
+                for (uint32_t i = 0; i < MaterialCount; i++) {
+                    MaterialDesc material;
+                    material.color[0] = 0.25f + 0.25f * static_cast<float>(i);
+                    int handle = engine.GetGraphicsDevice()->CreateMaterial(material);
+                    if (handle < 0) {
+                        return handle;
+                    }
+                    m_Materials[i] = handle;
+                }
+                return 0;
+            }
+
+            void Update(Engine& engine, BenchHost&, uint32_t) override {
+                const float cell = 2.0f / m_GridSize;
+                float transform[16];
+                std::copy(std::begin(Identity), std::end(Identity), transform);
+                for (uint32_t y = 0; y < m_GridSize; y++) {
+                    for (uint32_t x = 0; x < m_GridSize; x++) {
+                        transform[12] = -1.0f + x * cell + cell * 0.1f;
+                        transform[13] = -1.0f + y * cell + cell * 0.1f;
+                        engine.GetGraphicsDevice()->SubmitDraw(m_Mesh, m_Materials[(x + y) % MaterialCount], transform);
+                    }
+                }
+            }
+
+        private:
+            static constexpr uint32_t MaterialCount = 4;
+            uint32_t m_GridSize;
+            int m_Mesh = 0;
+            int m_Materials[MaterialCount] = {};
+        };
+    }
+
+    std::vector<std::unique_ptr<BenchScene>> CreateScenes() {
+        std::vector<std::unique_ptr<BenchScene>> scenes;
+        scenes.push_back(std::make_unique<TriangleScene>());
+        scenes.push_back(std::make_unique<ResizeScene>());
+        scenes.push_back(std::make_unique<MeshesScene>("meshes", 16));
+        // Enough draws that recording is spread over the job system.
+        scenes.push_back(std::make_unique<MeshesScene>("draws", 100));
+        scenes.push_back(std::make_unique<InstancesScene>(100));
+        return scenes;
+    }
+}
@@ -0,0 +1,45 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_BENCHSCENES_H
+#define REDPLASMA_BENCHSCENES_H
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace RedPlasma {
+    class Engine;
+}
+
+namespace RedPlasma::Bench {
+    // What a scene may do to the surface it is rendered into.
+    class BenchHost {
+    public:
+        virtual ~BenchHost() = default;
+        virtual void Resize(int width, int height) = 0;
+    };
+
+    // A scripted workload. Setup runs once after the engine attached its surface,
+    // Update runs before every frame (warmup frames included).
+    class BenchScene {
+    public:
+        virtual ~BenchScene() = default;
+
+        [[nodiscard]] virtual const char* GetName() const = 0;
+        virtual int Setup(Engine&, BenchHost&) { return 0; }
+        virtual void Update(Engine&, BenchHost&, uint32_t) {}
+    };
+
+    std::vector<std::unique_ptr<BenchScene>> CreateScenes();
+}
+#endif //REDPLASMA_BENCHSCENES_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_BENCHSTATISTICS_H
+#define REDPLASMA_BENCHSTATISTICS_H
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace RedPlasma::Bench {
+    struct Summary {
+        double mean = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+    };
+
+    // Nearest-rank percentile, samples must be sorted.
+    inline double Percentile(const std::vector<double>& sorted, double percentile) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    inline Summary Summarize(std::vector<double> samples) {
+        Summary summary;
+        if (samples.empty()) {
+            return summary;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+        summary.min = samples.front();
+        summary.max = samples.back();
+        summary.p50 = Percentile(samples, 50.0);
+        summary.p95 = Percentile(samples, 95.0);
+        summary.p99 = Percentile(samples, 99.0);
+        return summary;
+    }
+
+    inline std::string ToJson(const Summary& summary) {
+        std::ostringstream out;
+        out << "{\"mean\": " << summary.mean
+            << ", \"min\": " << summary.min
+            << ", \"max\": " << summary.max
+            << ", \"p50\": " << summary.p50
+            << ", \"p95\": " << summary.p95
+            << ", \"p99\": " << summary.p99 << "}";
+        return out.str();
+    }
+}
+#endif //REDPLASMA_BENCHSTATISTICS_H
\ No newline at end of file
@@ -0,0 +1,235 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BenchStatistics.h"
+#include "core/math/MathBatch.h"
+
+namespace {
+    using namespace RedPlasma;
+    using namespace RedPlasma::Bench;
+    using BenchClock = std::chrono::steady_clock;
+
+    struct MathBenchOptions {
+        uint32_t count = 16384;
+        uint32_t iterations = 200;
+        std::string outputPath;
+    };
+
+    // One kernel measured in both builds, times are nanoseconds per item.
+    struct KernelResult {
+        std::string name;
+        Summary scalarNs {};
+        Summary simdNs {};
+        // Largest absolute difference of the matrix kernels, differing visibility flags of the culling ones.
+        double mismatch = 0.0;
+    };
+
+    // Inputs shared by all kernels, a random scene of a few thousand units across around the camera.
+    struct MathBenchData {
+        Mat4 viewProjection;
+        Frustum frustum;
+        std::vector<Mat4> matrices;
+        std::vector<int32_t> parents;
+        std::vector<float> centerX, centerY, centerZ, radius, extentX, extentY, extentZ;
+    };
+
+    void PrintUsage() {
+        std::cout << "Usage: RedPlasmaMathBench [--count N] [--iterations N] [--out results.json]" << std::endl;
+    }
+
+    bool ParseOptions(int argc, char** argv, MathBenchOptions& options) {
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--count") == 0 && hasValue) {
+                options.count = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (std::strcmp(argv[i], "--iterations") == 0 && hasValue) {
+                options.iterations = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+                options.outputPath = argv[++i];
+            } else {
+                return false;
+            }
+        }
+        return options.count > 0 && options.iterations > 0;
+    }
+
+    MathBenchData CreateData(uint32_t count) {
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.5f, 10.0f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        MathBenchData data;
+        data.viewProjection = Mat4::Perspective(1.2f, 16.0f / 9.0f, 0.1f, 1000.0f)
+                            * Mat4::LookAt(Vec3{0.0f, 20.0f, 0.0f}, Vec3{100.0f, 0.0f, 100.0f}, Vec3{0.0f, 1.0f, 0.0f});
+        data.frustum = ExtractFrustum(data.viewProjection);
+        for (uint32_t i = 0; i < count; i++) {
+            Quat rotation = Quat::FromAxisAngle(Normalize(Vec3{unit(random), unit(random), unit(random)}), unit(random) * 3.14159f);
+            Vec3 translation {position(random), position(random) * 0.1f, position(random)};
+            float scale = size(random) * 0.2f;
+            data.matrices.push_back(Mat4::Compose(translation * 0.01f, rotation, Vec3{scale, scale, scale}));
+            // Shallow forests: a root every 16 nodes, otherwise any earlier node of the same tree.
+            data.parents.push_back(i % 16 == 0 ? -1 : static_cast<int32_t>(i - 1 - random() % (i % 16)));
+            data.centerX.push_back(translation.x);
+            data.centerY.push_back(translation.y);
+            data.centerZ.push_back(translation.z);
+            data.radius.push_back(size(random));
+            data.extentX.push_back(size(random));
+            data.extentY.push_back(size(random));
+            data.extentZ.push_back(size(random));
+        }
+        return data;
+    }
+
+    Summary Measure(uint32_t iterations, uint32_t count, const std::function<void()>& kernel) {
+        // One untimed pass to fault in the outputs and warm the caches.
+        kernel();
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        for (uint32_t i = 0; i < iterations; i++) {
+            auto start = BenchClock::now();
+            kernel();
+            std::chrono::duration<double, std::nano> elapsed = BenchClock::now() - start;
+            samples.push_back(elapsed.count() / count);
+        }
+        return Summarize(std::move(samples));
+    }
+
+    double CompareMatrices(const std::vector<Mat4>& a, const std::vector<Mat4>& b) {
+        double difference = 0.0;
+        for (size_t i = 0; i < a.size(); i++) {
+            for (int element = 0; element < 16; element++) {
+                difference = std::max(difference, static_cast<double>(std::fabs(a[i].m[element] - b[i].m[element])));
+            }
+        }
+        return difference;
+    }
+
+    double CompareFlags(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+        double differences = 0.0;
+        for (size_t i = 0; i < a.size(); i++) {
+            differences += a[i] != b[i] ? 1.0 : 0.0;
+        }
+        return differences;
+    }
+
+    std::vector<KernelResult> RunKernels(const MathBenchData& data, const MathBenchOptions& options) {
+        std::vector<KernelResult> results;
+        uint32_t count = options.count;
+        const Mat4& left = data.viewProjection;
+
+        {
+            KernelResult result {"multiply_aos"};
+            std::vector<Mat4> scalar(count);
+            std::vector<Mat4> simd(count);
+            result.scalarNs = Measure(options.iterations, count, [&]() { ScalarMath::MultiplyMatrices(left, data.matrices.data(), scalar.data(), count); });
+            result.simdNs = Measure(options.iterations, count, [&]() { MultiplyMatrices(left, data.matrices.data(), simd.data(), count); });
+            result.mismatch = CompareMatrices(scalar, simd);
+            results.push_back(result);
+        }
+        {
+            KernelResult result {"multiply_soa"};
+            size_t blockCount = GetMatrixBlockCount(count);
+            std::vector<Mat4Block> blocks(blockCount);
+            std::vector<Mat4Block> scalarBlocks(blockCount);
+            std::vector<Mat4Block> simdBlocks(blockCount);
+            PackMatrices(data.matrices.data(), count, blocks.data());
+            result.scalarNs = Measure(options.iterations, count, [&]() { ScalarMath::MultiplyMatrixBlocks(left, blocks.data(), scalarBlocks.data(), blockCount); });
+            result.simdNs = Measure(options.iterations, count, [&]() { MultiplyMatrixBlocks(left, blocks.data(), simdBlocks.data(), blockCount); });
+            std::vector<Mat4> scalar(count);
+            std::vector<Mat4> simd(count);
+            UnpackMatrices(scalarBlocks.data(), count, scalar.data());
+            UnpackMatrices(simdBlocks.data(), count, simd.data());
+            result.mismatch = CompareMatrices(scalar, simd);
+            results.push_back(result);
+        }
+        {
+            KernelResult result {"compose_hierarchy"};
+            std::vector<Mat4> scalar(count);
+            std::vector<Mat4> simd(count);
+            result.scalarNs = Measure(options.iterations, count, [&]() { ScalarMath::ComposeHierarchy(data.matrices.data(), data.parents.data(), count, scalar.data()); });
+            result.simdNs = Measure(options.iterations, count, [&]() { ComposeHierarchy(data.matrices.data(), data.parents.data(), count, simd.data()); });
+            result.mismatch = CompareMatrices(scalar, simd);
+            results.push_back(result);
+        }
+        {
+            KernelResult result {"cull_spheres"};
+            SphereSoa spheres {data.centerX.data(), data.centerY.data(), data.centerZ.data(), data.radius.data()};
+            std::vector<uint8_t> scalar(count);
+            std::vector<uint8_t> simd(count);
+            result.scalarNs = Measure(options.iterations, count, [&]() { ScalarMath::CullSpheres(data.frustum, spheres, count, scalar.data()); });
+            result.simdNs = Measure(options.iterations, count, [&]() { CullSpheres(data.frustum, spheres, count, simd.data()); });
+            result.mismatch = CompareFlags(scalar, simd);
+            results.push_back(result);
+        }
+        {
+            KernelResult result {"cull_aabbs"};
+            AabbSoa boxes {data.centerX.data(), data.centerY.data(), data.centerZ.data(), data.extentX.data(), data.extentY.data(), data.extentZ.data()};
+            std::vector<uint8_t> scalar(count);
+            std::vector<uint8_t> simd(count);
+            result.scalarNs = Measure(options.iterations, count, [&]() { ScalarMath::CullAabbs(data.frustum, boxes, count, scalar.data()); });
+            result.simdNs = Measure(options.iterations, count, [&]() { CullAabbs(data.frustum, boxes, count, simd.data()); });
+            result.mismatch = CompareFlags(scalar, simd);
+            results.push_back(result);
+        }
+        return results;
+    }
+
+    std::string ToJson(const MathBenchOptions& options, const std::vector<KernelResult>& results) {
+        std::ostringstream out;
+        out << "{\n  \"simd\": \"" << GetSimdLevel() << "\",\n  \"count\": " << options.count
+            << ",\n  \"iterations\": " << options.iterations << ",\n  \"kernels\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const KernelResult& result = results[i];
+            out << "    {\"name\": \"" << result.name << "\", \"scalarNs\": " << ToJson(result.scalarNs)
+                << ", \"simdNs\": " << ToJson(result.simdNs) << ", \"mismatch\": " << result.mismatch << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        return out.str();
+    }
+}
+
+// Scalar reference against the compiled SIMD level for every batch kernel in core/math.
+int main(int argc, char** argv) {
+    MathBenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::cout << "[MathBench] " << GetSimdLevel() << ", " << options.count << " items, " << options.iterations << " iterations" << std::endl;
+    MathBenchData data = CreateData(options.count);
+    std::vector<KernelResult> results = RunKernels(data, options);
+    for (const KernelResult& result : results) {
+        std::cout << "[MathBench] " << result.name << ": scalar p50 " << result.scalarNs.p50 << " ns, simd p50 " << result.simdNs.p50
+                  << " ns per item (" << result.scalarNs.p50 / result.simdNs.p50 << "x), mismatch " << result.mismatch << std::endl;
+    }
+
+    if (!options.outputPath.empty()) {
+        std::ofstream file(options.outputPath);
+        file << ToJson(options, results);
+        std::cout << "[MathBench] Results written to " << options.outputPath << std::endl;
+    }
+    return 0;
+}
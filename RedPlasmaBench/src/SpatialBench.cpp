@@ -0,0 +1,281 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "BenchStatistics.h"
+#include "core/jobs/JobSystem.h"
+#include "core/math/MathBatch.h"
+#include "core/spatial/Bvh.h"
+
+namespace {
+    using namespace RedPlasma;
+    using namespace RedPlasma::Bench;
+    using BenchClock = std::chrono::steady_clock;
+
+    struct SpatialBenchOptions {
+        std::vector<uint32_t> counts {100000, 1000000};
+        uint32_t iterations = 30;
+        // Share of the dynamic objects that move every simulated frame.
+        float movingFraction = 0.1f;
+        std::string outputPath;
+    };
+
+    // Every time is milliseconds per iteration, except the ray and box queries which are microseconds per query.
+    struct SpatialResult {
+        uint32_t count = 0;
+        Summary buildMs;
+        Summary insertMs;
+        Summary updateMs;
+        Summary frustumLinearMs;
+        Summary frustumBvhMs;
+        Summary frustumParallelMs;
+        Summary rayUs;
+        Summary boxUs;
+        uint32_t depth = 0;
+        size_t visible = 0;
+        // Objects the linear cull found visible that the tree query missed, has to stay 0.
+        size_t missed = 0;
+    };
+
+    // Objects scattered over a flat world whose area grows with the count, so the density and the number of
+    // objects within the camera's reach stay the same at every size.
+    struct SpatialScene {
+        std::vector<Aabb> bounds;
+        std::vector<uint32_t> ids;
+        std::vector<float> centerX, centerY, centerZ, extentX, extentY, extentZ;
+        Frustum frustum;
+        float halfSize = 0.0f;
+    };
+
+    void PrintUsage() {
+        std::cout << "Usage: RedPlasmaSpatialBench [--count N] [--iterations N] [--moving F] [--out results.json]" << std::endl;
+    }
+
+    bool ParseOptions(int argc, char** argv, SpatialBenchOptions& options) {
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--count") == 0 && hasValue) {
+                options.counts = {static_cast<uint32_t>(std::stoul(argv[++i]))};
+            } else if (std::strcmp(argv[i], "--iterations") == 0 && hasValue) {
+                options.iterations = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (std::strcmp(argv[i], "--moving") == 0 && hasValue) {
+                options.movingFraction = std::stof(argv[++i]);
+            } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+                options.outputPath = argv[++i];
+            } else {
+                return false;
+            }
+        }
+        return !options.counts.empty() && options.counts[0] > 0 && options.iterations > 0
+            && options.movingFraction >= 0.0f && options.movingFraction <= 1.0f;
+    }
+
+    SpatialScene CreateScene(uint32_t count) {
+        std::mt19937 random(1234);
+        SpatialScene scene;
+        scene.halfSize = 2.0f * std::sqrt(static_cast<float>(count));
+        std::uniform_real_distribution<float> position(-scene.halfSize, scene.halfSize);
+        std::uniform_real_distribution<float> height(0.0f, 30.0f);
+        std::uniform_real_distribution<float> size(0.25f, 2.0f);
+
+        Mat4 viewProjection = Mat4::Perspective(1.2f, 16.0f / 9.0f, 0.1f, 500.0f)
+                            * Mat4::LookAt(Vec3{0.0f, 20.0f, 0.0f}, Vec3{100.0f, 0.0f, 100.0f}, Vec3{0.0f, 1.0f, 0.0f});
+        scene.frustum = ExtractFrustum(viewProjection);
+        for (uint32_t i = 0; i < count; i++) {
+            Vec3 center {position(random), height(random), position(random)};
+            Vec3 extent {size(random), size(random), size(random)};
+            scene.bounds.push_back({center - extent, center + extent});
+            scene.ids.push_back(i);
+            scene.centerX.push_back(center.x);
+            scene.centerY.push_back(center.y);
+            scene.centerZ.push_back(center.z);
+            scene.extentX.push_back(extent.x);
+            scene.extentY.push_back(extent.y);
+            scene.extentZ.push_back(extent.z);
+        }
+        return scene;
+    }
+
+    // setup runs untimed before every iteration.
+    Summary Measure(uint32_t iterations, double scale, const std::function<void()>& setup, const std::function<void()>& body) {
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        for (uint32_t i = 0; i < iterations; i++) {
+            if (setup) {
+                setup();
+            }
+            auto start = BenchClock::now();
+            body();
+            std::chrono::duration<double, std::milli> elapsed = BenchClock::now() - start;
+            samples.push_back(elapsed.count() * scale);
+        }
+        return Summarize(std::move(samples));
+    }
+
+    SpatialResult RunCount(uint32_t count, const SpatialBenchOptions& options, JobSystem& jobSystem) {
+        SpatialScene scene = CreateScene(count);
+        SpatialResult result;
+        result.count = count;
+        // Rebuilds and inserts of a million objects take a while, a few samples are enough for them.
+        uint32_t buildIterations = std::max<uint32_t>(options.iterations / 10, 3);
+
+        Bvh tree;
+        result.buildMs = Measure(buildIterations, 1.0, nullptr, [&]() { tree.Build(scene.bounds.data(), scene.ids.data(), count); });
+        result.depth = tree.GetDepth();
+
+        SpatialIndex index;
+        result.insertMs = Measure(buildIterations, 1.0, [&]() { index = SpatialIndex(); }, [&]() {
+            for (uint32_t i = 0; i < count; i++) {
+                index.Add(scene.bounds[i], i, false);
+            }
+        });
+        std::vector<uint32_t> handles(count);
+        index = SpatialIndex();
+        for (uint32_t i = 0; i < count; i++) {
+            handles[i] = index.Add(scene.bounds[i], i, false);
+        }
+        index.Commit();
+
+        // Objects drift by up to a few tenths of a unit per frame, a different subset every frame.
+        std::mt19937 random(99);
+        std::uniform_real_distribution<float> step(-0.3f, 0.3f);
+        auto moving = static_cast<uint32_t>(static_cast<float>(count) * options.movingFraction);
+        std::vector<Aabb>& bounds = scene.bounds;
+        result.updateMs = Measure(options.iterations, 1.0, nullptr, [&]() {
+            uint32_t first = random() % count;
+            for (uint32_t i = 0; i < moving; i++) {
+                uint32_t object = (first + i * 7919u) % count;
+                Vec3 offset {step(random), step(random) * 0.1f, step(random)};
+                bounds[object] = {bounds[object].min + offset, bounds[object].max + offset};
+                index.Update(handles[object], bounds[object]);
+            }
+            index.Commit();
+        });
+
+        // The linear cull tests the scene's original boxes, the tree holds the static build of the same boxes.
+        AabbSoa boxes {scene.centerX.data(), scene.centerY.data(), scene.centerZ.data(), scene.extentX.data(), scene.extentY.data(), scene.extentZ.data()};
+        std::vector<uint8_t> flags(count);
+        std::vector<uint32_t> linearVisible;
+        result.frustumLinearMs = Measure(options.iterations, 1.0, nullptr, [&]() {
+            CullAabbs(scene.frustum, boxes, count, flags.data());
+            linearVisible.clear();
+            for (uint32_t i = 0; i < count; i++) {
+                if (flags[i]) {
+                    linearVisible.push_back(i);
+                }
+            }
+        });
+        std::vector<uint32_t> visible;
+        result.frustumBvhMs = Measure(options.iterations, 1.0, [&]() { visible.clear(); }, [&]() { tree.QueryFrustum(scene.frustum, visible); });
+        result.frustumParallelMs = Measure(options.iterations, 1.0, [&]() { visible.clear(); }, [&]() {
+            tree.QueryFrustumParallel(scene.frustum, jobSystem, visible);
+        });
+        result.visible = visible.size();
+        std::unordered_set<uint32_t> found(visible.begin(), visible.end());
+        for (uint32_t id : linearVisible) {
+            result.missed += found.count(id) == 0 ? 1 : 0;
+        }
+
+        constexpr uint32_t QueriesPerIteration = 1000;
+        std::uniform_real_distribution<float> position(-scene.halfSize, scene.halfSize);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<Ray> rays;
+        std::vector<Aabb> regions;
+        for (uint32_t i = 0; i < QueriesPerIteration; i++) {
+            Vec3 origin {position(random), 10.0f, position(random)};
+            rays.push_back({origin, Normalize(Vec3{unit(random), unit(random) * 0.1f, unit(random)}), 200.0f});
+            regions.push_back({origin - Vec3{10.0f, 10.0f, 10.0f}, origin + Vec3{10.0f, 10.0f, 10.0f}});
+        }
+        std::vector<RayHit> hits;
+        std::vector<uint32_t> overlaps;
+        double perQueryUs = 1000.0 / QueriesPerIteration;
+        result.rayUs = Measure(options.iterations, perQueryUs, nullptr, [&]() {
+            for (const Ray& ray : rays) {
+                hits.clear();
+                tree.QueryRay(ray, hits);
+            }
+        });
+        result.boxUs = Measure(options.iterations, perQueryUs, nullptr, [&]() {
+            for (const Aabb& region : regions) {
+                overlaps.clear();
+                tree.QueryAabb(region, overlaps);
+            }
+        });
+        return result;
+    }
+
+    std::string ToJson(const SpatialBenchOptions& options, const std::vector<SpatialResult>& results) {
+        std::ostringstream out;
+        out << "{\n  \"iterations\": " << options.iterations << ",\n  \"movingFraction\": " << options.movingFraction
+            << ",\n  \"scenes\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const SpatialResult& result = results[i];
+            out << "    {\"count\": " << result.count << ", \"depth\": " << result.depth << ", \"visible\": " << result.visible
+                << ", \"missed\": " << result.missed
+                << ",\n     \"buildMs\": " << ToJson(result.buildMs)
+                << ",\n     \"insertMs\": " << ToJson(result.insertMs)
+                << ",\n     \"updateMs\": " << ToJson(result.updateMs)
+                << ",\n     \"frustumLinearMs\": " << ToJson(result.frustumLinearMs)
+                << ",\n     \"frustumBvhMs\": " << ToJson(result.frustumBvhMs)
+                << ",\n     \"frustumParallelMs\": " << ToJson(result.frustumParallelMs)
+                << ",\n     \"rayUs\": " << ToJson(result.rayUs)
+                << ",\n     \"boxUs\": " << ToJson(result.boxUs) << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        return out.str();
+    }
+}
+
+// Update and query cost of the scene BVH, with the linear frustum cull over every object as the baseline.
+int main(int argc, char** argv) {
+    SpatialBenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    std::vector<SpatialResult> results;
+    for (uint32_t count : options.counts) {
+        std::cout << "[SpatialBench] " << count << " objects, " << options.iterations << " iterations" << std::endl;
+        SpatialResult result = RunCount(count, options, jobSystem);
+        std::cout << "[SpatialBench] build p50 " << result.buildMs.p50 << " ms, insert p50 " << result.insertMs.p50
+                  << " ms, depth " << result.depth << std::endl;
+        std::cout << "[SpatialBench] update " << options.movingFraction * 100.0f << "% p50 " << result.updateMs.p50 << " ms" << std::endl;
+        std::cout << "[SpatialBench] frustum p50: linear " << result.frustumLinearMs.p50 << " ms, bvh " << result.frustumBvhMs.p50
+                  << " ms, bvh parallel " << result.frustumParallelMs.p50 << " ms, " << result.visible << " visible, "
+                  << result.missed << " missed" << std::endl;
+        std::cout << "[SpatialBench] ray p50 " << result.rayUs.p50 << " us, box p50 " << result.boxUs.p50 << " us per query" << std::endl;
+        results.push_back(result);
+    }
+    jobSystem.Shutdown();
+
+    if (!options.outputPath.empty()) {
+        std::ofstream file(options.outputPath);
+        file << ToJson(options, results);
+        std::cout << "[SpatialBench] Results written to " << options.outputPath << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,359 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <GLFW/glfw3.h>
+#define GLFW_EXPOSE_NATIVE_WAYLAND
+#include <GLFW/glfw3native.h>
+#include "BenchScenes.h"
+#include "BenchStatistics.h"
+#include "core/Engine.h"
+#include "core/renderer/IGraphicsDevice.h"
+#include "plugins/renderer/vulkan/platform/headless/HeadlessSurface.h"
+#include "plugins/renderer/vulkan/platform/linux/wayland/WaylandSurface.h"
+
+namespace {
+    using namespace RedPlasma;
+    using namespace RedPlasma::Bench;
+    using BenchClock = std::chrono::steady_clock;
+
+    struct BenchOptions {
+        std::string scene = "all";
+        uint32_t frames = 500;
+        uint32_t warmupFrames = 50;
+        int width = 1280;
+        int height = 720;
+        uint32_t framesInFlight = 2;
+        PresentMode presentMode = PresentMode::Immediate;
+        std::string outputPath;
+        bool window = false;
+    };
+
+    struct SceneResult {
+        std::string name;
+        uint32_t frames = 0;
+        Summary frameMs;
+        Summary waitMs;
+        Summary recordMs;
+        Summary submitMs;
+        // Per profiled GPU zone, keyed by zone name.
+        std::map<std::string, Summary> gpuMs;
+        // Mean draw recording time per job system thread.
+        std::vector<double> recordThreadMs;
+        // Sampled after the last frame, before shutdown.
+        GpuMemoryStats memory;
+    };
+
+    class HeadlessHost : public BenchHost {
+    public:
+        HeadlessHost(Engine& engine, HeadlessSurface& surface) : m_Engine(engine), m_Surface(surface) {}
+
+        void Resize(int width, int height) override {
+            m_Surface.UpdateSize(width, height);
+            m_Engine.OnWindowResized();
+        }
+
+    private:
+        Engine& m_Engine;
+        HeadlessSurface& m_Surface;
+    };
+
+    class WindowHost : public BenchHost {
+    public:
+        WindowHost(Engine& engine, WaylandSurface& surface, GLFWwindow* window) : m_Engine(engine), m_Surface(surface), m_Window(window) {}
+
+        void Resize(int width, int height) override {
+            glfwSetWindowSize(m_Window, width, height);
+            m_Surface.UpdateSize(width, height);
+            m_Engine.OnWindowResized();
+        }
+
+    private:
+        Engine& m_Engine;
+        WaylandSurface& m_Surface;
+        GLFWwindow* m_Window;
+    };
+
+    PresentMode ParsePresentMode(const char* name) {
+        if (std::strcmp(name, "fifo") == 0) {
+            return PresentMode::Fifo;
+        }
+        if (std::strcmp(name, "mailbox") == 0) {
+            return PresentMode::Mailbox;
+        }
+        if (std::strcmp(name, "fifo-relaxed") == 0) {
+            return PresentMode::FifoRelaxed;
+        }
+        return PresentMode::Immediate;
+    }
+
+    const char* PresentModeName(PresentMode mode) {
+        switch (mode) {
+            case PresentMode::Fifo: return "fifo";
+            case PresentMode::Mailbox: return "mailbox";
+            case PresentMode::FifoRelaxed: return "fifo-relaxed";
+            case PresentMode::Immediate: break;
+        }
+        return "immediate";
+    }
+
+    void PrintUsage() {
+        std::cout << "Usage: RedPlasmaBench [--scene <name|all>] [--frames N] [--warmup N]\n"
+                     "                      [--size WxH] [--frames-in-flight N]\n"
+                     "                      [--present fifo|mailbox|immediate|fifo-relaxed]\n"
+                     "                      [--window] [--out results.json]\n"
+                     "Scenes:";
+        for (const auto& scene : CreateScenes()) {
+            std::cout << " " << scene->GetName();
+        }
+        std::cout << std::endl;
+    }
+
+    bool ParseOptions(int argc, char** argv, BenchOptions& options) {
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--scene") == 0 && hasValue) {
+                options.scene = argv[++i];
+            } else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+                options.frames = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) {
+                options.warmupFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (std::strcmp(argv[i], "--size") == 0 && hasValue) {
+                if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2) {
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--frames-in-flight") == 0 && hasValue) {
+                options.framesInFlight = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (std::strcmp(argv[i], "--present") == 0 && hasValue) {
+                options.presentMode = ParsePresentMode(argv[++i]);
+            } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--window") == 0) {
+                options.window = true;
+            } else {
+                return false;
+            }
+        }
+        return options.frames > 0;
+    }
+
+    // Runs one scene in a fresh engine so scenes cannot influence each other.
+    int RunScene(BenchScene& scene, const BenchOptions& options, GLFWwindow* window, SceneResult& result, std::string& deviceName) {
+        Engine engine;
+
+        GraphicsDeviceSettings settings;
+        settings.framesInFlight = options.framesInFlight;
+        settings.presentMode = options.presentMode;
+        engine.Configure(settings);
+
+        std::unique_ptr<IWindowSurface> surface;
+        std::unique_ptr<BenchHost> host;
+        if (window) {
+            auto waylandSurface = std::make_unique<WaylandSurface>(glfwGetWaylandDisplay(), glfwGetWaylandWindow(window), options.width, options.height);
+            host = std::make_unique<WindowHost>(engine, *waylandSurface, window);
+            surface = std::move(waylandSurface);
+        } else {
+            auto headlessSurface = std::make_unique<HeadlessSurface>(options.width, options.height);
+            host = std::make_unique<HeadlessHost>(engine, *headlessSurface);
+            surface = std::move(headlessSurface);
+        }
+
+        if (engine.AttachWindow(surface.get()) != 0) {
+            std::cout << "[Bench] Failed to attach the surface" << std::endl;
+            return -1;
+        }
+        deviceName = engine.GetDeviceName();
+
+        if (scene.Setup(engine, *host) != 0) {
+            std::cout << "[Bench] Scene " << scene.GetName() << " failed to set up" << std::endl;
+            engine.Shutdown();
+            return -2;
+        }
+
+        std::vector<double> frameMs, waitMs, recordMs, submitMs;
+        std::map<std::string, std::vector<double>> gpuMs;
+        frameMs.reserve(options.frames);
+        waitMs.reserve(options.frames);
+        recordMs.reserve(options.frames);
+        submitMs.reserve(options.frames);
+
+        uint32_t totalFrames = options.warmupFrames + options.frames;
+        BenchClock::time_point previous = BenchClock::now();
+        for (uint32_t frame = 0; frame < totalFrames; frame++) {
+            if (window) {
+                glfwPollEvents();
+            }
+            scene.Update(engine, *host, frame);
+            engine.Run();
+
+            BenchClock::time_point now = BenchClock::now();
+            if (frame >= options.warmupFrames) {
+                const FrameStats& stats = engine.GetFrameStats();
+                frameMs.push_back(std::chrono::duration<double, std::milli>(now - previous).count());
+                waitMs.push_back(stats.waitMs);
+                recordMs.push_back(stats.recordMs);
+                submitMs.push_back(stats.submitMs);
+                if (result.recordThreadMs.size() < stats.recordThreadMs.size()) {
+                    result.recordThreadMs.resize(stats.recordThreadMs.size(), 0.0);
+                }
+                for (size_t thread = 0; thread < stats.recordThreadMs.size(); thread++) {
+                    result.recordThreadMs[thread] += stats.recordThreadMs[thread] / options.frames;
+                }
+
+                // Resolved a few frames late; the first measured frames still report warmup work, which is fine.
+                for (const GpuZoneTiming& zone : engine.GetGpuTimings()) {
+                    gpuMs[zone.name].push_back(zone.milliseconds);
+                }
+            }
+            previous = now;
+        }
+
+        result.memory = engine.GetMemoryStats();
+        engine.Shutdown();
+
+        result.name = scene.GetName();
+        result.frames = options.frames;
+        result.frameMs = Summarize(std::move(frameMs));
+        result.waitMs = Summarize(std::move(waitMs));
+        result.recordMs = Summarize(std::move(recordMs));
+        result.submitMs = Summarize(std::move(submitMs));
+        for (auto& [zoneName, samples] : gpuMs) {
+            result.gpuMs[zoneName] = Summarize(std::move(samples));
+        }
+        return 0;
+    }
+
+    std::string EscapeJson(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    std::string ToJson(const BenchOptions& options, const std::string& deviceName, const std::vector<SceneResult>& results) {
+        std::ostringstream out;
+        out << "{\n"
+            << "  \"device\": \"" << EscapeJson(deviceName) << "\",\n"
+            << "  \"surface\": \"" << (options.window ? "wayland" : "headless") << "\",\n"
+            << "  \"width\": " << options.width << ",\n"
+            << "  \"height\": " << options.height << ",\n"
+            << "  \"present_mode\": \"" << PresentModeName(options.presentMode) << "\",\n"
+            << "  \"frames_in_flight\": " << options.framesInFlight << ",\n"
+            << "  \"warmup_frames\": " << options.warmupFrames << ",\n"
+            << "  \"scenes\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const SceneResult& result = results[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\n"
+                << "      \"name\": \"" << EscapeJson(result.name) << "\",\n"
+                << "      \"frames\": " << result.frames << ",\n"
+                << "      \"frame_ms\": " << ToJson(result.frameMs) << ",\n"
+                << "      \"cpu_wait_ms\": " << ToJson(result.waitMs) << ",\n"
+                << "      \"cpu_record_ms\": " << ToJson(result.recordMs) << ",\n"
+                << "      \"cpu_submit_ms\": " << ToJson(result.submitMs) << ",\n"
+                << "      \"cpu_record_thread_ms\": [";
+            for (size_t thread = 0; thread < result.recordThreadMs.size(); thread++) {
+                out << (thread == 0 ? "" : ", ") << result.recordThreadMs[thread];
+            }
+            out << "],\n"
+                << "      \"gpu_ms\": {";
+            bool firstZone = true;
+            for (const auto& [zoneName, summary] : result.gpuMs) {
+                out << (firstZone ? "\n" : ",\n") << "        \"" << EscapeJson(zoneName) << "\": " << ToJson(summary);
+                firstZone = false;
+            }
+            out << (firstZone ? "}" : "\n      }") << ",\n"
+                << "      \"gpu_memory\": {"
+                << "\"blocks\": " << result.memory.blockCount
+                << ", \"dedicated\": " << result.memory.dedicatedCount
+                << ", \"allocations\": " << result.memory.allocationCount
+                << ", \"reserved_bytes\": " << result.memory.reservedBytes
+                << ", \"used_bytes\": " << result.memory.usedBytes
+                << ", \"largest_free_bytes\": " << result.memory.largestFreeBytes
+                << ", \"fragmentation\": " << result.memory.fragmentation << "}\n"
+                << "    }";
+        }
+        out << "\n  ]\n}\n";
+        return out.str();
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    GLFWwindow* window = nullptr;
+    if (options.window) {
+        glfwInit();
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        window = glfwCreateWindow(options.width, options.height, "Red Plasma Bench", nullptr, nullptr);
+    }
+
+    std::vector<SceneResult> results;
+    std::string deviceName;
+    int exitCode = 0;
+    for (const auto& scene : CreateScenes()) {
+        if (options.scene != "all" && options.scene != scene->GetName()) {
+            continue;
+        }
+
+        std::cout << "[Bench] Running " << scene->GetName() << " (" << options.frames << " frames)" << std::endl;
+        SceneResult result;
+        if (RunScene(*scene, options, window, result, deviceName) != 0) {
+            exitCode = 1;
+            continue;
+        }
+
+        std::cout << "[Bench] " << result.name
+                  << ": frame p50 " << result.frameMs.p50 << " ms, p95 " << result.frameMs.p95 << " ms, p99 " << result.frameMs.p99
+                  << " ms | record p50 " << result.recordMs.p50 << " ms | submit p50 " << result.submitMs.p50 << " ms";
+        auto gpuFrame = result.gpuMs.find("Frame");
+        if (gpuFrame != result.gpuMs.end()) {
+            std::cout << " | gpu p50 " << gpuFrame->second.p50 << " ms";
+        }
+        std::cout << std::endl;
+        results.push_back(std::move(result));
+    }
+
+    if (results.empty()) {
+        std::cout << "[Bench] No scene was run" << std::endl;
+        exitCode = 1;
+    }
+
+    if (!options.outputPath.empty()) {
+        std::ofstream file(options.outputPath);
+        file << ToJson(options, deviceName, results);
+        std::cout << "[Bench] Results written to " << options.outputPath << std::endl;
+    }
+
+    if (window) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+    return exitCode;
+}
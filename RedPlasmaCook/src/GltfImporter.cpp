@@ -0,0 +1,472 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "MeshImporters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Json.h"
+
+namespace RedPlasma::Cook {
+    namespace {
+        constexpr uint32_t GlbMagic = 0x46546C67;      // "glTF"
+        constexpr uint32_t GlbChunkJson = 0x4E4F534A;  // "JSON"
+        constexpr uint32_t GlbChunkBin = 0x004E4942;   // "BIN\0"
+        constexpr uint32_t ComponentUnsignedByte = 5121;
+        constexpr uint32_t ComponentUnsignedShort = 5123;
+        constexpr uint32_t ComponentUnsignedInt = 5125;
+        constexpr uint32_t ComponentFloat = 5126;
+        constexpr uint32_t ModeTriangles = 4;
+        // Deeper hierarchies than this are treated as cycles.
+        constexpr uint32_t MaxNodeDepth = 64;
+
+        // Indices, counts and offsets. Optional ones fall back when missing, anything else that isn't a
+        // non-negative number becomes SIZE_MAX and fails the range checks.
+        size_t ToSize(const JsonValue& value, size_t fallback = SIZE_MAX) {
+            if (value.IsNull()) {
+                return fallback;
+            }
+            double number = value.AsNumber(-1.0);
+            return number >= 0.0 && number < 9007199254740992.0 ? static_cast<size_t>(number) : SIZE_MAX;
+        }
+
+        struct Matrix {
+            // Column major like glTF.
+            float m[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        };
+
+        Matrix Multiply(const Matrix& a, const Matrix& b) {
+            Matrix result;
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) {
+                    float sum = 0.0f;
+                    for (int k = 0; k < 4; k++) {
+                        sum += a.m[k * 4 + row] * b.m[column * 4 + k];
+                    }
+                    result.m[column * 4 + row] = sum;
+                }
+            }
+            return result;
+        }
+
+        float Determinant3(const Matrix& a) {
+            return a.m[0] * (a.m[5] * a.m[10] - a.m[9] * a.m[6])
+                 - a.m[4] * (a.m[1] * a.m[10] - a.m[9] * a.m[2])
+                 + a.m[8] * (a.m[1] * a.m[6] - a.m[5] * a.m[2]);
+        }
+
+        // Transforms normals like the upper 3x3 of the matrix transforms positions, the cofactor matrix is the
+        // inverse transpose scaled by the determinant. Column major.
+        void GetNormalMatrix(const Matrix& a, float out[9]) {
+            const float* m = a.m;
+            out[0] = m[5] * m[10] - m[6] * m[9];
+            out[1] = m[6] * m[8] - m[4] * m[10];
+            out[2] = m[4] * m[9] - m[5] * m[8];
+            out[3] = m[2] * m[9] - m[1] * m[10];
+            out[4] = m[0] * m[10] - m[2] * m[8];
+            out[5] = m[1] * m[8] - m[0] * m[9];
+            out[6] = m[1] * m[6] - m[2] * m[5];
+            out[7] = m[2] * m[4] - m[0] * m[6];
+            out[8] = m[0] * m[5] - m[1] * m[4];
+        }
+
+        Matrix GetLocalTransform(const JsonValue& node) {
+            Matrix local;
+            const JsonValue& matrix = node["matrix"];
+            if (matrix.Size() == 16) {
+                for (size_t i = 0; i < 16; i++) {
+                    local.m[i] = static_cast<float>(matrix[i].AsNumber());
+                }
+                return local;
+            }
+
+            const JsonValue& t = node["translation"];
+            const JsonValue& r = node["rotation"];
+            const JsonValue& s = node["scale"];
+            float x = static_cast<float>(r[0].AsNumber(0.0));
+            float y = static_cast<float>(r[1].AsNumber(0.0));
+            float z = static_cast<float>(r[2].AsNumber(0.0));
+            float w = static_cast<float>(r[3].AsNumber(1.0));
+            float scale[3] = {
+                static_cast<float>(s[0].AsNumber(1.0)),
+                static_cast<float>(s[1].AsNumber(1.0)),
+                static_cast<float>(s[2].AsNumber(1.0))
+            };
+            // T * R * S
+            float rotation[9] = {
+                1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w),
+                2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w),
+                2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y)
+            };
+            for (int column = 0; column < 3; column++) {
+                for (int row = 0; row < 3; row++) {
+                    local.m[column * 4 + row] = rotation[column * 3 + row] * scale[column];
+                }
+            }
+            local.m[12] = static_cast<float>(t[0].AsNumber(0.0));
+            local.m[13] = static_cast<float>(t[1].AsNumber(0.0));
+            local.m[14] = static_cast<float>(t[2].AsNumber(0.0));
+            return local;
+        }
+
+        bool ReadFile(const std::filesystem::path& path, std::string& out) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                return false;
+            }
+            std::stringstream contents;
+            contents << file.rdbuf();
+            out = contents.str();
+            return true;
+        }
+
+        bool DecodeBase64(std::string_view text, std::string& out) {
+            out.clear();
+            out.reserve(text.size() / 4 * 3);
+            uint32_t bits = 0;
+            int bitCount = 0;
+            for (char c : text) {
+                int value;
+                if (c >= 'A' && c <= 'Z') {
+                    value = c - 'A';
+                } else if (c >= 'a' && c <= 'z') {
+                    value = c - 'a' + 26;
+                } else if (c >= '0' && c <= '9') {
+                    value = c - '0' + 52;
+                } else if (c == '+') {
+                    value = 62;
+                } else if (c == '/') {
+                    value = 63;
+                } else if (c == '=') {
+                    break;
+                } else {
+                    return false;
+                }
+                bits = (bits << 6) | static_cast<uint32_t>(value);
+                bitCount += 6;
+                if (bitCount >= 8) {
+                    bitCount -= 8;
+                    out += static_cast<char>((bits >> bitCount) & 0xFF);
+                }
+            }
+            return true;
+        }
+
+        class GltfDocument {
+        public:
+            int Load(const std::string& path) {
+                std::string file;
+                if (!ReadFile(path, file)) {
+                    std::cout << "[Cook] Failed to open " << path << std::endl;
+                    return -1;
+                }
+
+                std::string_view json = file;
+                std::string glbBinary;
+                uint32_t magic = 0;
+                if (file.size() >= 4) {
+                    std::memcpy(&magic, file.data(), 4);
+                }
+                if (magic == GlbMagic) {
+                    if (SplitGlb(file, json, glbBinary) != 0) {
+                        std::cout << "[Cook] " << path << " is not a valid glb container" << std::endl;
+                        return -2;
+                    }
+                }
+
+                size_t errorOffset;
+                if (JsonValue::Parse(json, m_Root, errorOffset) != 0) {
+                    std::cout << "[Cook] " << path << ": invalid JSON near byte " << errorOffset << std::endl;
+                    return -2;
+                }
+                if (m_Root["asset"]["version"].AsString().rfind("2.", 0) != 0) {
+                    std::cout << "[Cook] " << path << " is not glTF 2.x" << std::endl;
+                    return -2;
+                }
+                return LoadBuffers(std::filesystem::path(path).parent_path(), glbBinary);
+            }
+
+            int Flatten(ImportedMesh& out) const {
+                const JsonValue& scenes = m_Root["scenes"];
+                if (scenes.Size() == 0) {
+                    // No scene means no hierarchy, every mesh is taken as is.
+                    for (size_t mesh = 0; mesh < m_Root["meshes"].Size(); mesh++) {
+                        if (AppendMesh(m_Root["meshes"][mesh], Matrix(), out) != 0) {
+                            return -2;
+                        }
+                    }
+                    return 0;
+                }
+                const JsonValue& scene = scenes[ToSize(m_Root["scene"], 0)];
+                for (size_t i = 0; i < scene["nodes"].Size(); i++) {
+                    if (AppendNode(ToSize(scene["nodes"][i]), Matrix(), 0, out) != 0) {
+                        return -2;
+                    }
+                }
+                return 0;
+            }
+
+        private:
+            static int SplitGlb(const std::string& file, std::string_view& json, std::string& binary) {
+                // Header: magic, version, length. Chunks: length, type, data padded to 4 bytes.
+                uint32_t header[3];
+                if (file.size() < sizeof(header)) {
+                    return -1;
+                }
+                std::memcpy(header, file.data(), sizeof(header));
+                if (header[1] != 2 || header[2] > file.size()) {
+                    return -1;
+                }
+                size_t offset = sizeof(header);
+                bool hasJson = false;
+                while (offset + 8 <= header[2]) {
+                    uint32_t chunk[2];
+                    std::memcpy(chunk, file.data() + offset, sizeof(chunk));
+                    offset += sizeof(chunk);
+                    if (chunk[0] > header[2] - offset) {
+                        return -1;
+                    }
+                    if (chunk[1] == GlbChunkJson && !hasJson) {
+                        json = std::string_view(file).substr(offset, chunk[0]);
+                        hasJson = true;
+                    } else if (chunk[1] == GlbChunkBin && binary.empty()) {
+                        binary.assign(file.data() + offset, chunk[0]);
+                    }
+                    offset += chunk[0];
+                }
+                return hasJson ? 0 : -1;
+            }
+
+            int LoadBuffers(const std::filesystem::path& directory, std::string& glbBinary) {
+                const JsonValue& buffers = m_Root["buffers"];
+                m_Buffers.resize(buffers.Size());
+                for (size_t i = 0; i < buffers.Size(); i++) {
+                    const std::string& uri = buffers[i]["uri"].AsString();
+                    if (uri.empty()) {
+                        // Only the first buffer may live in the glb's binary chunk.
+                        if (i != 0 || glbBinary.empty()) {
+                            std::cout << "[Cook] Buffer " << i << " has no data" << std::endl;
+                            return -2;
+                        }
+                        m_Buffers[i] = std::move(glbBinary);
+                    } else if (uri.rfind("data:", 0) == 0) {
+                        size_t payload = uri.find(";base64,");
+                        if (payload == std::string::npos || !DecodeBase64(std::string_view(uri).substr(payload + 8), m_Buffers[i])) {
+                            std::cout << "[Cook] Buffer " << i << " has an unsupported data uri" << std::endl;
+                            return -2;
+                        }
+                    } else if (!ReadFile(directory / uri, m_Buffers[i])) {
+                        std::cout << "[Cook] Failed to open buffer " << (directory / uri).string() << std::endl;
+                        return -1;
+                    }
+                    if (m_Buffers[i].size() < ToSize(buffers[i]["byteLength"], 0)) {
+                        std::cout << "[Cook] Buffer " << i << " is shorter than declared" << std::endl;
+                        return -2;
+                    }
+                }
+                return 0;
+            }
+
+            // Resolves an accessor to its first element and stride, checked against the buffer it reads from.
+            bool GetAccessorData(size_t index, uint32_t componentType, uint32_t componentCount, const uint8_t*& data, size_t& stride, size_t& count) const {
+                const JsonValue& accessor = m_Root["accessors"][index];
+                if (!accessor.IsObject() || !accessor["sparse"].IsNull()) {
+                    return false;
+                }
+                if (static_cast<uint32_t>(accessor["componentType"].AsNumber(0.0)) != componentType) {
+                    return false;
+                }
+                const std::string& type = accessor["type"].AsString();
+                if ((componentCount == 1 && type != "SCALAR") || (componentCount == 3 && type != "VEC3")) {
+                    return false;
+                }
+
+                const JsonValue& view = m_Root["bufferViews"][ToSize(accessor["bufferView"])];
+                size_t buffer = ToSize(view["buffer"]);
+                if (!view.IsObject() || buffer >= m_Buffers.size()) {
+                    return false;
+                }
+                size_t componentSize = componentType == ComponentUnsignedByte ? 1 : componentType == ComponentUnsignedShort ? 2 : 4;
+                size_t elementSize = componentSize * componentCount;
+                stride = ToSize(view["byteStride"], 0);
+                if (stride == 0) {
+                    stride = elementSize;
+                } else if (stride == SIZE_MAX) {
+                    return false;
+                }
+                count = ToSize(accessor["count"]);
+                size_t viewOffset = ToSize(view["byteOffset"], 0);
+                size_t viewLength = ToSize(view["byteLength"]);
+                size_t accessorOffset = ToSize(accessor["byteOffset"], 0);
+                size_t bufferSize = m_Buffers[buffer].size();
+                if (count == 0 || count == SIZE_MAX || viewOffset > bufferSize || viewLength > bufferSize - viewOffset
+                    || accessorOffset > viewLength || elementSize > viewLength - accessorOffset
+                    || count - 1 > (viewLength - accessorOffset - elementSize) / stride) {
+                    return false;
+                }
+                data = reinterpret_cast<const uint8_t*>(m_Buffers[buffer].data()) + viewOffset + accessorOffset;
+                return true;
+            }
+
+            int AppendNode(size_t index, const Matrix& parent, uint32_t depth, ImportedMesh& out) const {
+                const JsonValue& node = m_Root["nodes"][index];
+                if (!node.IsObject() || depth > MaxNodeDepth) {
+                    std::cout << "[Cook] Node " << index << " is missing or part of a cycle" << std::endl;
+                    return -2;
+                }
+                Matrix world = Multiply(parent, GetLocalTransform(node));
+                if (node["mesh"].IsNumber() && AppendMesh(m_Root["meshes"][ToSize(node["mesh"])], world, out) != 0) {
+                    return -2;
+                }
+                for (size_t i = 0; i < node["children"].Size(); i++) {
+                    if (AppendNode(ToSize(node["children"][i]), world, depth + 1, out) != 0) {
+                        return -2;
+                    }
+                }
+                return 0;
+            }
+
+            int AppendMesh(const JsonValue& mesh, const Matrix& world, ImportedMesh& out) const {
+                // Mirroring transforms turn the triangles inside out, swapping two corners keeps the winding.
+                bool flip = Determinant3(world) < 0.0f;
+                float normalMatrix[9];
+                GetNormalMatrix(world, normalMatrix);
+                for (size_t p = 0; p < mesh["primitives"].Size(); p++) {
+                    const JsonValue& primitive = mesh["primitives"][p];
+                    if (static_cast<uint32_t>(primitive["mode"].AsNumber(ModeTriangles)) != ModeTriangles) {
+                        std::cout << "[Cook] Skipping a primitive that is not a triangle list" << std::endl;
+                        continue;
+                    }
+
+                    const uint8_t* positions;
+                    size_t positionStride;
+                    size_t positionCount;
+                    if (!primitive["attributes"]["POSITION"].IsNumber()
+                        || !GetAccessorData(ToSize(primitive["attributes"]["POSITION"]), ComponentFloat, 3, positions, positionStride, positionCount)) {
+                        std::cout << "[Cook] Primitive without usable float positions" << std::endl;
+                        return -2;
+                    }
+
+                    auto baseVertex = static_cast<uint32_t>(out.vertices.size());
+                    for (size_t i = 0; i < positionCount; i++) {
+                        float source[3];
+                        std::memcpy(source, positions + i * positionStride, sizeof(source));
+                        Vertex vertex {};
+                        vertex.x = world.m[0] * source[0] + world.m[4] * source[1] + world.m[8] * source[2] + world.m[12];
+                        vertex.y = world.m[1] * source[0] + world.m[5] * source[1] + world.m[9] * source[2] + world.m[13];
+                        vertex.z = world.m[2] * source[0] + world.m[6] * source[1] + world.m[10] * source[2] + world.m[14];
+                        out.vertices.push_back(vertex);
+                    }
+
+                    // Primitives without normals get zero length ones, the cooker generates those.
+                    const uint8_t* normals = nullptr;
+                    size_t normalStride = 0;
+                    size_t normalCount = 0;
+                    if (primitive["attributes"]["NORMAL"].IsNumber()
+                        && (!GetAccessorData(ToSize(primitive["attributes"]["NORMAL"]), ComponentFloat, 3, normals, normalStride, normalCount)
+                            || normalCount != positionCount)) {
+                        std::cout << "[Cook] Primitive with unusable normals" << std::endl;
+                        return -2;
+                    }
+                    for (size_t i = 0; i < positionCount; i++) {
+                        float source[3] = {};
+                        if (normals) {
+                            std::memcpy(source, normals + i * normalStride, sizeof(source));
+                        }
+                        float normal[3];
+                        for (int row = 0; row < 3; row++) {
+                            normal[row] = normalMatrix[row] * source[0] + normalMatrix[3 + row] * source[1] + normalMatrix[6 + row] * source[2];
+                        }
+                        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+                        float scale = length > 0.0f ? (flip ? -1.0f : 1.0f) / length : 0.0f;
+                        out.normals.insert(out.normals.end(), {normal[0] * scale, normal[1] * scale, normal[2] * scale});
+                    }
+
+                    std::vector<uint32_t> indices;
+                    if (primitive["indices"].IsNumber()) {
+                        auto accessor = ToSize(primitive["indices"]);
+                        auto componentType = static_cast<uint32_t>(m_Root["accessors"][accessor]["componentType"].AsNumber(0.0));
+                        const uint8_t* data;
+                        size_t stride;
+                        size_t count;
+                        if ((componentType != ComponentUnsignedByte && componentType != ComponentUnsignedShort && componentType != ComponentUnsignedInt)
+                            || !GetAccessorData(accessor, componentType, 1, data, stride, count)) {
+                            std::cout << "[Cook] Primitive with unusable indices" << std::endl;
+                            return -2;
+                        }
+                        indices.resize(count);
+                        for (size_t i = 0; i < count; i++) {
+                            if (componentType == ComponentUnsignedByte) {
+                                indices[i] = data[i * stride];
+                            } else if (componentType == ComponentUnsignedShort) {
+                                uint16_t value;
+                                std::memcpy(&value, data + i * stride, sizeof(value));
+                                indices[i] = value;
+                            } else {
+                                std::memcpy(&indices[i], data + i * stride, sizeof(uint32_t));
+                            }
+                        }
+                    } else {
+                        indices.resize(positionCount);
+                        for (size_t i = 0; i < positionCount; i++) {
+                            indices[i] = static_cast<uint32_t>(i);
+                        }
+                    }
+
+                    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                        uint32_t a = indices[i];
+                        uint32_t b = indices[i + (flip ? 2 : 1)];
+                        uint32_t c = indices[i + (flip ? 1 : 2)];
+                        if (a >= positionCount || b >= positionCount || c >= positionCount) {
+                            std::cout << "[Cook] Primitive index out of range" << std::endl;
+                            return -2;
+                        }
+                        out.indices.push_back(baseVertex + a);
+                        out.indices.push_back(baseVertex + b);
+                        out.indices.push_back(baseVertex + c);
+                    }
+                }
+                return 0;
+            }
+
+            JsonValue m_Root;
+            std::vector<std::string> m_Buffers;
+        };
+    }
+
+    int ImportGltf(const std::string& path, ImportedMesh& out) {
+        out = ImportedMesh();
+        GltfDocument document;
+        int result = document.Load(path);
+        if (result != 0) {
+            return result;
+        }
+        if ((result = document.Flatten(out)) != 0) {
+            return result;
+        }
+        if (out.indices.empty()) {
+            std::cout << "[Cook] " << path << " has no triangles" << std::endl;
+            return -2;
+        }
+        if (std::all_of(out.normals.begin(), out.normals.end(), [](float value) { return value == 0.0f; })) {
+            out.normals.clear();
+        }
+        return 0;
+    }
+}
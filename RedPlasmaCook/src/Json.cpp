@@ -0,0 +1,266 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "Json.h"
+
+#include <charconv>
+
+namespace RedPlasma::Cook {
+    namespace {
+        const JsonValue EmptyValue;
+        constexpr uint32_t MaxDepth = 256;
+
+        void AppendUtf8(std::string& out, uint32_t codePoint) {
+            if (codePoint < 0x80) {
+                out += static_cast<char>(codePoint);
+            } else if (codePoint < 0x800) {
+                out += static_cast<char>(0xC0 | (codePoint >> 6));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else if (codePoint < 0x10000) {
+                out += static_cast<char>(0xE0 | (codePoint >> 12));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (codePoint >> 18));
+                out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+    }
+
+    class JsonParser {
+    public:
+        explicit JsonParser(std::string_view text) : m_Text(text) {}
+
+        bool ParseDocument(JsonValue& out) {
+            if (!ParseValue(out, 0)) {
+                return false;
+            }
+            SkipWhitespace();
+            return m_Position == m_Text.size();
+        }
+
+        [[nodiscard]] size_t GetPosition() const { return m_Position; }
+
+    private:
+        void SkipWhitespace() {
+            while (m_Position < m_Text.size()) {
+                char c = m_Text[m_Position];
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                    return;
+                }
+                m_Position++;
+            }
+        }
+
+        bool Consume(std::string_view literal) {
+            if (m_Text.substr(m_Position, literal.size()) != literal) {
+                return false;
+            }
+            m_Position += literal.size();
+            return true;
+        }
+
+        bool ParseValue(JsonValue& out, uint32_t depth) {
+            if (depth > MaxDepth) {
+                return false;
+            }
+            SkipWhitespace();
+            if (m_Position >= m_Text.size()) {
+                return false;
+            }
+            switch (m_Text[m_Position]) {
+                case '{':
+                    return ParseObject(out, depth);
+                case '[':
+                    return ParseArray(out, depth);
+                case '"':
+                    out.m_Type = JsonValue::Type::String;
+                    return ParseString(out.m_String);
+                case 't':
+                    out.m_Type = JsonValue::Type::Bool;
+                    out.m_Bool = true;
+                    return Consume("true");
+                case 'f':
+                    out.m_Type = JsonValue::Type::Bool;
+                    out.m_Bool = false;
+                    return Consume("false");
+                case 'n':
+                    out.m_Type = JsonValue::Type::Null;
+                    return Consume("null");
+                default:
+                    return ParseNumber(out);
+            }
+        }
+
+        bool ParseNumber(JsonValue& out) {
+            const char* begin = m_Text.data() + m_Position;
+            const char* end = m_Text.data() + m_Text.size();
+            auto [next, error] = std::from_chars(begin, end, out.m_Number);
+            if (error != std::errc()) {
+                return false;
+            }
+            out.m_Type = JsonValue::Type::Number;
+            m_Position += static_cast<size_t>(next - begin);
+            return true;
+        }
+
+        bool ParseHex(uint32_t& out) {
+            if (m_Position + 4 > m_Text.size()) {
+                return false;
+            }
+            const char* begin = m_Text.data() + m_Position;
+            auto [next, error] = std::from_chars(begin, begin + 4, out, 16);
+            if (error != std::errc() || next != begin + 4) {
+                return false;
+            }
+            m_Position += 4;
+            return true;
+        }
+
+        bool ParseString(std::string& out) {
+            // Opening quote.
+            m_Position++;
+            while (m_Position < m_Text.size()) {
+                char c = m_Text[m_Position++];
+                if (c == '"') {
+                    return true;
+                }
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (m_Position >= m_Text.size()) {
+                    return false;
+                }
+                char escape = m_Text[m_Position++];
+                switch (escape) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        uint32_t codePoint;
+                        if (!ParseHex(codePoint)) {
+                            return false;
+                        }
+                        // High surrogate, the low half follows as its own escape.
+                        if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                            uint32_t low;
+                            if (!Consume("\\u") || !ParseHex(low) || low < 0xDC00 || low >= 0xE000) {
+                                return false;
+                            }
+                            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        AppendUtf8(out, codePoint);
+                        break;
+                    }
+                    default:
+                        return false;
+                }
+            }
+            return false;
+        }
+
+        bool ParseArray(JsonValue& out, uint32_t depth) {
+            out.m_Type = JsonValue::Type::Array;
+            m_Position++;
+            SkipWhitespace();
+            if (Consume("]")) {
+                return true;
+            }
+            while (true) {
+                out.m_Array.emplace_back();
+                if (!ParseValue(out.m_Array.back(), depth + 1)) {
+                    return false;
+                }
+                SkipWhitespace();
+                if (Consume("]")) {
+                    return true;
+                }
+                if (!Consume(",")) {
+                    return false;
+                }
+            }
+        }
+
+        bool ParseObject(JsonValue& out, uint32_t depth) {
+            out.m_Type = JsonValue::Type::Object;
+            m_Position++;
+            SkipWhitespace();
+            if (Consume("}")) {
+                return true;
+            }
+            while (true) {
+                SkipWhitespace();
+                if (m_Position >= m_Text.size() || m_Text[m_Position] != '"') {
+                    return false;
+                }
+                out.m_Object.emplace_back();
+                auto& member = out.m_Object.back();
+                if (!ParseString(member.first)) {
+                    return false;
+                }
+                SkipWhitespace();
+                if (!Consume(":") || !ParseValue(member.second, depth + 1)) {
+                    return false;
+                }
+                SkipWhitespace();
+                if (Consume("}")) {
+                    return true;
+                }
+                if (!Consume(",")) {
+                    return false;
+                }
+            }
+        }
+
+        std::string_view m_Text;
+        size_t m_Position = 0;
+    };
+
+    const JsonValue& JsonValue::operator[](size_t index) const {
+        if (m_Type != Type::Array || index >= m_Array.size()) {
+            return EmptyValue;
+        }
+        return m_Array[index];
+    }
+
+    const JsonValue& JsonValue::operator[](std::string_view key) const {
+        if (m_Type != Type::Object) {
+            return EmptyValue;
+        }
+        for (const auto& [name, value] : m_Object) {
+            if (name == key) {
+                return value;
+            }
+        }
+        return EmptyValue;
+    }
+
+    int JsonValue::Parse(std::string_view text, JsonValue& out, size_t& errorOffset) {
+        out = JsonValue();
+        JsonParser parser(text);
+        if (!parser.ParseDocument(out)) {
+            errorOffset = parser.GetPosition();
+            return -1;
+        }
+        errorOffset = 0;
+        return 0;
+    }
+}
@@ -0,0 +1,56 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_COOKJSON_H
+#define REDPLASMA_COOKJSON_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace RedPlasma::Cook {
+    // Just enough JSON for glTF documents. Values are a tree of owned nodes, lookups on missing keys or wrong
+    // types return an empty value instead of failing so importers can check once at the end.
+    class JsonValue {
+    public:
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        [[nodiscard]] Type GetType() const { return m_Type; }
+        [[nodiscard]] bool IsNull() const { return m_Type == Type::Null; }
+        [[nodiscard]] bool IsNumber() const { return m_Type == Type::Number; }
+        [[nodiscard]] bool IsString() const { return m_Type == Type::String; }
+        [[nodiscard]] bool IsArray() const { return m_Type == Type::Array; }
+        [[nodiscard]] bool IsObject() const { return m_Type == Type::Object; }
+
+        [[nodiscard]] double AsNumber(double fallback = 0.0) const { return m_Type == Type::Number ? m_Number : fallback; }
+        [[nodiscard]] const std::string& AsString() const { return m_String; }
+        [[nodiscard]] size_t Size() const { return m_Type == Type::Array ? m_Array.size() : 0; }
+        [[nodiscard]] const JsonValue& operator[](size_t index) const;
+        [[nodiscard]] const JsonValue& operator[](std::string_view key) const;
+
+        // Returns 0 or -1 with the position of the first error.
+        static int Parse(std::string_view text, JsonValue& out, size_t& errorOffset);
+
+    private:
+        friend class JsonParser;
+
+        Type m_Type = Type::Null;
+        bool m_Bool = false;
+        double m_Number = 0.0;
+        std::string m_String;
+        std::vector<JsonValue> m_Array;
+        std::vector<std::pair<std::string, JsonValue>> m_Object;
+    };
+}
+#endif //REDPLASMA_COOKJSON_H
\ No newline at end of file
@@ -0,0 +1,39 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_MESHIMPORTERS_H
+#define REDPLASMA_MESHIMPORTERS_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/renderer/IGraphicsDevice.h"
+
+namespace RedPlasma::Cook {
+    // Source geometry flattened into one indexed triangle list, in the engine's vertex layout.
+    struct ImportedMesh {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        // Three floats per vertex, or empty when the source has none. Zero length normals mark vertices whose
+        // source had none, the optimizer generates them.
+        std::vector<float> normals;
+    };
+
+    // Both return 0 or a negative error: -1 when the file can't be read, -2 when its content is unsupported or broken.
+    // Wavefront OBJ, polygons are triangulated as fans and all groups end up in the one mesh.
+    int ImportObj(const std::string& path, ImportedMesh& out);
+    // glTF 2.0 as .gltf (external or base64 embedded buffers) or .glb. The default scene is flattened with node
+    // transforms applied, triangle primitives only.
+    int ImportGltf(const std::string& path, ImportedMesh& out);
+}
+#endif //REDPLASMA_MESHIMPORTERS_H
\ No newline at end of file
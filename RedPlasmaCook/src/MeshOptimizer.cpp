@@ -0,0 +1,523 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace RedPlasma::Cook {
+    namespace {
+        // Forsyth's scoring, the cache it models is larger than the hardware one on purpose.
+        constexpr uint32_t ForsythCacheSize = 32;
+        constexpr float ForsythCacheDecayPower = 1.5f;
+        constexpr float ForsythLastTriangleScore = 0.75f;
+        constexpr float ForsythValenceBoostScale = 2.0f;
+        constexpr float ForsythValenceBoostPower = 0.5f;
+
+        struct Vector3 {
+            float x, y, z;
+        };
+
+        Vector3 Subtract(const Vertex& a, const Vertex& b) {
+            return {a.x - b.x, a.y - b.y, a.z - b.z};
+        }
+
+        Vector3 Cross(const Vector3& a, const Vector3& b) {
+            return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+        }
+
+        float Dot(const Vector3& a, const Vector3& b) {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        // Normal scaled by twice the triangle's area.
+        Vector3 TriangleNormal(const std::vector<Vertex>& vertices, const uint32_t* triangle) {
+            const Vertex& a = vertices[triangle[0]];
+            return Cross(Subtract(vertices[triangle[1]], a), Subtract(vertices[triangle[2]], a));
+        }
+
+        float ForsythVertexScore(int cachePosition, uint32_t remainingTriangles) {
+            if (remainingTriangles == 0) {
+                return -1.0f;
+            }
+            float score = 0.0f;
+            if (cachePosition >= 0) {
+                // The last triangle's vertices score the same, the order it was emitted in doesn't matter.
+                if (cachePosition < 3) {
+                    score = ForsythLastTriangleScore;
+                } else {
+                    float scale = 1.0f / static_cast<float>(ForsythCacheSize - 3);
+                    score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scale, ForsythCacheDecayPower);
+                }
+            }
+            // Vertices with few triangles left are finished first so they stop occupying the cache.
+            return score + ForsythValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ForsythValenceBoostPower);
+        }
+
+        struct VertexKey {
+            uint32_t bits[6];
+
+            bool operator==(const VertexKey& other) const {
+                return std::memcmp(bits, other.bits, sizeof(bits)) == 0;
+            }
+        };
+
+        struct VertexKeyHash {
+            size_t operator()(const VertexKey& key) const {
+                // FNV-1a over the words.
+                uint64_t hash = 14695981039346656037ull;
+                for (uint32_t word : key.bits) {
+                    hash = (hash ^ word) * 1099511628211ull;
+                }
+                return static_cast<size_t>(hash);
+            }
+        };
+
+        int8_t EncodeSnorm8(float value) {
+            return static_cast<int8_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+        }
+    }
+
+    void WeldVertices(ImportedMesh& mesh) {
+        bool hasNormals = !mesh.normals.empty();
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> unique;
+        unique.reserve(mesh.vertices.size());
+        std::vector<uint32_t> remap(mesh.vertices.size());
+        std::vector<Vertex> vertices;
+        std::vector<float> normals;
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            VertexKey key {};
+            std::memcpy(key.bits, &mesh.vertices[i], sizeof(Vertex));
+            if (hasNormals) {
+                std::memcpy(key.bits + 3, &mesh.normals[i * 3], 3 * sizeof(float));
+            }
+            auto [entry, inserted] = unique.try_emplace(key, static_cast<uint32_t>(vertices.size()));
+            if (inserted) {
+                vertices.push_back(mesh.vertices[i]);
+                if (hasNormals) {
+                    normals.insert(normals.end(), &mesh.normals[i * 3], &mesh.normals[i * 3] + 3);
+                }
+            }
+            remap[i] = entry->second;
+        }
+        for (uint32_t& index : mesh.indices) {
+            index = remap[index];
+        }
+        mesh.vertices = std::move(vertices);
+        mesh.normals = std::move(normals);
+    }
+
+    void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0) {
+            return;
+        }
+
+        // Triangles using each vertex, the first remaining[v] entries of a vertex's range are the ones not yet emitted.
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (uint32_t index : indices) {
+            remaining[index]++;
+        }
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            offsets[v + 1] = offsets[v] + remaining[v];
+        }
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); i++) {
+                adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScore(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            vertexScore[v] = ForsythVertexScore(-1, remaining[v]);
+        }
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> nextCache;
+        cache.reserve(ForsythCacheSize + 3);
+        nextCache.reserve(ForsythCacheSize + 3);
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        size_t scanCursor = 0;
+        int64_t bestTriangle = -1;
+        for (size_t output = 0; output < triangleCount; output++) {
+            if (bestTriangle < 0) {
+                // Nothing in the cache has triangles left, continue with the next one in input order.
+                while (emitted[scanCursor]) {
+                    scanCursor++;
+                }
+                bestTriangle = static_cast<int64_t>(scanCursor);
+            }
+            auto triangle = static_cast<size_t>(bestTriangle);
+            emitted[triangle] = true;
+
+            nextCache.clear();
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t v = indices[triangle * 3 + corner];
+                result.push_back(v);
+                // Remove the triangle from the vertex's remaining range.
+                uint32_t* begin = adjacency.data() + offsets[v];
+                uint32_t* end = begin + remaining[v];
+                *std::find(begin, end, static_cast<uint32_t>(triangle)) = *(end - 1);
+                remaining[v]--;
+                if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) {
+                    nextCache.push_back(v);
+                }
+            }
+            for (uint32_t v : cache) {
+                if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) {
+                    nextCache.push_back(v);
+                }
+            }
+
+            // Everything that moved or fell out of the cache gets a new score, then the best triangle touching
+            // the cache is the next one.
+            for (size_t i = 0; i < nextCache.size(); i++) {
+                uint32_t v = nextCache[i];
+                cachePosition[v] = i < ForsythCacheSize ? static_cast<int>(i) : -1;
+                vertexScore[v] = ForsythVertexScore(cachePosition[v], remaining[v]);
+            }
+            if (nextCache.size() > ForsythCacheSize) {
+                nextCache.resize(ForsythCacheSize);
+            }
+            std::swap(cache, nextCache);
+
+            bestTriangle = -1;
+            float bestScore = -1.0f;
+            for (uint32_t v : cache) {
+                for (uint32_t i = 0; i < remaining[v]; i++) {
+                    uint32_t candidate = adjacency[offsets[v] + i];
+                    float score = vertexScore[indices[candidate * 3]] + vertexScore[indices[candidate * 3 + 1]] + vertexScore[indices[candidate * 3 + 2]];
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestTriangle = candidate;
+                    }
+                }
+            }
+        }
+        indices = std::move(result);
+    }
+
+    void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold) {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0) {
+            return;
+        }
+        float targetAcmr = AnalyzeVertexCache(indices, static_cast<uint32_t>(vertices.size())).acmr * threshold;
+
+        // Clusters end as soon as their own ACMR, simulated from a cold cache since any cluster may end up first,
+        // is within the target. Reordering them later then costs at most the threshold.
+        std::vector<size_t> clusterStarts;
+        std::vector<uint32_t> cacheStamps(vertices.size(), 0);
+        uint32_t time = 0;
+        uint32_t clusterMisses = 0;
+        size_t clusterStart = 0;
+        for (size_t t = 0; t < triangleCount; t++) {
+            if (t == clusterStart) {
+                clusterStarts.push_back(t);
+                clusterMisses = 0;
+                // Moving the clock past the cache size empties the simulated cache.
+                time += StatisticsCacheSize;
+            }
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t v = indices[t * 3 + corner];
+                if (cacheStamps[v] == 0 || time - cacheStamps[v] >= StatisticsCacheSize) {
+                    cacheStamps[v] = ++time;
+                    clusterMisses++;
+                }
+            }
+            float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(t - clusterStart + 1);
+            if (clusterAcmr <= targetAcmr) {
+                clusterStart = t + 1;
+            }
+        }
+        clusterStarts.push_back(triangleCount);
+        size_t clusterCount = clusterStarts.size() - 1;
+
+        // Area weighted centroids and normals, per cluster and for the whole mesh.
+        Vector3 meshCentroid {0.0f, 0.0f, 0.0f};
+        float meshArea = 0.0f;
+        std::vector<Vector3> clusterCentroids(clusterCount);
+        std::vector<Vector3> clusterNormals(clusterCount);
+        for (size_t c = 0; c < clusterCount; c++) {
+            Vector3 centroid {0.0f, 0.0f, 0.0f};
+            Vector3 normal {0.0f, 0.0f, 0.0f};
+            float area = 0.0f;
+            for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+                const uint32_t* triangle = &indices[t * 3];
+                Vector3 triangleNormal = TriangleNormal(vertices, triangle);
+                float triangleArea = std::sqrt(Dot(triangleNormal, triangleNormal));
+                const Vertex& a = vertices[triangle[0]];
+                const Vertex& b = vertices[triangle[1]];
+                const Vertex& d = vertices[triangle[2]];
+                centroid.x += (a.x + b.x + d.x) * triangleArea;
+                centroid.y += (a.y + b.y + d.y) * triangleArea;
+                centroid.z += (a.z + b.z + d.z) * triangleArea;
+                normal.x += triangleNormal.x;
+                normal.y += triangleNormal.y;
+                normal.z += triangleNormal.z;
+                area += triangleArea;
+            }
+            meshCentroid.x += centroid.x;
+            meshCentroid.y += centroid.y;
+            meshCentroid.z += centroid.z;
+            meshArea += area;
+            float scale = area > 0.0f ? 1.0f / (3.0f * area) : 0.0f;
+            clusterCentroids[c] = {centroid.x * scale, centroid.y * scale, centroid.z * scale};
+            float length = std::sqrt(Dot(normal, normal));
+            float normalScale = length > 0.0f ? 1.0f / length : 0.0f;
+            clusterNormals[c] = {normal.x * normalScale, normal.y * normalScale, normal.z * normalScale};
+        }
+        float meshScale = meshArea > 0.0f ? 1.0f / (3.0f * meshArea) : 0.0f;
+        meshCentroid = {meshCentroid.x * meshScale, meshCentroid.y * meshScale, meshCentroid.z * meshScale};
+
+        // Clusters facing away from the center are likely on the outside and occlude the rest, draw them first.
+        std::vector<float> occlusion(clusterCount);
+        for (size_t c = 0; c < clusterCount; c++) {
+            Vector3 offset {clusterCentroids[c].x - meshCentroid.x, clusterCentroids[c].y - meshCentroid.y, clusterCentroids[c].z - meshCentroid.z};
+            occlusion[c] = Dot(offset, clusterNormals[c]);
+        }
+        std::vector<size_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return occlusion[a] > occlusion[b]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (size_t c : order) {
+            result.insert(result.end(), indices.begin() + static_cast<ptrdiff_t>(clusterStarts[c] * 3),
+                          indices.begin() + static_cast<ptrdiff_t>(clusterStarts[c + 1] * 3));
+        }
+        indices = std::move(result);
+    }
+
+    void OptimizeVertexFetch(ImportedMesh& mesh) {
+        bool hasNormals = !mesh.normals.empty();
+        std::vector<uint32_t> remap(mesh.vertices.size(), UINT32_MAX);
+        std::vector<Vertex> vertices;
+        std::vector<float> normals;
+        vertices.reserve(mesh.vertices.size());
+        for (uint32_t& index : mesh.indices) {
+            if (remap[index] == UINT32_MAX) {
+                remap[index] = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(mesh.vertices[index]);
+                if (hasNormals) {
+                    normals.insert(normals.end(), &mesh.normals[index * 3ull], &mesh.normals[index * 3ull] + 3);
+                }
+            }
+            index = remap[index];
+        }
+        mesh.vertices = std::move(vertices);
+        mesh.normals = std::move(normals);
+    }
+
+    VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize) {
+        VertexCacheStatistics statistics;
+        if (indices.empty()) {
+            return statistics;
+        }
+        // FIFO: a vertex is a hit while fewer than cacheSize misses happened since it was loaded.
+        std::vector<uint32_t> cacheStamps(vertexCount, 0);
+        std::vector<bool> used(vertexCount, false);
+        uint32_t time = 0;
+        uint32_t usedCount = 0;
+        for (uint32_t index : indices) {
+            if (cacheStamps[index] == 0 || time - cacheStamps[index] >= cacheSize) {
+                cacheStamps[index] = ++time;
+            }
+            if (!used[index]) {
+                used[index] = true;
+                usedCount++;
+            }
+        }
+        statistics.acmr = static_cast<float>(time) / static_cast<float>(indices.size() / 3);
+        statistics.atvr = static_cast<float>(time) / static_cast<float>(usedCount);
+        return statistics;
+    }
+
+    void GenerateNormals(ImportedMesh& mesh) {
+        mesh.normals.resize(mesh.vertices.size() * 3, 0.0f);
+        std::vector<bool> missing(mesh.vertices.size());
+        for (size_t v = 0; v < mesh.vertices.size(); v++) {
+            const float* normal = &mesh.normals[v * 3];
+            missing[v] = normal[0] == 0.0f && normal[1] == 0.0f && normal[2] == 0.0f;
+        }
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+            Vector3 normal = TriangleNormal(mesh.vertices, &mesh.indices[t]);
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t v = mesh.indices[t + corner];
+                if (missing[v]) {
+                    mesh.normals[v * 3ull] += normal.x;
+                    mesh.normals[v * 3ull + 1] += normal.y;
+                    mesh.normals[v * 3ull + 2] += normal.z;
+                }
+            }
+        }
+        for (size_t v = 0; v < mesh.vertices.size(); v++) {
+            if (!missing[v]) {
+                continue;
+            }
+            float* normal = &mesh.normals[v * 3];
+            float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if (length > 0.0f) {
+                normal[0] /= length;
+                normal[1] /= length;
+                normal[2] /= length;
+            } else {
+                // Only degenerate triangles touch it, any direction is as good as another.
+                normal[2] = 1.0f;
+            }
+        }
+    }
+
+    std::vector<QuantizedVertex> QuantizeVertices(const ImportedMesh& mesh) {
+        float boundsMin[3];
+        float boundsMax[3];
+        ComputeMeshBounds(mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()), boundsMin, boundsMax);
+        float scale[3];
+        for (int axis = 0; axis < 3; axis++) {
+            float extent = boundsMax[axis] - boundsMin[axis];
+            scale[axis] = extent > 0.0f ? 65535.0f / extent : 0.0f;
+        }
+
+        std::vector<QuantizedVertex> result(mesh.vertices.size());
+        for (size_t v = 0; v < mesh.vertices.size(); v++) {
+            const float position[3] = {mesh.vertices[v].x, mesh.vertices[v].y, mesh.vertices[v].z};
+            for (int axis = 0; axis < 3; axis++) {
+                float q = std::round((position[axis] - boundsMin[axis]) * scale[axis]);
+                result[v].position[axis] = static_cast<uint16_t>(std::clamp(q, 0.0f, 65535.0f));
+            }
+
+            // Project onto the octahedron, the lower half is folded over the diagonals.
+            const float* n = &mesh.normals[v * 3];
+            float l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+            float x = l1 > 0.0f ? n[0] / l1 : 0.0f;
+            float y = l1 > 0.0f ? n[1] / l1 : 0.0f;
+            if (n[2] < 0.0f) {
+                float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                x = foldedX;
+                y = foldedY;
+            }
+            result[v].normal[0] = EncodeSnorm8(x);
+            result[v].normal[1] = EncodeSnorm8(y);
+        }
+        return result;
+    }
+
+    Meshlets BuildMeshlets(const ImportedMesh& mesh, uint32_t maxVertices, uint32_t maxTriangles) {
+        Meshlets result;
+        // Local indices are stored in a byte.
+        maxVertices = std::clamp(maxVertices, 3u, 255u);
+        maxTriangles = std::max(maxTriangles, 1u);
+        std::vector<uint8_t> localIndex(mesh.vertices.size(), 0xFF);
+        MeshFileMeshlet current {};
+
+        auto flush = [&]() {
+            if (current.triangleCount == 0) {
+                return;
+            }
+            const uint32_t* vertices = result.vertices.data() + current.vertexOffset;
+            const uint8_t* triangles = result.triangles.data() + current.triangleOffset;
+
+            float boundsMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+            float boundsMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+            for (uint32_t i = 0; i < current.vertexCount; i++) {
+                const Vertex& vertex = mesh.vertices[vertices[i]];
+                const float position[3] = {vertex.x, vertex.y, vertex.z};
+                for (int axis = 0; axis < 3; axis++) {
+                    boundsMin[axis] = std::min(boundsMin[axis], position[axis]);
+                    boundsMax[axis] = std::max(boundsMax[axis], position[axis]);
+                }
+            }
+            float radiusSquared = 0.0f;
+            for (int axis = 0; axis < 3; axis++) {
+                current.center[axis] = (boundsMin[axis] + boundsMax[axis]) * 0.5f;
+            }
+            for (uint32_t i = 0; i < current.vertexCount; i++) {
+                const Vertex& vertex = mesh.vertices[vertices[i]];
+                Vector3 offset {vertex.x - current.center[0], vertex.y - current.center[1], vertex.z - current.center[2]};
+                radiusSquared = std::max(radiusSquared, Dot(offset, offset));
+            }
+            current.radius = std::sqrt(radiusSquared);
+
+            // The cone axis is the average triangle direction, its spread the widest angle any triangle has to it.
+            std::vector<Vector3> normals;
+            Vector3 axis {0.0f, 0.0f, 0.0f};
+            for (uint32_t t = 0; t < current.triangleCount; t++) {
+                uint32_t triangle[3] = {vertices[triangles[t * 3]], vertices[triangles[t * 3 + 1]], vertices[triangles[t * 3 + 2]]};
+                Vector3 normal = TriangleNormal(mesh.vertices, triangle);
+                float length = std::sqrt(Dot(normal, normal));
+                if (length == 0.0f) {
+                    continue;
+                }
+                normal = {normal.x / length, normal.y / length, normal.z / length};
+                normals.push_back(normal);
+                axis = {axis.x + normal.x, axis.y + normal.y, axis.z + normal.z};
+            }
+            float axisLength = std::sqrt(Dot(axis, axis));
+            float minimumDot = 1.0f;
+            if (axisLength > 0.0f) {
+                axis = {axis.x / axisLength, axis.y / axisLength, axis.z / axisLength};
+                for (const Vector3& normal : normals) {
+                    minimumDot = std::min(minimumDot, Dot(axis, normal));
+                }
+            }
+            current.coneAxis[0] = axis.x;
+            current.coneAxis[1] = axis.y;
+            current.coneAxis[2] = axis.z;
+            // Cones wider than about 84 degrees almost never cull anything, they are disabled instead.
+            current.coneCutoff = axisLength > 0.0f && minimumDot > 0.1f ? std::sqrt(1.0f - minimumDot * minimumDot) : 1.0f;
+
+            for (uint32_t i = 0; i < current.vertexCount; i++) {
+                localIndex[vertices[i]] = 0xFF;
+            }
+            result.meshlets.push_back(current);
+            current = {};
+            current.vertexOffset = static_cast<uint32_t>(result.vertices.size());
+            current.triangleOffset = static_cast<uint32_t>(result.triangles.size());
+        };
+
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+            const uint32_t* triangle = &mesh.indices[t];
+            uint32_t newVertices = 0;
+            for (int corner = 0; corner < 3; corner++) {
+                bool repeated = (corner > 0 && triangle[corner] == triangle[0]) || (corner > 1 && triangle[corner] == triangle[1]);
+                newVertices += localIndex[triangle[corner]] == 0xFF && !repeated ? 1 : 0;
+            }
+            if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles) {
+                flush();
+            }
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t v = triangle[corner];
+                if (localIndex[v] == 0xFF) {
+                    localIndex[v] = static_cast<uint8_t>(current.vertexCount++);
+                    result.vertices.push_back(v);
+                }
+                result.triangles.push_back(localIndex[v]);
+            }
+            current.triangleCount++;
+        }
+        flush();
+        return result;
+    }
+}
@@ -0,0 +1,58 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_MESHOPTIMIZER_H
+#define REDPLASMA_MESHOPTIMIZER_H
+#include <cstdint>
+#include <vector>
+
+#include "MeshImporters.h"
+#include "core/assets/MeshFile.h"
+
+namespace RedPlasma::Cook {
+    // Cache size the statistics are measured against, a conservative FIFO for current GPUs.
+    constexpr uint32_t StatisticsCacheSize = 16;
+
+    struct VertexCacheStatistics {
+        // Average cache misses per triangle (ACMR), 0.5 is the ideal for large grids, 3 means no reuse at all.
+        float acmr = 0.0f;
+        // Average transformed vertices per vertex (ATVR), 1 means every vertex is shaded once.
+        float atvr = 0.0f;
+    };
+
+    struct Meshlets {
+        std::vector<MeshFileMeshlet> meshlets;
+        std::vector<uint32_t> vertices;
+        std::vector<uint8_t> triangles;
+    };
+
+    // The stages in the order the cooker runs them, every one of them keeps the rendered result the same.
+    // Merges vertices that are bitwise identical, unindexed sources become indexed here.
+    void WeldVertices(ImportedMesh& mesh);
+    // Reorders triangles so vertices are reused while they are still in the post-transform cache (Forsyth).
+    void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+    // Splits the cache optimized order into clusters where the cache efficiency allows it and sorts them so outward
+    // facing clusters draw first. threshold is the ACMR the result may lose against the input, 1.05 allows 5%.
+    void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold);
+    // Reorders vertices by their first use, so the fetches follow the index buffer. Unused vertices are dropped.
+    void OptimizeVertexFetch(ImportedMesh& mesh);
+    [[nodiscard]] VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = StatisticsCacheSize);
+
+    // Area weighted normals for every vertex that has a zero length one.
+    void GenerateNormals(ImportedMesh& mesh);
+    // Positions against ComputeMeshBounds(), octahedral normals. Needs normals.
+    [[nodiscard]] std::vector<QuantizedVertex> QuantizeVertices(const ImportedMesh& mesh);
+    // Greedy clusters in index order, run it after the index optimizations to get compact meshlets.
+    [[nodiscard]] Meshlets BuildMeshlets(const ImportedMesh& mesh, uint32_t maxVertices, uint32_t maxTriangles);
+}
+#endif //REDPLASMA_MESHOPTIMIZER_H
\ No newline at end of file
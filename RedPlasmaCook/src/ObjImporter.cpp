@@ -0,0 +1,156 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "MeshImporters.h"
+
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace RedPlasma::Cook {
+    namespace {
+        bool IsSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        std::string_view NextToken(std::string_view& line) {
+            size_t begin = 0;
+            while (begin < line.size() && IsSpace(line[begin])) {
+                begin++;
+            }
+            size_t end = begin;
+            while (end < line.size() && !IsSpace(line[end])) {
+                end++;
+            }
+            std::string_view token = line.substr(begin, end - begin);
+            line.remove_prefix(end);
+            return token;
+        }
+
+        bool ParseFloat(std::string_view token, float& out) {
+            auto [next, error] = std::from_chars(token.data(), token.data() + token.size(), out);
+            return error == std::errc() && next == token.data() + token.size();
+        }
+
+        // Resolves one OBJ index, negative ones count back from the last element read so far.
+        bool ParseIndex(std::string_view token, size_t count, uint32_t& out) {
+            long long index = 0;
+            auto [next, error] = std::from_chars(token.data(), token.data() + token.size(), index);
+            if (error != std::errc() || next != token.data() + token.size() || index == 0) {
+                return false;
+            }
+            long long resolved = index > 0 ? index - 1 : static_cast<long long>(count) + index;
+            if (resolved < 0 || resolved >= static_cast<long long>(count)) {
+                return false;
+            }
+            out = static_cast<uint32_t>(resolved);
+            return true;
+        }
+
+        // Face corners are "v", "v/vt", "v//vn" or "v/vt/vn". Texture coordinates are not used, a missing
+        // normal is returned as UINT32_MAX.
+        bool ParseCorner(std::string_view token, size_t positionCount, size_t normalCount, uint32_t& position, uint32_t& normal) {
+            size_t firstSlash = token.find('/');
+            if (!ParseIndex(token.substr(0, firstSlash), positionCount, position)) {
+                return false;
+            }
+            normal = UINT32_MAX;
+            size_t secondSlash = firstSlash == std::string_view::npos ? std::string_view::npos : token.find('/', firstSlash + 1);
+            if (secondSlash == std::string_view::npos) {
+                return true;
+            }
+            return ParseIndex(token.substr(secondSlash + 1), normalCount, normal);
+        }
+    }
+
+    int ImportObj(const std::string& path, ImportedMesh& out) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cout << "[Cook] Failed to open " << path << std::endl;
+            return -1;
+        }
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::string text = contents.str();
+
+        out = ImportedMesh();
+        std::vector<Vertex> positions;
+        std::vector<float> normals;
+        // Every distinct position / normal pair becomes one vertex.
+        std::unordered_map<uint64_t, uint32_t> corners;
+        bool hasNormals = false;
+        std::vector<uint32_t> polygon;
+        std::string_view remaining = text;
+        uint32_t lineNumber = 0;
+        while (!remaining.empty()) {
+            size_t lineEnd = remaining.find('\n');
+            std::string_view line = remaining.substr(0, lineEnd);
+            remaining.remove_prefix(lineEnd == std::string_view::npos ? remaining.size() : lineEnd + 1);
+            lineNumber++;
+
+            std::string_view keyword = NextToken(line);
+            if (keyword == "v") {
+                Vertex vertex {};
+                if (!ParseFloat(NextToken(line), vertex.x) || !ParseFloat(NextToken(line), vertex.y) || !ParseFloat(NextToken(line), vertex.z)) {
+                    std::cout << "[Cook] " << path << ":" << lineNumber << ": malformed vertex" << std::endl;
+                    return -2;
+                }
+                positions.push_back(vertex);
+            } else if (keyword == "vn") {
+                float normal[3];
+                if (!ParseFloat(NextToken(line), normal[0]) || !ParseFloat(NextToken(line), normal[1]) || !ParseFloat(NextToken(line), normal[2])) {
+                    std::cout << "[Cook] " << path << ":" << lineNumber << ": malformed normal" << std::endl;
+                    return -2;
+                }
+                normals.insert(normals.end(), normal, normal + 3);
+            } else if (keyword == "f") {
+                polygon.clear();
+                for (std::string_view token = NextToken(line); !token.empty(); token = NextToken(line)) {
+                    uint32_t position;
+                    uint32_t normal;
+                    if (!ParseCorner(token, positions.size(), normals.size() / 3, position, normal)) {
+                        std::cout << "[Cook] " << path << ":" << lineNumber << ": malformed face" << std::endl;
+                        return -2;
+                    }
+                    auto [corner, inserted] = corners.try_emplace((static_cast<uint64_t>(normal) << 32) | position,
+                                                                  static_cast<uint32_t>(out.vertices.size()));
+                    if (inserted) {
+                        out.vertices.push_back(positions[position]);
+                        const float* source = normal != UINT32_MAX ? &normals[normal * 3ull] : nullptr;
+                        out.normals.insert(out.normals.end(), {source ? source[0] : 0.0f, source ? source[1] : 0.0f, source ? source[2] : 0.0f});
+                        hasNormals |= source != nullptr;
+                    }
+                    polygon.push_back(corner->second);
+                }
+                for (size_t i = 2; i < polygon.size(); i++) {
+                    out.indices.push_back(polygon[0]);
+                    out.indices.push_back(polygon[i - 1]);
+                    out.indices.push_back(polygon[i]);
+                }
+            }
+            // Texture coordinates, materials and groups are not part of the engine's vertex yet.
+        }
+        if (!hasNormals) {
+            out.normals.clear();
+        }
+
+        if (out.indices.empty()) {
+            std::cout << "[Cook] " << path << " has no faces" << std::endl;
+            return -2;
+        }
+        return 0;
+    }
+}
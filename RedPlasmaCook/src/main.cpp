@@ -0,0 +1,152 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "MeshImporters.h"
+#include "MeshOptimizer.h"
+#include "core/assets/MeshFile.h"
+
+namespace {
+    using namespace RedPlasma;
+    using namespace RedPlasma::Cook;
+
+    struct CookOptions {
+        std::string input;
+        std::string output;
+        bool optimize = true;
+        float overdrawThreshold = 1.05f;
+        bool quantize = false;
+        bool meshlets = false;
+        // 64 / 124 fit the mesh shader limits of every current vendor.
+        uint32_t meshletVertices = 64;
+        uint32_t meshletTriangles = 124;
+    };
+
+    void PrintUsage() {
+        std::cout << "Usage: RedPlasmaCook [--no-optimize] [--overdraw-threshold F] [--quantize]\n"
+                     "                     [--meshlets] [--meshlet-vertices N] [--meshlet-triangles N]\n"
+                     "                     <input.obj|input.gltf|input.glb> <output.rpmesh>" << std::endl;
+    }
+
+    bool ParseOptions(int argc, char** argv, CookOptions& options) {
+        std::vector<std::string> paths;
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--no-optimize") == 0) {
+                options.optimize = false;
+            } else if (std::strcmp(argv[i], "--overdraw-threshold") == 0 && hasValue) {
+                options.overdrawThreshold = std::stof(argv[++i]);
+            } else if (std::strcmp(argv[i], "--quantize") == 0) {
+                options.quantize = true;
+            } else if (std::strcmp(argv[i], "--meshlets") == 0) {
+                options.meshlets = true;
+            } else if (std::strcmp(argv[i], "--meshlet-vertices") == 0 && hasValue) {
+                options.meshletVertices = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (std::strcmp(argv[i], "--meshlet-triangles") == 0 && hasValue) {
+                options.meshletTriangles = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (argv[i][0] != '-') {
+                paths.emplace_back(argv[i]);
+            } else {
+                return false;
+            }
+        }
+        if (paths.size() != 2 || options.overdrawThreshold < 1.0f || options.meshletVertices < 3 || options.meshletVertices > 255
+            || options.meshletTriangles == 0) {
+            return false;
+        }
+        options.input = paths[0];
+        options.output = paths[1];
+        return true;
+    }
+
+    std::string GetExtension(const std::string& path) {
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension;
+    }
+
+    void PrintCacheStatistics(const char* stage, const ImportedMesh& mesh) {
+        VertexCacheStatistics statistics = AnalyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+        std::cout << "[Cook] " << stage << ": " << mesh.vertices.size() << " vertices, ACMR " << statistics.acmr
+                  << ", ATVR " << statistics.atvr << std::endl;
+    }
+}
+
+// Converts source meshes into the engine's cooked mesh format, see core/assets/MeshFile.h.
+int main(int argc, char** argv) {
+    CookOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    ImportedMesh mesh;
+    int result;
+    std::string extension = GetExtension(options.input);
+    if (extension == ".obj") {
+        result = ImportObj(options.input, mesh);
+    } else if (extension == ".gltf" || extension == ".glb") {
+        result = ImportGltf(options.input, mesh);
+    } else {
+        std::cout << "[Cook] Unsupported source format " << extension << std::endl;
+        PrintUsage();
+        return 2;
+    }
+    if (result != 0) {
+        return 1;
+    }
+
+    if (options.optimize) {
+        PrintCacheStatistics("Imported", mesh);
+        WeldVertices(mesh);
+        OptimizeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+        OptimizeOverdraw(mesh.indices, mesh.vertices, options.overdrawThreshold);
+        OptimizeVertexFetch(mesh);
+        PrintCacheStatistics("Optimized", mesh);
+    }
+
+    MeshFileContents contents;
+    std::vector<QuantizedVertex> quantized;
+    if (options.quantize) {
+        GenerateNormals(mesh);
+        quantized = QuantizeVertices(mesh);
+        contents.quantizedVertices = quantized.data();
+    }
+    Meshlets meshlets;
+    if (options.meshlets) {
+        meshlets = BuildMeshlets(mesh, options.meshletVertices, options.meshletTriangles);
+        contents.meshlets = meshlets.meshlets.data();
+        contents.meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+        contents.meshletVertices = meshlets.vertices.data();
+        contents.meshletVertexCount = static_cast<uint32_t>(meshlets.vertices.size());
+        contents.meshletTriangles = meshlets.triangles.data();
+        contents.meshletTriangleBytes = static_cast<uint32_t>(meshlets.triangles.size());
+        std::cout << "[Cook] " << meshlets.meshlets.size() << " meshlets" << std::endl;
+    }
+
+    contents.vertices = mesh.vertices.data();
+    contents.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    contents.indices = mesh.indices.data();
+    contents.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    if (WriteMeshFile(options.output.c_str(), contents) != 0) {
+        return 1;
+    }
+    std::cout << "[Cook] " << options.input << " -> " << options.output << ": " << mesh.vertices.size() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles" << std::endl;
+    return 0;
+}
@@ -11,15 +11,134 @@
 // Created by Dueloss on 12.01.2026.
 //
 
+#include <cmath>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <GLFW/glfw3.h>
 #define GLFW_EXPOSE_NATIVE_WAYLAND
 #include <GLFW/glfw3native.h>
 #include "core/Engine.h"
+#include "core/renderer/IGraphicsDevice.h"
+#include "core/sim/FrameSnapshot.h"
+#include "plugins/renderer/vulkan/platform/headless/HeadlessSurface.h"
 #include "plugins/renderer/vulkan/platform/linux/wayland/WaylandSurface.h"
 
+struct EditorWindowState {
+    RedPlasma::Engine* engine;
+    RedPlasma::WaylandSurface* surface;
+};
+
+static void OnFramebufferResized(GLFWwindow* window, int width, int height) {
+    auto* state = static_cast<EditorWindowState*>(glfwGetWindowUserPointer(window));
+    state->surface->UpdateSize(width, height);
+    state->engine->OnWindowResized();
+}
+
+static int UploadDefaultScene(RedPlasma::Engine& engine) {
+    std::vector<RedPlasma::Vertex> triangle = {
+        {0.0f, -0.5f, 0.0f},
+        {0.5f, 0.5f, 0.0f},
+        {-0.5f, 0.5f, 0.0f}
+    };
+    int mesh = engine.GetGraphicsDevice()->UploadMeshData(triangle);
+    if (mesh < 0) {
+        std::cout << "[Editor] Failed to upload the default mesh" << std::endl;
+    }
+    return mesh;
+}
+
+// Spins the default triangle around the view axis, one fixed step per call.
+static void SimulateDefaultScene(int mesh, double stepSeconds, double& angle, RedPlasma::FrameSnapshot& snapshot) {
+    angle += stepSeconds;
+    RedPlasma::RenderObject object;
+    object.mesh = mesh;
+    auto c = static_cast<float>(std::cos(angle));
+    auto s = static_cast<float>(std::sin(angle));
+    object.transform[0] = c;
+    object.transform[1] = s;
+    object.transform[4] = -s;
+    object.transform[5] = c;
+    snapshot.objects.push_back(object);
+}
+
+// Single threaded frames have no simulation, the triangle is drawn where it was uploaded.
+// Nothing changes after the first frame, so the device replays that one from then on.
+static void SubmitStaticScene(RedPlasma::Engine& engine, int mesh) {
+    if (engine.GetGraphicsDevice()->ReuseLastDrawList() == 0) {
+        return;
+    }
+    RedPlasma::RenderObject object;
+    object.mesh = mesh;
+    engine.GetGraphicsDevice()->SubmitDraw(object.mesh, object.material, object.transform);
+}
+
+// Renders a fixed number of frames without a display server, optionally dumping the last one as PPM.
+static int RunHeadless(int frameCount, const char* readbackPath) {
+    std::cout << "[Editor] Red Plasma Engine: Starting headless..." << std::endl;
+    RedPlasma::Engine engine;
+
+    RedPlasma::GraphicsDeviceSettings settings;
+    settings.enableReadback = readbackPath != nullptr;
+    engine.Configure(settings);
+
+    RedPlasma::HeadlessSurface surface(1280, 720);
+    if (engine.AttachWindow(&surface) != 0) {
+        std::cout << "[Editor] Headless surface is not available on this device" << std::endl;
+        return 1;
+    }
+    int mesh = UploadDefaultScene(engine);
+
+    for (int i = 0; i < frameCount; i++) {
+        SubmitStaticScene(engine, mesh);
+        engine.Run();
+    }
+
+    int exitCode = 0;
+    if (readbackPath != nullptr) {
+        std::vector<uint8_t> pixels;
+        uint32_t width = 0, height = 0;
+        if (engine.ReadbackFrame(pixels, width, height) == 0) {
+            std::ofstream file(readbackPath, std::ios::binary);
+            file << "P6\n" << width << " " << height << "\n255\n";
+            for (size_t i = 0; i < pixels.size(); i += 4) {
+                file.write(reinterpret_cast<const char*>(&pixels[i]), 3);
+            }
+            std::cout << "[Editor] Wrote " << readbackPath << std::endl;
+        } else {
+            std::cout << "[Editor] Readback failed" << std::endl;
+            exitCode = 1;
+        }
+    }
+
+    engine.Shutdown();
+    std::cout << "[Editor] Red Plasma Engine: Closing..." << std::endl;
+    return exitCode;
+}
+
+int main(int argc, char** argv) {
+    bool headless = false;
+    bool singleThreaded = false;
+    int frameCount = 300;
+    const char* readbackPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frameCount = std::stoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--readback") == 0 && i + 1 < argc) {
+            readbackPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--single-threaded") == 0) {
+            singleThreaded = true;
+        }
+    }
+
+    if (headless) {
+        return RunHeadless(frameCount, readbackPath);
+    }
 
-int main() {
     glfwInit();
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
     int width = 1280, height = 720;
@@ -35,10 +154,43 @@ int main() {
     mySurface->UpdateSize(width, height);
 
     engine.AttachWindow(mySurface);
+    int triangleMesh = UploadDefaultScene(engine);
 
+    EditorWindowState windowState = { &engine, mySurface };
+    glfwSetWindowUserPointer(window, &windowState);
+    glfwSetFramebufferSizeCallback(window, OnFramebufferResized);
+
+    // Only touched by the simulation thread once the threaded mode runs.
+    double triangleAngle = 0.0;
+    if (!singleThreaded) {
+        RedPlasma::ThreadedModeSettings threadedSettings;
+        engine.StartThreaded(threadedSettings,
+            [triangleMesh, &triangleAngle](double stepSeconds, RedPlasma::FrameSnapshot& snapshot) {
+                SimulateDefaultScene(triangleMesh, stepSeconds, triangleAngle, snapshot);
+            });
+    }
+
+    double lastTitleUpdate = glfwGetTime();
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        if (engine.IsThreaded()) {
+            // Rendering happens elsewhere, sleep until input arrives instead of spinning.
+            glfwWaitEventsTimeout(0.01);
+        } else {
+            glfwPollEvents();
+            SubmitStaticScene(engine, triangleMesh);
+        }
         engine.Run();
+
+        // Twice a second is plenty for a readable per-pass GPU time in the title bar.
+        double now = glfwGetTime();
+        if (now - lastTitleUpdate > 0.5) {
+            lastTitleUpdate = now;
+            std::string title = "Red Plasma Editor";
+            for (const RedPlasma::GpuZoneTiming& zone : engine.GetGpuTimings()) {
+                title += " | " + std::string(zone.name) + " " + std::to_string(zone.milliseconds).substr(0, 5) + " ms";
+            }
+            glfwSetWindowTitle(window, title.c_str());
+        }
     }
     engine.Shutdown();
     std::cout << "[Editor] Red Plasma Engine: Closing..." << std::endl;
@@ -0,0 +1,35 @@
+# Turns a SPIR-V binary into a header with a constexpr uint32_t array.
+# Usage: cmake -DINPUT=<file.spv> -DOUTPUT=<file.h> -DSYMBOL=<identifier> -P EmbedSpirv.cmake
+if(NOT INPUT OR NOT OUTPUT OR NOT SYMBOL)
+    message(FATAL_ERROR "EmbedSpirv.cmake needs INPUT, OUTPUT and SYMBOL")
+endif()
+
+file(READ "${INPUT}" SPIRV_HEX HEX)
+string(LENGTH "${SPIRV_HEX}" SPIRV_HEX_LENGTH)
+math(EXPR SPIRV_WORD_REMAINDER "${SPIRV_HEX_LENGTH} % 8")
+if(SPIRV_HEX_LENGTH EQUAL 0 OR NOT SPIRV_WORD_REMAINDER EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not a valid SPIR-V binary")
+endif()
+
+# SPIR-V is a stream of little endian words, swap each group of 4 bytes into a 0x literal.
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " SPIRV_WORDS "${SPIRV_HEX}")
+# CMake regexes have no {n} quantifier, hence the spelled out group of eight words per line.
+set(SPIRV_WORD "0x[0-9a-f]+, ")
+string(REGEX REPLACE "(${SPIRV_WORD}${SPIRV_WORD}${SPIRV_WORD}${SPIRV_WORD}${SPIRV_WORD}${SPIRV_WORD}${SPIRV_WORD}${SPIRV_WORD})" "\\1\n        " SPIRV_WORDS "${SPIRV_WORDS}")
+string(REPLACE " \n" "\n" SPIRV_WORDS "${SPIRV_WORDS}")
+string(STRIP "${SPIRV_WORDS}" SPIRV_WORDS)
+
+file(WRITE "${OUTPUT}.tmp"
+"// Generated from ${INPUT}, do not edit.
+#pragma once
+#include <cstdint>
+
+namespace RedPlasma::Shaders {
+    inline constexpr uint32_t ${SYMBOL}[] = {
+        ${SPIRV_WORDS}
+    };
+}
+")
+# Only touch the header when the content changed, so unchanged shaders do not trigger a rebuild.
+configure_file("${OUTPUT}.tmp" "${OUTPUT}" COPYONLY)
+file(REMOVE "${OUTPUT}.tmp")
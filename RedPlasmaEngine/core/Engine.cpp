@@ -11,24 +11,101 @@
 // Created by Dueloss on 12.01.2026.
 //
 #include "Engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include "VulkanGraphicsDevice.h"
+#include "assets/MeshFile.h"
+#include "ecs/SceneComponents.h"
+#include "ecs/World.h"
+#include "jobs/JobSystem.h"
+#include "sim/FrameSnapshot.h"
 
 namespace RedPlasma {
+    // Lives while the threaded mode runs. The graphics device belongs to the render thread in that time,
+    // other threads read its statistics from the copies below.
+    struct Engine::ThreadedState {
+        explicit ThreadedState(uint32_t queueCapacity) : queue(queueCapacity) {}
 
-    Engine::Engine() : m_IsRunning(false), m_GraphicsDevice(nullptr){
+        ThreadedModeSettings settings;
+        SimulationCallback simulate;
+        RenderCallback render;
+        SnapshotQueue queue;
+        std::chrono::steady_clock::time_point start;
+        std::atomic<bool> running{true};
+        std::atomic<bool> resizePending{false};
+        std::thread simulationThread;
+        std::thread renderThread;
+
+        mutable std::mutex statsMutex;
+        FrameStats frameStats;
+        std::vector<GpuZoneTiming> gpuTimings;
+        GpuMemoryStats memoryStats;
+
+        // Objects of the last submitted snapshot, only touched by the render thread.
+        std::vector<RenderObject> submittedObjects;
+    };
+
+    namespace {
+        bool SameObjects(const std::vector<RenderObject>& a, const std::vector<RenderObject>& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const RenderObject& x, const RenderObject& y) {
+                return x.mesh == y.mesh && x.material == y.material && std::memcmp(x.transform, y.transform, sizeof(x.transform)) == 0;
+            });
+        }
+
+        // Chunks handed to one job when the world's drawables are copied into a snapshot.
+        constexpr uint32_t RenderChunksPerJob = 4;
+
+        void AppendWorldObjects(World& world, JobSystem& jobSystem, std::vector<RenderObject>& objects) {
+            Query& query = world.CreateQuery<const LocalToWorld, const MeshRenderer>();
+            size_t base = objects.size();
+            objects.resize(base + world.CountEntities(query));
+            world.ForEachChunkParallel(query, jobSystem, RenderChunksPerJob, [&](ChunkView& chunk) {
+                const LocalToWorld* transforms = chunk.Get<const LocalToWorld>();
+                const MeshRenderer* renderers = chunk.Get<const MeshRenderer>();
+                RenderObject* out = objects.data() + base + chunk.GetFirstIndex();
+                for (uint32_t i = 0; i < chunk.GetCount(); i++) {
+                    out[i].mesh = renderers[i].mesh;
+                    out[i].material = renderers[i].material;
+                    std::memcpy(out[i].transform, transforms[i].matrix.m, sizeof(out[i].transform));
+                }
+            });
+        }
+    }
+
+    Engine::Engine() : m_IsRunning(false), m_GraphicsDevice(nullptr), m_JobSystem(nullptr), m_Threaded(nullptr), m_World(nullptr),
+        m_SubmittedTransformVersion(0), m_SubmittedRendererVersion(0), m_SubmittedWorldDraws(0) {
         std::cout << "Red Plasma Engine: Initializing..." << std::endl;
         m_GraphicsDevice = new VulkanGraphicsDevice();
+        m_JobSystem = new JobSystem();
+        m_JobSystem->Initialize();
+        m_GraphicsDevice->SetJobSystem(m_JobSystem);
+        m_World = new World();
     }
 
     Engine::~Engine() {
         std::cout << "Red Plasma Engine: Shutting down..." << std::endl;
         if (m_GraphicsDevice) {
-            m_GraphicsDevice->Shutdown();
+            Shutdown();
             delete m_GraphicsDevice;
             m_GraphicsDevice = nullptr;
         }
+        delete m_World;
+        m_World = nullptr;
+        delete m_JobSystem;
+        m_JobSystem = nullptr;
+    }
+
+    void Engine::Configure(const GraphicsDeviceSettings& settings) {
+        if (m_GraphicsDevice) {
+            m_GraphicsDevice->Configure(settings);
+        }
     }
 
     int Engine::AttachWindow(IWindowSurface* windowHandle) {
@@ -50,12 +127,242 @@ namespace RedPlasma {
     }
 
     void Engine::Run() const {
-        if (m_IsRunning) {
+        if (!m_IsRunning) {
+            return;
+        }
+        if (m_Threaded == nullptr) {
+            SubmitWorld();
             m_GraphicsDevice->DrawFrame();
+            m_JobSystem->NotifyFrameCompleted(m_GraphicsDevice->GetCompletedFrameNumber());
+        }
+        m_JobSystem->RunMainThreadJobs();
+    }
+
+    int Engine::StartThreaded(const ThreadedModeSettings& settings, SimulationCallback simulate, RenderCallback render) {
+        if (!m_IsRunning) {
+            std::cout << "Red Plasma Engine: Attach a window before starting the threaded mode!" << std::endl;
+            return -1;
+        }
+        if (m_Threaded != nullptr) {
+            return -2;
+        }
+        if (!simulate || settings.fixedStepSeconds <= 0.0) {
+            std::cout << "Red Plasma Engine: Threaded mode needs a simulation callback and a positive step!" << std::endl;
+            return -3;
+        }
+
+        m_Threaded = new ThreadedState(settings.maxQueuedSnapshots);
+        m_Threaded->settings = settings;
+        m_Threaded->simulate = std::move(simulate);
+        m_Threaded->render = std::move(render);
+        m_Threaded->start = std::chrono::steady_clock::now();
+        m_Threaded->frameStats = m_GraphicsDevice->GetFrameStats();
+        m_Threaded->simulationThread = std::thread([this]() { SimulationLoop(); });
+        m_Threaded->renderThread = std::thread([this]() { RenderLoop(); });
+        std::cout << "Red Plasma Engine: Threaded mode started, simulation step "
+                  << settings.fixedStepSeconds * 1000.0 << " ms" << std::endl;
+        return 0;
+    }
+
+    void Engine::StopThreaded() {
+        if (m_Threaded == nullptr) {
+            return;
+        }
+        m_Threaded->running.store(false, std::memory_order_release);
+        m_Threaded->simulationThread.join();
+        m_Threaded->renderThread.join();
+        std::cout << "Red Plasma Engine: Threaded mode stopped, " << m_Threaded->queue.GetDroppedCount()
+                  << " snapshots dropped" << std::endl;
+        delete m_Threaded;
+        m_Threaded = nullptr;
+    }
+
+    void Engine::SimulationLoop() const {
+        ThreadedState& state = *m_Threaded;
+        const double stepSeconds = state.settings.fixedStepSeconds;
+        const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(stepSeconds));
+        const auto maxLag = step * std::max<uint32_t>(state.settings.maxCatchUpTicks, 1);
+
+        uint64_t tick = 0;
+        auto nextTick = state.start + step;
+        while (state.running.load(std::memory_order_acquire)) {
+            auto now = std::chrono::steady_clock::now();
+            if (now < nextTick) {
+                std::this_thread::sleep_until(nextTick);
+                continue;
+            }
+            // Skipped ticks still count, snapshot times have to stay on the same clock as the render thread.
+            if (now - nextTick > maxLag) {
+                auto skipped = (now - nextTick) / step;
+                tick += skipped;
+                nextTick += step * skipped;
+            }
+
+            tick++;
+            auto snapshot = std::make_shared<FrameSnapshot>();
+            snapshot->tick = tick;
+            snapshot->time = static_cast<double>(tick) * stepSeconds;
+            state.simulate(stepSeconds, *snapshot);
+            AppendWorldObjects(*m_World, *m_JobSystem, snapshot->objects);
+            state.queue.Push(std::move(snapshot));
+            nextTick += step;
+        }
+    }
+
+    void Engine::SubmitSnapshot(const FrameSnapshot& snapshot) const {
+        for (const RenderObject& object : snapshot.objects) {
+            m_GraphicsDevice->SubmitDraw(object.mesh, object.material, object.transform);
+        }
+    }
+
+    void Engine::SubmitWorld() const {
+        Query& query = m_World->CreateQuery<const LocalToWorld, const MeshRenderer>();
+        uint32_t draws = m_World->CountEntities(query);
+        // The caller kept the previous list, which already holds the world's draws as they were back then.
+        // Appending would duplicate them every frame, so the world is drawn as last submitted until the
+        // caller submits a fresh list again.
+        if (draws == 0 || m_GraphicsDevice->GetPendingDrawList() == PendingDrawList::Reused) {
+            return;
+        }
+
+        uint64_t transformVersion = m_World->GetComponentVersion(GetComponentId<LocalToWorld>());
+        uint64_t rendererVersion = m_World->GetComponentVersion(GetComponentId<MeshRenderer>());
+        // The previous list is only the world's if the last frame had no draws from anywhere else.
+        bool unchanged = transformVersion == m_SubmittedTransformVersion && rendererVersion == m_SubmittedRendererVersion
+            && draws == m_SubmittedWorldDraws && m_GraphicsDevice->GetFrameStats().submittedDraws == draws;
+        if (unchanged && m_GraphicsDevice->GetPendingDrawList() == PendingDrawList::None
+            && m_GraphicsDevice->ReuseLastDrawList() == 0) {
+            return;
+        }
+
+        m_World->ForEachChunk(query, [this](ChunkView& chunk) {
+            const LocalToWorld* transforms = chunk.Get<const LocalToWorld>();
+            const MeshRenderer* renderers = chunk.Get<const MeshRenderer>();
+            for (uint32_t i = 0; i < chunk.GetCount(); i++) {
+                m_GraphicsDevice->SubmitDraw(renderers[i].mesh, renderers[i].material, transforms[i].matrix.m);
+            }
+        });
+        m_SubmittedTransformVersion = transformVersion;
+        m_SubmittedRendererVersion = rendererVersion;
+        m_SubmittedWorldDraws = draws;
+    }
+
+    void Engine::RenderLoop() const {
+        ThreadedState& state = *m_Threaded;
+        std::shared_ptr<const FrameSnapshot> previous;
+        std::shared_ptr<const FrameSnapshot> next;
+        FrameSnapshot interpolated;
+
+        while (state.running.load(std::memory_order_acquire)) {
+            if (state.resizePending.exchange(false, std::memory_order_acq_rel)) {
+                m_GraphicsDevice->OnSurfaceResized();
+            }
+
+            // Render one step behind the simulation so the render time normally has a snapshot on both sides.
+            double renderTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - state.start).count()
+                - state.settings.fixedStepSeconds;
+            while (next == nullptr || next->time <= renderTime) {
+                std::shared_ptr<const FrameSnapshot> snapshot = state.queue.TryPop();
+                if (snapshot == nullptr) {
+                    break;
+                }
+                previous = std::move(next);
+                next = std::move(snapshot);
+            }
+
+            if (next != nullptr) {
+                const FrameSnapshot* current = next.get();
+                if (previous != nullptr) {
+                    double span = next->time - previous->time;
+                    auto alpha = static_cast<float>(std::clamp((renderTime - previous->time) / span, 0.0, 1.0));
+                    InterpolateSnapshots(*previous, *next, alpha, interpolated);
+                    current = &interpolated;
+                }
+                if (state.render) {
+                    state.render(*current);
+                }
+                // A scene that did not move since the last frame is drawn from the device's previous list,
+                // which skips the sort and usually the command recording as well.
+                if (!SameObjects(current->objects, state.submittedObjects) || m_GraphicsDevice->ReuseLastDrawList() != 0) {
+                    SubmitSnapshot(*current);
+                    state.submittedObjects = current->objects;
+                }
+            }
+
+            m_GraphicsDevice->DrawFrame();
+            m_JobSystem->NotifyFrameCompleted(m_GraphicsDevice->GetCompletedFrameNumber());
+
+            std::lock_guard<std::mutex> lock(state.statsMutex);
+            state.frameStats = m_GraphicsDevice->GetFrameStats();
+            state.gpuTimings = m_GraphicsDevice->GetGpuTimings();
+            state.memoryStats = m_GraphicsDevice->GetMemoryStats();
+        }
+    }
+
+    void Engine::OnWindowResized() {
+        if (!m_IsRunning) {
+            return;
+        }
+        if (m_Threaded != nullptr) {
+            m_Threaded->resizePending.store(true, std::memory_order_release);
+        } else {
+            m_GraphicsDevice->OnSurfaceResized();
+        }
+    }
+
+    FrameStats Engine::GetFrameStats() const {
+        if (m_Threaded != nullptr) {
+            std::lock_guard<std::mutex> lock(m_Threaded->statsMutex);
+            return m_Threaded->frameStats;
+        }
+        return m_GraphicsDevice->GetFrameStats();
+    }
+
+    std::vector<GpuZoneTiming> Engine::GetGpuTimings() const {
+        if (m_Threaded != nullptr) {
+            std::lock_guard<std::mutex> lock(m_Threaded->statsMutex);
+            return m_Threaded->gpuTimings;
+        }
+        return m_GraphicsDevice->GetGpuTimings();
+    }
+
+    GpuMemoryStats Engine::GetMemoryStats() const {
+        if (m_Threaded != nullptr) {
+            std::lock_guard<std::mutex> lock(m_Threaded->statsMutex);
+            return m_Threaded->memoryStats;
+        }
+        return m_GraphicsDevice->GetMemoryStats();
+    }
+
+    const char* Engine::GetDeviceName() const {
+        return m_GraphicsDevice->GetDeviceName();
+    }
+
+    int Engine::LoadMesh(const char* path) const {
+        MappedMesh mesh;
+        int result = mesh.Open(path);
+        if (result != 0) {
+            return result;
+        }
+        // The staging copy is the only one, the mapping is released once the data is in the ring.
+        return m_GraphicsDevice->UploadMeshData(mesh.GetVertices(), mesh.GetVertexCount(), mesh.GetIndices(), mesh.GetIndexCount());
+    }
+
+    int Engine::ReadbackFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) const {
+        // The render thread owns the readback target while the threaded mode runs.
+        if (!m_IsRunning || m_Threaded != nullptr) {
+            return -1;
         }
+        return m_GraphicsDevice->ReadbackFrame(pixels, width, height);
     }
 
     void Engine::Shutdown() {
+        StopThreaded();
+        // Jobs waiting for a frame usually release GPU resources, let them run before the device goes away.
+        m_GraphicsDevice->WaitIdle();
+        m_JobSystem->NotifyFrameCompleted(UINT64_MAX);
+        m_JobSystem->Shutdown();
         m_GraphicsDevice->Shutdown();
     }
 }
@@ -13,22 +13,89 @@
 
 #ifndef REDPLASMA_ENGINE_H
 #define REDPLASMA_ENGINE_H
+#include <cstdint>
+#include <functional>
+#include <vector>
+
 namespace RedPlasma {
     class IWindowSurface;
     class IGraphicsDevice;
+    class JobSystem;
+    class World;
     struct NativeWindowHandle;
+    struct GraphicsDeviceSettings;
+    struct FrameStats;
+    struct GpuZoneTiming;
+    struct GpuMemoryStats;
+    struct FrameSnapshot;
+
+    struct ThreadedModeSettings {
+        double fixedStepSeconds = 1.0 / 60.0;
+        // Snapshots waiting for the render thread, the oldest one is dropped when the renderer falls behind.
+        uint32_t maxQueuedSnapshots = 3;
+        // After a longer stall the simulation skips ahead instead of running every missed tick back to back.
+        uint32_t maxCatchUpTicks = 5;
+    };
+
+    // Runs on the simulation thread once per fixed step and fills a fresh snapshot.
+    using SimulationCallback = std::function<void(double stepSeconds, FrameSnapshot& snapshot)>;
+    // Runs on the render thread before every frame with the snapshot interpolated to the render time. The snapshot's
+    // objects are submitted as draws once it returns, so it only has to set the camera and add draws of its own.
+    using RenderCallback = std::function<void(const FrameSnapshot& snapshot)>;
 
     class Engine {
     public:
         Engine();
         ~Engine();
 
+        // Has to be called before AttachWindow(), the settings are consumed when the device initializes.
+        void Configure(const GraphicsDeviceSettings& settings);
         int AttachWindow(IWindowSurface* windowHandle);
+        // Renders one frame, in threaded mode only the main thread jobs run here.
         void Run() const;
+        // Moves rendering to its own thread fed by a simulation thread on a fixed timestep, so a stalled GPU
+        // no longer blocks the caller's event loop. Keep calling Run() from the main thread.
+        int StartThreaded(const ThreadedModeSettings& settings, SimulationCallback simulate, RenderCallback render = nullptr);
+        void StopThreaded();
+        [[nodiscard]] bool IsThreaded() const { return m_Threaded != nullptr; }
+        // Call after the attached surface reported its new size.
+        void OnWindowResized();
+        // Copies, in threaded mode they are taken from the last frame the render thread finished.
+        [[nodiscard]] FrameStats GetFrameStats() const;
+        [[nodiscard]] std::vector<GpuZoneTiming> GetGpuTimings() const;
+        [[nodiscard]] GpuMemoryStats GetMemoryStats() const;
+        [[nodiscard]] const char* GetDeviceName() const;
+        // Direct access for tools that need backend controls (present mode, ...).
+        [[nodiscard]] IGraphicsDevice* GetGraphicsDevice() const { return m_GraphicsDevice; }
+        // Shared scheduler for all parallel engine work, jobs bound to a frame are released from Run().
+        [[nodiscard]] JobSystem& GetJobSystem() const { return *m_JobSystem; }
+        // Entities with LocalToWorld and MeshRenderer (ecs/SceneComponents.h) are drawn every frame. The world
+        // belongs to the thread calling Run(), or to the simulation callback while the threaded mode runs.
+        // A frame that reuses the device's last draw list before Run() shows the world as it was submitted then.
+        [[nodiscard]] World& GetWorld() const { return *m_World; }
+        // Maps a cooked mesh file (see assets/MeshFile.h) and uploads it straight from the mapping.
+        // Returns a mesh handle or a negative error. Safe from any thread, like the device's mesh uploads.
+        int LoadMesh(const char* path) const;
+        int ReadbackFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) const;
         void Shutdown();
     private:
+        struct ThreadedState;
+
+        void SimulationLoop() const;
+        void RenderLoop() const;
+        void SubmitSnapshot(const FrameSnapshot& snapshot) const;
+        void SubmitWorld() const;
+
         bool m_IsRunning;
         IGraphicsDevice* m_GraphicsDevice;
+        JobSystem* m_JobSystem;
+        ThreadedState* m_Threaded;
+        World* m_World;
+        // Component versions and draw count of the world's last submission, a frame where none of them changed
+        // reuses the device's previous draw list.
+        mutable uint64_t m_SubmittedTransformVersion;
+        mutable uint64_t m_SubmittedRendererVersion;
+        mutable uint32_t m_SubmittedWorldDraws;
 
     };
 }
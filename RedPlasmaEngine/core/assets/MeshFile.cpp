@@ -0,0 +1,273 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RedPlasma {
+    static_assert(std::endian::native == std::endian::little, "Cooked meshes are little endian and used in place");
+
+    namespace {
+        struct SectionSource {
+            MeshSection type;
+            uint32_t stride;
+            const void* data;
+            uint64_t size;
+        };
+
+        uint64_t AlignUp(uint64_t value) {
+            return (value + MeshFileAlignment - 1) & ~static_cast<uint64_t>(MeshFileAlignment - 1);
+        }
+
+        bool IsSectionValid(const MeshFileSection& section, uint64_t fileSize) {
+            return section.stride != 0
+                && section.offset % MeshFileAlignment == 0
+                && section.offset <= fileSize
+                && section.size <= fileSize - section.offset
+                && section.size % section.stride == 0;
+        }
+
+        // One pass with a running maximum instead of a branch per index, cheap next to uploading the data.
+        template<typename T>
+        bool AreIndicesBelow(const T* indices, uint64_t count, uint32_t limit) {
+            uint32_t largest = 0;
+            for (uint64_t i = 0; i < count; i++) {
+                largest = std::max<uint32_t>(largest, indices[i]);
+            }
+            return count == 0 || largest < limit;
+        }
+    }
+
+    MappedMesh::~MappedMesh() {
+        Close();
+    }
+
+    int MappedMesh::Open(const char* path) {
+        Close();
+
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            std::cout << "[Assets] Failed to open mesh " << path << std::endl;
+            return -1;
+        }
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(MeshFileHeader))) {
+            std::cout << "[Assets] " << path << " is not a mesh file" << std::endl;
+            close(fd);
+            return -2;
+        }
+
+        size_t size = static_cast<size_t>(info.st_size);
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping keeps its own reference to the file.
+        close(fd);
+        if (data == MAP_FAILED) {
+            std::cout << "[Assets] Failed to map mesh " << path << std::endl;
+            return -1;
+        }
+        // The whole file is read right after for the upload, start paging it in now.
+        madvise(data, size, MADV_WILLNEED);
+        m_Data = data;
+        m_Size = size;
+
+        const MeshFileHeader& header = GetHeader();
+        uint64_t tableEnd = sizeof(MeshFileHeader) + static_cast<uint64_t>(header.sectionCount) * sizeof(MeshFileSection);
+        if (header.magic != MeshFileMagic || header.version != MeshFileVersion || header.fileSize != size || tableEnd > size) {
+            std::cout << "[Assets] " << path << " is not a mesh file of version " << MeshFileVersion << std::endl;
+            Close();
+            return -2;
+        }
+
+        const auto* sections = reinterpret_cast<const MeshFileSection*>(static_cast<const uint8_t*>(m_Data) + sizeof(MeshFileHeader));
+        for (uint32_t i = 0; i < header.sectionCount; i++) {
+            if (!IsSectionValid(sections[i], size)) {
+                std::cout << "[Assets] " << path << " has a broken section table" << std::endl;
+                Close();
+                return -2;
+            }
+        }
+
+        const MeshFileSection* vertices = FindSection(MeshSection::Vertices);
+        const MeshFileSection* indices = FindSection(MeshSection::Indices);
+        if (!vertices || !indices || vertices->stride != sizeof(Vertex) || indices->stride != sizeof(uint32_t)) {
+            std::cout << "[Assets] " << path << " has no usable geometry" << std::endl;
+            Close();
+            return -2;
+        }
+        m_Vertices = static_cast<const Vertex*>(GetSectionData(*vertices));
+        m_VertexCount = static_cast<uint32_t>(vertices->size / vertices->stride);
+        m_Indices = static_cast<const uint32_t*>(GetSectionData(*indices));
+        m_IndexCount = static_cast<uint32_t>(indices->size / indices->stride);
+        // The indices go to the GPU as they are, one out of range would read another mesh's vertices or past the
+        // shared vertex buffer.
+        if (m_IndexCount % 3 != 0 || !AreIndicesBelow(m_Indices, m_IndexCount, m_VertexCount)) {
+            std::cout << "[Assets] " << path << " has a broken index list" << std::endl;
+            Close();
+            return -2;
+        }
+
+        const MeshFileSection* quantized = FindSection(MeshSection::QuantizedVertices);
+        if (quantized) {
+            if (quantized->stride != sizeof(QuantizedVertex) || quantized->size / quantized->stride != m_VertexCount) {
+                std::cout << "[Assets] " << path << " has mismatched quantized vertices" << std::endl;
+                Close();
+                return -2;
+            }
+            m_QuantizedVertices = static_cast<const QuantizedVertex*>(GetSectionData(*quantized));
+        }
+
+        const MeshFileSection* meshlets = FindSection(MeshSection::Meshlets);
+        if (meshlets) {
+            const MeshFileSection* meshletVertices = FindSection(MeshSection::MeshletVertices);
+            const MeshFileSection* meshletTriangles = FindSection(MeshSection::MeshletTriangles);
+            if (!meshletVertices || !meshletTriangles || meshlets->stride != sizeof(MeshFileMeshlet)
+                || meshletVertices->stride != sizeof(uint32_t) || meshletTriangles->stride != sizeof(uint8_t)) {
+                std::cout << "[Assets] " << path << " has incomplete meshlets" << std::endl;
+                Close();
+                return -2;
+            }
+            m_Meshlets = static_cast<const MeshFileMeshlet*>(GetSectionData(*meshlets));
+            m_MeshletCount = static_cast<uint32_t>(meshlets->size / meshlets->stride);
+            m_MeshletVertices = static_cast<const uint32_t*>(GetSectionData(*meshletVertices));
+            m_MeshletTriangles = static_cast<const uint8_t*>(GetSectionData(*meshletTriangles));
+            // Meshlet vertices index the mesh's vertices, triangle bytes index the meshlet's own vertex list.
+            uint64_t vertexEntries = meshletVertices->size / sizeof(uint32_t);
+            bool valid = AreIndicesBelow(m_MeshletVertices, vertexEntries, m_VertexCount);
+            for (uint32_t i = 0; valid && i < m_MeshletCount; i++) {
+                const MeshFileMeshlet& meshlet = m_Meshlets[i];
+                valid = static_cast<uint64_t>(meshlet.vertexOffset) + meshlet.vertexCount <= vertexEntries
+                    && static_cast<uint64_t>(meshlet.triangleOffset) + meshlet.triangleCount * 3ull <= meshletTriangles->size
+                    && AreIndicesBelow(m_MeshletTriangles + meshlet.triangleOffset, meshlet.triangleCount * 3ull, meshlet.vertexCount);
+            }
+            if (!valid) {
+                std::cout << "[Assets] " << path << " has a meshlet out of range" << std::endl;
+                Close();
+                return -2;
+            }
+        }
+        return 0;
+    }
+
+    void MappedMesh::Close() {
+        if (m_Data) {
+            munmap(m_Data, m_Size);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Vertices = nullptr;
+        m_VertexCount = 0;
+        m_Indices = nullptr;
+        m_IndexCount = 0;
+        m_QuantizedVertices = nullptr;
+        m_Meshlets = nullptr;
+        m_MeshletCount = 0;
+        m_MeshletVertices = nullptr;
+        m_MeshletTriangles = nullptr;
+    }
+
+    const MeshFileSection* MappedMesh::FindSection(MeshSection type) const {
+        if (!m_Data) {
+            return nullptr;
+        }
+        const auto* sections = reinterpret_cast<const MeshFileSection*>(static_cast<const uint8_t*>(m_Data) + sizeof(MeshFileHeader));
+        for (uint32_t i = 0; i < GetHeader().sectionCount; i++) {
+            if (sections[i].type == static_cast<uint32_t>(type)) {
+                return &sections[i];
+            }
+        }
+        return nullptr;
+    }
+
+    const void* MappedMesh::GetSectionData(const MeshFileSection& section) const {
+        return static_cast<const uint8_t*>(m_Data) + section.offset;
+    }
+
+    void ComputeMeshBounds(const Vertex* vertices, uint32_t vertexCount, float boundsMin[3], float boundsMax[3]) {
+        for (int axis = 0; axis < 3; axis++) {
+            boundsMin[axis] = vertexCount > 0 ? std::numeric_limits<float>::max() : 0.0f;
+            boundsMax[axis] = vertexCount > 0 ? std::numeric_limits<float>::lowest() : 0.0f;
+        }
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            const float position[3] = {vertices[i].x, vertices[i].y, vertices[i].z};
+            for (int axis = 0; axis < 3; axis++) {
+                boundsMin[axis] = std::min(boundsMin[axis], position[axis]);
+                boundsMax[axis] = std::max(boundsMax[axis], position[axis]);
+            }
+        }
+    }
+
+    int WriteMeshFile(const char* path, const MeshFileContents& contents) {
+        std::vector<SectionSource> sources = {
+            {MeshSection::Vertices, sizeof(Vertex), contents.vertices, static_cast<uint64_t>(contents.vertexCount) * sizeof(Vertex)},
+            {MeshSection::Indices, sizeof(uint32_t), contents.indices, static_cast<uint64_t>(contents.indexCount) * sizeof(uint32_t)}
+        };
+        if (contents.quantizedVertices) {
+            sources.push_back({MeshSection::QuantizedVertices, sizeof(QuantizedVertex), contents.quantizedVertices,
+                               static_cast<uint64_t>(contents.vertexCount) * sizeof(QuantizedVertex)});
+        }
+        if (contents.meshletCount > 0) {
+            sources.push_back({MeshSection::Meshlets, sizeof(MeshFileMeshlet), contents.meshlets,
+                               static_cast<uint64_t>(contents.meshletCount) * sizeof(MeshFileMeshlet)});
+            sources.push_back({MeshSection::MeshletVertices, sizeof(uint32_t), contents.meshletVertices,
+                               static_cast<uint64_t>(contents.meshletVertexCount) * sizeof(uint32_t)});
+            sources.push_back({MeshSection::MeshletTriangles, sizeof(uint8_t), contents.meshletTriangles, contents.meshletTriangleBytes});
+        }
+
+        MeshFileHeader header {};
+        header.magic = MeshFileMagic;
+        header.version = MeshFileVersion;
+        header.sectionCount = static_cast<uint32_t>(sources.size());
+        ComputeMeshBounds(contents.vertices, contents.vertexCount, header.boundsMin, header.boundsMax);
+
+        std::vector<MeshFileSection> sections(sources.size());
+        uint64_t offset = AlignUp(sizeof(MeshFileHeader) + sources.size() * sizeof(MeshFileSection));
+        for (size_t i = 0; i < sources.size(); i++) {
+            sections[i] = {static_cast<uint32_t>(sources[i].type), sources[i].stride, offset, sources[i].size};
+            offset = AlignUp(offset + sources[i].size);
+        }
+        header.fileSize = offset;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cout << "[Assets] Failed to create " << path << std::endl;
+            return -1;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(sections.data()), static_cast<std::streamsize>(sections.size() * sizeof(MeshFileSection)));
+        const char padding[MeshFileAlignment] = {};
+        for (size_t i = 0; i < sources.size(); i++) {
+            auto position = static_cast<uint64_t>(file.tellp());
+            file.write(padding, static_cast<std::streamsize>(sections[i].offset - position));
+            file.write(static_cast<const char*>(sources[i].data), static_cast<std::streamsize>(sources[i].size));
+        }
+        auto position = static_cast<uint64_t>(file.tellp());
+        file.write(padding, static_cast<std::streamsize>(header.fileSize - position));
+        if (!file) {
+            std::cout << "[Assets] Failed to write " << path << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+}
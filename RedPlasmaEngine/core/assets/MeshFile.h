@@ -0,0 +1,147 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_MESHFILE_H
+#define REDPLASMA_MESHFILE_H
+#include <cstddef>
+#include <cstdint>
+
+#include "renderer/IGraphicsDevice.h"
+
+namespace RedPlasma {
+    // Cooked mesh container (.rpmesh). Little endian, a header followed by a section table, every section
+    // starts on a MeshFileAlignment boundary so the data can be used in place once the file is mapped.
+    // Readers skip section types they do not know, incompatible layout changes bump the version.
+    constexpr uint32_t MeshFileMagic = 0x48534D52; // "RMSH"
+    constexpr uint32_t MeshFileVersion = 1;
+    constexpr uint32_t MeshFileAlignment = 16;
+
+    enum class MeshSection : uint32_t {
+        Vertices = 1,           // Vertex[]
+        Indices = 2,            // uint32_t[], triangle list
+        QuantizedVertices = 3,  // QuantizedVertex[], same count and order as Vertices
+        Meshlets = 4,           // MeshFileMeshlet[]
+        MeshletVertices = 5,    // uint32_t[], indices into the vertex sections
+        MeshletTriangles = 6    // uint8_t[], three indices into the meshlet's vertices per triangle
+    };
+
+    struct MeshFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t sectionCount;
+        uint32_t flags;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint64_t fileSize;
+    };
+    static_assert(sizeof(MeshFileHeader) == 48);
+
+    struct MeshFileSection {
+        uint32_t type;
+        // Size of one element, the section holds size / stride of them.
+        uint32_t stride;
+        uint64_t offset;
+        uint64_t size;
+    };
+    static_assert(sizeof(MeshFileSection) == 24);
+
+    // Positions as 16 bit unorm relative to the header bounds: boundsMin + q / 65535 * (boundsMax - boundsMin).
+    // The normal is octahedral encoded as two snorm8.
+    struct QuantizedVertex {
+        uint16_t position[3];
+        int8_t normal[2];
+    };
+    static_assert(sizeof(QuantizedVertex) == 8);
+
+    // A small cluster of triangles that can be culled as a whole. It uses meshletVertices[vertexOffset, + vertexCount)
+    // and meshletTriangles[triangleOffset, + triangleCount * 3). All of its triangles face away from a viewer at
+    // position p when dot(center - p, coneAxis) >= coneCutoff * length(center - p) + radius, a cutoff of 1 never
+    // passes the test.
+    struct MeshFileMeshlet {
+        uint32_t vertexOffset;
+        uint32_t triangleOffset;
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+        float center[3];
+        float radius;
+        float coneAxis[3];
+        float coneCutoff;
+    };
+    static_assert(sizeof(MeshFileMeshlet) == 48);
+
+    // Everything a cooked mesh can hold, the optional parts are left empty (null / 0) to skip their section.
+    struct MeshFileContents {
+        const Vertex* vertices = nullptr;
+        uint32_t vertexCount = 0;
+        const uint32_t* indices = nullptr;
+        uint32_t indexCount = 0;
+        // vertexCount entries.
+        const QuantizedVertex* quantizedVertices = nullptr;
+        const MeshFileMeshlet* meshlets = nullptr;
+        uint32_t meshletCount = 0;
+        const uint32_t* meshletVertices = nullptr;
+        uint32_t meshletVertexCount = 0;
+        const uint8_t* meshletTriangles = nullptr;
+        uint32_t meshletTriangleBytes = 0;
+    };
+
+    // Read only view of a cooked mesh. The file is mapped as a whole and the getters point into the mapping,
+    // nothing is copied or parsed beyond the header and the section table.
+    class MappedMesh {
+    public:
+        MappedMesh() = default;
+        ~MappedMesh();
+        MappedMesh(const MappedMesh&) = delete;
+        MappedMesh& operator=(const MappedMesh&) = delete;
+
+        // Returns 0 or a negative error, -1 when the file can't be mapped, -2 when it isn't a valid mesh file.
+        int Open(const char* path);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return m_Data != nullptr; }
+        [[nodiscard]] const MeshFileHeader& GetHeader() const { return *static_cast<const MeshFileHeader*>(m_Data); }
+        // Returns nullptr when the file has no such section.
+        [[nodiscard]] const MeshFileSection* FindSection(MeshSection type) const;
+        [[nodiscard]] const void* GetSectionData(const MeshFileSection& section) const;
+
+        [[nodiscard]] const Vertex* GetVertices() const { return m_Vertices; }
+        [[nodiscard]] uint32_t GetVertexCount() const { return m_VertexCount; }
+        [[nodiscard]] const uint32_t* GetIndices() const { return m_Indices; }
+        [[nodiscard]] uint32_t GetIndexCount() const { return m_IndexCount; }
+        // The optional sections, nullptr / 0 when the mesh was cooked without them.
+        [[nodiscard]] const QuantizedVertex* GetQuantizedVertices() const { return m_QuantizedVertices; }
+        [[nodiscard]] const MeshFileMeshlet* GetMeshlets() const { return m_Meshlets; }
+        [[nodiscard]] uint32_t GetMeshletCount() const { return m_MeshletCount; }
+        [[nodiscard]] const uint32_t* GetMeshletVertices() const { return m_MeshletVertices; }
+        [[nodiscard]] const uint8_t* GetMeshletTriangles() const { return m_MeshletTriangles; }
+
+    private:
+        void* m_Data = nullptr;
+        size_t m_Size = 0;
+        const Vertex* m_Vertices = nullptr;
+        uint32_t m_VertexCount = 0;
+        const uint32_t* m_Indices = nullptr;
+        uint32_t m_IndexCount = 0;
+        const QuantizedVertex* m_QuantizedVertices = nullptr;
+        const MeshFileMeshlet* m_Meshlets = nullptr;
+        uint32_t m_MeshletCount = 0;
+        const uint32_t* m_MeshletVertices = nullptr;
+        const uint8_t* m_MeshletTriangles = nullptr;
+    };
+
+    // Box around the vertices, all zero without any. This is the box stored in the header and quantized against.
+    void ComputeMeshBounds(const Vertex* vertices, uint32_t vertexCount, float boundsMin[3], float boundsMax[3]);
+    // Writes a cooked mesh, the bounds are computed from the vertices. Returns 0 or -1 when the file can't be written.
+    int WriteMeshFile(const char* path, const MeshFileContents& contents);
+}
+#endif //REDPLASMA_MESHFILE_H
\ No newline at end of file
@@ -0,0 +1,66 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "Component.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+namespace RedPlasma {
+    namespace {
+        std::mutex& GetRegistryMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::vector<ComponentInfo>& GetComponents() {
+            static std::vector<ComponentInfo> components = [] {
+                std::vector<ComponentInfo> reserved;
+                // Never reallocated, so references handed out by GetInfo() stay valid.
+                reserved.reserve(MaxComponents);
+                return reserved;
+            }();
+            return components;
+        }
+    }
+
+    ComponentId ComponentRegistry::Register(const char* name, uint32_t size, uint32_t alignment, const void* defaultValue) {
+        std::lock_guard<std::mutex> lock(GetRegistryMutex());
+        std::vector<ComponentInfo>& components = GetComponents();
+        for (size_t i = 0; i < components.size(); i++) {
+            if (std::strcmp(components[i].name, name) == 0) {
+                return static_cast<ComponentId>(i);
+            }
+        }
+        if (components.size() >= MaxComponents) {
+            std::cout << "[ECS] Too many component types, " << name << " does not fit into " << MaxComponents << std::endl;
+            std::abort();
+        }
+
+        ComponentInfo info;
+        info.name = name;
+        info.size = size;
+        info.alignment = alignment;
+        info.defaultValue.resize(size);
+        std::memcpy(info.defaultValue.data(), defaultValue, size);
+        components.push_back(std::move(info));
+        return static_cast<ComponentId>(components.size() - 1);
+    }
+
+    const ComponentInfo& ComponentRegistry::GetInfo(ComponentId id) {
+        std::lock_guard<std::mutex> lock(GetRegistryMutex());
+        return GetComponents()[id];
+    }
+}
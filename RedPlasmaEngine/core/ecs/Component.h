@@ -0,0 +1,64 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_COMPONENT_H
+#define REDPLASMA_COMPONENT_H
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+namespace RedPlasma {
+    using ComponentId = uint32_t;
+    // One bit per component type, an archetype is the set of components its entities have.
+    using ComponentMask = uint64_t;
+    constexpr uint32_t MaxComponents = 64;
+
+    struct ComponentInfo {
+        const char* name = nullptr;
+        uint32_t size = 0;
+        uint32_t alignment = 0;
+        // A default constructed value, new components start as a copy of it.
+        std::vector<std::byte> defaultValue;
+    };
+
+    // Process wide list of component types, filled the first time a type is used. Types are matched by their
+    // type name, so every module agrees on the ids.
+    class ComponentRegistry {
+    public:
+        // Returns the id of the type, registering it on first use. Running out of ids is a programming error
+        // that aborts, there is no sensible way to continue without the component.
+        static ComponentId Register(const char* name, uint32_t size, uint32_t alignment, const void* defaultValue);
+        static const ComponentInfo& GetInfo(ComponentId id);
+    };
+
+    // Components are plain data: they are moved between chunks with memcpy and never destructed.
+    template<typename T>
+    ComponentId GetComponentId() {
+        using Type = std::remove_cv_t<T>;
+        static_assert(std::is_trivially_copyable_v<Type> && std::is_trivially_destructible_v<Type>, "Components have to be plain data");
+        static_assert(std::is_default_constructible_v<Type>, "Components need a default value");
+        static const ComponentId id = [] {
+            const Type defaultValue {};
+            return ComponentRegistry::Register(typeid(Type).name(), sizeof(Type), alignof(Type), &defaultValue);
+        }();
+        return id;
+    }
+
+    template<typename... Ts>
+    ComponentMask GetComponentMask() {
+        return (ComponentMask{0} | ... | (ComponentMask{1} << GetComponentId<Ts>()));
+    }
+}
+#endif //REDPLASMA_COMPONENT_H
\ No newline at end of file
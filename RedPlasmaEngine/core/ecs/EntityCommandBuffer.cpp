@@ -0,0 +1,100 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "EntityCommandBuffer.h"
+
+#include <cstring>
+
+namespace RedPlasma {
+    void EntityCommandBuffer::DestroyEntity(Entity entity) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Command command;
+        command.type = CommandType::Destroy;
+        command.entity = entity;
+        m_Commands.push_back(command);
+    }
+
+    void EntityCommandBuffer::AddComponent(Entity entity, ComponentId component, const void* value, uint32_t size) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Command command;
+        command.type = CommandType::AddComponent;
+        command.entity = entity;
+        command.component = component;
+        command.valueOffset = AppendValue(component, value, size);
+        m_Commands.push_back(command);
+    }
+
+    void EntityCommandBuffer::RemoveComponent(Entity entity, ComponentId component) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Command command;
+        command.type = CommandType::RemoveComponent;
+        command.entity = entity;
+        command.component = component;
+        m_Commands.push_back(command);
+    }
+
+    uint32_t EntityCommandBuffer::Playback(World& world) {
+        std::vector<Command> commands;
+        std::vector<std::byte> values;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            commands.swap(m_Commands);
+            values.swap(m_Values);
+        }
+
+        uint32_t skipped = 0;
+        for (const Command& command : commands) {
+            int result = 0;
+            switch (command.type) {
+                case CommandType::Create: {
+                    Entity entity = world.CreateEntity(command.mask);
+                    size_t offset = command.valueOffset;
+                    for (uint32_t i = 0; i < command.component; i++) {
+                        ValueHeader header;
+                        std::memcpy(&header, values.data() + offset, sizeof(header));
+                        std::memcpy(world.GetComponentData(entity, header.component), values.data() + offset + sizeof(header), header.size);
+                        offset += sizeof(header) + header.size;
+                    }
+                    break;
+                }
+                case CommandType::Destroy:
+                    result = world.DestroyEntity(command.entity);
+                    break;
+                case CommandType::AddComponent:
+                    result = world.AddComponent(command.entity, command.component, values.data() + command.valueOffset + sizeof(ValueHeader));
+                    break;
+                case CommandType::RemoveComponent:
+                    result = world.RemoveComponent(command.entity, command.component);
+                    break;
+            }
+            if (result != 0) {
+                skipped++;
+            }
+        }
+        return skipped;
+    }
+
+    bool EntityCommandBuffer::IsEmpty() const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Commands.empty();
+    }
+
+    size_t EntityCommandBuffer::AppendValue(ComponentId component, const void* value, uint32_t size) {
+        size_t offset = m_Values.size();
+        ValueHeader header {component, size};
+        m_Values.resize(offset + sizeof(header) + size);
+        std::memcpy(m_Values.data() + offset, &header, sizeof(header));
+        std::memcpy(m_Values.data() + offset + sizeof(header), value, size);
+        return offset;
+    }
+}
@@ -0,0 +1,87 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_ENTITYCOMMANDBUFFER_H
+#define REDPLASMA_ENTITYCOMMANDBUFFER_H
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "World.h"
+
+namespace RedPlasma {
+    // Structural changes recorded while the world is being iterated, applied later in recording order by
+    // Playback(). Recording is thread safe, so jobs running over chunks can share one buffer.
+    class EntityCommandBuffer {
+    public:
+        // The entity does not exist before playback, the values are copied when recording.
+        template<typename... Ts>
+        void CreateEntity(const Ts&... components);
+        void DestroyEntity(Entity entity);
+        template<typename T>
+        void AddComponent(Entity entity, const T& value) { AddComponent(entity, GetComponentId<T>(), &value, sizeof(T)); }
+        template<typename T>
+        void RemoveComponent(Entity entity) { RemoveComponent(entity, GetComponentId<T>()); }
+
+        void AddComponent(Entity entity, ComponentId component, const void* value, uint32_t size);
+        void RemoveComponent(Entity entity, ComponentId component);
+
+        // Applies and clears the recorded commands. Commands on entities that are gone by then are skipped,
+        // returns how many of them were.
+        uint32_t Playback(World& world);
+        [[nodiscard]] bool IsEmpty() const;
+
+    private:
+        enum class CommandType : uint8_t {
+            Create,
+            Destroy,
+            AddComponent,
+            RemoveComponent
+        };
+
+        struct Command {
+            CommandType type;
+            Entity entity;
+            ComponentMask mask = 0;
+            // Component of Add/RemoveComponent, for Create the number of values that follow in m_Values.
+            ComponentId component = 0;
+            size_t valueOffset = 0;
+        };
+
+        // Each value is stored as a ValueHeader followed by the component's bytes.
+        struct ValueHeader {
+            ComponentId component;
+            uint32_t size;
+        };
+
+        size_t AppendValue(ComponentId component, const void* value, uint32_t size);
+
+        mutable std::mutex m_Mutex;
+        std::vector<Command> m_Commands;
+        std::vector<std::byte> m_Values;
+    };
+
+    template<typename... Ts>
+    void EntityCommandBuffer::CreateEntity(const Ts&... components) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Command command;
+        command.type = CommandType::Create;
+        command.mask = GetComponentMask<Ts...>();
+        command.component = sizeof...(Ts);
+        command.valueOffset = m_Values.size();
+        (AppendValue(GetComponentId<Ts>(), &components, sizeof(Ts)), ...);
+        m_Commands.push_back(command);
+    }
+}
+#endif //REDPLASMA_ENTITYCOMMANDBUFFER_H
\ No newline at end of file
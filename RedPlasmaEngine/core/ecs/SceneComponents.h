@@ -0,0 +1,30 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_SCENECOMPONENTS_H
+#define REDPLASMA_SCENECOMPONENTS_H
+#include "math/Matrix.h"
+
+namespace RedPlasma {
+    // Components the engine itself reads. Every entity with both is drawn each frame.
+    struct LocalToWorld {
+        Mat4 matrix;
+    };
+
+    struct MeshRenderer {
+        int mesh = 0;
+        // 0 is the device's default material.
+        int material = 0;
+    };
+}
+#endif //REDPLASMA_SCENECOMPONENTS_H
\ No newline at end of file
@@ -0,0 +1,336 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "World.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include "jobs/JobSystem.h"
+
+namespace RedPlasma {
+    namespace {
+        uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        // Lays the arrays out for `capacity` rows and returns the bytes used. `alignments` holds the array
+        // alignment of every component.
+        uint32_t LayoutChunk(Archetype& archetype, const std::array<uint32_t, MaxComponents>& alignments, uint32_t capacity) {
+            archetype.entityOffset = 0;
+            uint32_t offset = capacity * static_cast<uint32_t>(sizeof(Entity));
+            for (ComponentId component : archetype.components) {
+                offset = AlignUp(offset, alignments[component]);
+                archetype.offsets[component] = offset;
+                offset += capacity * archetype.sizes[component];
+            }
+            return offset;
+        }
+
+        std::byte* GetRow(const Archetype& archetype, const Chunk& chunk, ComponentId component, uint32_t row) {
+            return chunk.memory->bytes + archetype.offsets[component] + static_cast<size_t>(row) * archetype.sizes[component];
+        }
+
+        Entity* GetEntities(const Archetype& archetype, const Chunk& chunk) {
+            return reinterpret_cast<Entity*>(chunk.memory->bytes + archetype.entityOffset);
+        }
+    }
+
+    World::World() = default;
+
+    World::~World() = default;
+
+    Entity World::CreateEntity(ComponentMask components) {
+        uint32_t index;
+        if (!m_FreeIndices.empty()) {
+            index = m_FreeIndices.back();
+            m_FreeIndices.pop_back();
+        } else {
+            index = static_cast<uint32_t>(m_Records.size());
+            m_Records.emplace_back();
+        }
+
+        Archetype& archetype = GetOrCreateArchetype(components);
+        EntityRecord& record = m_Records[index];
+        record.archetype = &archetype;
+        AllocateRow(archetype, record.chunk, record.row);
+
+        Entity entity {index, record.generation};
+        Chunk& chunk = archetype.chunks[record.chunk];
+        GetEntities(archetype, chunk)[record.row] = entity;
+        for (ComponentId component : archetype.components) {
+            std::memcpy(GetRow(archetype, chunk, component, record.row), archetype.defaultValues[component], archetype.sizes[component]);
+        }
+        MarkArchetypeWritten(archetype);
+        m_EntityCount++;
+        return entity;
+    }
+
+    int World::DestroyEntity(Entity entity) {
+        if (!IsAlive(entity)) {
+            return -1;
+        }
+        EntityRecord& record = m_Records[entity.index];
+        Archetype& archetype = *record.archetype;
+        FreeRow(archetype, record.chunk, record.row);
+        MarkArchetypeWritten(archetype);
+
+        record.archetype = nullptr;
+        record.generation++;
+        if (record.generation == 0) {
+            record.generation = 1;
+        }
+        m_FreeIndices.push_back(entity.index);
+        m_EntityCount--;
+        return 0;
+    }
+
+    bool World::IsAlive(Entity entity) const {
+        return FindRecord(entity) != nullptr;
+    }
+
+    int World::AddComponent(Entity entity, ComponentId component, const void* value) {
+        if (!IsAlive(entity)) {
+            return -1;
+        }
+        EntityRecord& record = m_Records[entity.index];
+        Archetype& from = *record.archetype;
+        if ((from.mask >> component) & 1u) {
+            const void* source = value != nullptr ? value : from.defaultValues[component];
+            std::memcpy(GetRow(from, from.chunks[record.chunk], component, record.row), source, from.sizes[component]);
+            MarkWritten(component);
+            return 0;
+        }
+
+        Archetype& to = GetOrCreateArchetype(from.mask | (ComponentMask{1} << component));
+        uint32_t chunk;
+        uint32_t row;
+        AllocateRow(to, chunk, row);
+        Chunk& fromChunk = from.chunks[record.chunk];
+        Chunk& toChunk = to.chunks[chunk];
+        GetEntities(to, toChunk)[row] = entity;
+        for (ComponentId shared : from.components) {
+            std::memcpy(GetRow(to, toChunk, shared, row), GetRow(from, fromChunk, shared, record.row), to.sizes[shared]);
+        }
+        const void* source = value != nullptr ? value : to.defaultValues[component];
+        std::memcpy(GetRow(to, toChunk, component, row), source, to.sizes[component]);
+
+        FreeRow(from, record.chunk, record.row);
+        record.archetype = &to;
+        record.chunk = chunk;
+        record.row = row;
+        MarkArchetypeWritten(to);
+        return 0;
+    }
+
+    int World::RemoveComponent(Entity entity, ComponentId component) {
+        if (!IsAlive(entity)) {
+            return -1;
+        }
+        EntityRecord& record = m_Records[entity.index];
+        Archetype& from = *record.archetype;
+        if (((from.mask >> component) & 1u) == 0) {
+            return 0;
+        }
+
+        Archetype& to = GetOrCreateArchetype(from.mask & ~(ComponentMask{1} << component));
+        uint32_t chunk;
+        uint32_t row;
+        AllocateRow(to, chunk, row);
+        Chunk& fromChunk = from.chunks[record.chunk];
+        Chunk& toChunk = to.chunks[chunk];
+        GetEntities(to, toChunk)[row] = entity;
+        for (ComponentId shared : to.components) {
+            std::memcpy(GetRow(to, toChunk, shared, row), GetRow(from, fromChunk, shared, record.row), to.sizes[shared]);
+        }
+
+        FreeRow(from, record.chunk, record.row);
+        record.archetype = &to;
+        record.chunk = chunk;
+        record.row = row;
+        MarkArchetypeWritten(from);
+        return 0;
+    }
+
+    void* World::GetComponentData(Entity entity, ComponentId component) {
+        const EntityRecord* record = FindRecord(entity);
+        if (record == nullptr || ((record->archetype->mask >> component) & 1u) == 0) {
+            return nullptr;
+        }
+        MarkWritten(component);
+        return GetRow(*record->archetype, record->archetype->chunks[record->chunk], component, record->row);
+    }
+
+    const void* World::GetComponentData(Entity entity, ComponentId component) const {
+        const EntityRecord* record = FindRecord(entity);
+        if (record == nullptr || ((record->archetype->mask >> component) & 1u) == 0) {
+            return nullptr;
+        }
+        return GetRow(*record->archetype, record->archetype->chunks[record->chunk], component, record->row);
+    }
+
+    Query& World::CreateQuery(ComponentMask all, ComponentMask none) {
+        for (const std::unique_ptr<Query>& query : m_Queries) {
+            if (query->m_All == all && query->m_None == none) {
+                return *query;
+            }
+        }
+        auto query = std::make_unique<Query>();
+        query->m_All = all;
+        query->m_None = none;
+        m_Queries.push_back(std::move(query));
+        return *m_Queries.back();
+    }
+
+    uint32_t World::CountEntities(Query& query) {
+        UpdateQuery(query);
+        uint32_t count = 0;
+        for (const Archetype* archetype : query.m_Archetypes) {
+            count += archetype->entityCount;
+        }
+        return count;
+    }
+
+    void World::ForEachChunk(Query& query, const std::function<void(ChunkView& chunk)>& function) {
+        UpdateQuery(query);
+        uint32_t firstIndex = 0;
+        for (Archetype* archetype : query.m_Archetypes) {
+            for (Chunk& chunk : archetype->chunks) {
+                ChunkView view(*this, *archetype, chunk, firstIndex);
+                function(view);
+                firstIndex += chunk.count;
+            }
+        }
+    }
+
+    void World::ForEachChunkParallel(Query& query, JobSystem& jobSystem, uint32_t chunksPerJob, const std::function<void(ChunkView& chunk)>& function) {
+        UpdateQuery(query);
+        struct ChunkRef {
+            Archetype* archetype;
+            Chunk* chunk;
+            uint32_t firstIndex;
+        };
+        std::vector<ChunkRef> chunks;
+        uint32_t firstIndex = 0;
+        for (Archetype* archetype : query.m_Archetypes) {
+            for (Chunk& chunk : archetype->chunks) {
+                chunks.push_back({archetype, &chunk, firstIndex});
+                firstIndex += chunk.count;
+            }
+        }
+        jobSystem.ParallelFor(static_cast<uint32_t>(chunks.size()), std::max<uint32_t>(chunksPerJob, 1), [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                ChunkView view(*this, *chunks[i].archetype, *chunks[i].chunk, chunks[i].firstIndex);
+                function(view);
+            }
+        });
+    }
+
+    Archetype& World::GetOrCreateArchetype(ComponentMask mask) {
+        auto found = m_ArchetypesByMask.find(mask);
+        if (found != m_ArchetypesByMask.end()) {
+            return *found->second;
+        }
+
+        auto archetype = std::make_unique<Archetype>();
+        archetype->mask = mask;
+        // Arrays start at least 16 bytes aligned so kernels can load whole vectors from them.
+        std::array<uint32_t, MaxComponents> alignments {};
+        uint32_t rowBytes = sizeof(Entity);
+        for (ComponentId component = 0; component < MaxComponents; component++) {
+            if ((mask >> component) & 1u) {
+                const ComponentInfo& info = ComponentRegistry::GetInfo(component);
+                archetype->components.push_back(component);
+                archetype->sizes[component] = info.size;
+                archetype->defaultValues[component] = info.defaultValue.data();
+                alignments[component] = std::max<uint32_t>(info.alignment, 16);
+                rowBytes += info.size;
+            }
+        }
+        // Start from the unpadded estimate and shrink until the alignment padding fits as well.
+        uint32_t capacity = std::max<uint32_t>(ChunkBytes / rowBytes, 1);
+        while (capacity > 1 && LayoutChunk(*archetype, alignments, capacity) > ChunkBytes) {
+            capacity--;
+        }
+        if (LayoutChunk(*archetype, alignments, capacity) > ChunkBytes) {
+            std::cout << "[ECS] Archetype row of " << rowBytes << " bytes does not fit into a chunk" << std::endl;
+            std::abort();
+        }
+        archetype->capacity = capacity;
+
+        Archetype* result = archetype.get();
+        m_Archetypes.push_back(std::move(archetype));
+        m_ArchetypesByMask.emplace(mask, result);
+        return *result;
+    }
+
+    void World::UpdateQuery(Query& query) {
+        for (; query.m_CheckedArchetypes < m_Archetypes.size(); query.m_CheckedArchetypes++) {
+            Archetype* archetype = m_Archetypes[query.m_CheckedArchetypes].get();
+            if ((archetype->mask & query.m_All) == query.m_All && (archetype->mask & query.m_None) == 0) {
+                query.m_Archetypes.push_back(archetype);
+            }
+        }
+    }
+
+    void World::MarkArchetypeWritten(const Archetype& archetype) {
+        for (ComponentId component : archetype.components) {
+            MarkWritten(component);
+        }
+    }
+
+    void World::AllocateRow(Archetype& archetype, uint32_t& chunk, uint32_t& row) {
+        if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity) {
+            Chunk created;
+            // Not value initialized, every row is written before it is read.
+            created.memory.reset(new ChunkMemory);
+            archetype.chunks.push_back(std::move(created));
+        }
+        chunk = static_cast<uint32_t>(archetype.chunks.size() - 1);
+        row = archetype.chunks.back().count++;
+        archetype.entityCount++;
+    }
+
+    void World::FreeRow(Archetype& archetype, uint32_t chunk, uint32_t row) {
+        uint32_t lastChunk = static_cast<uint32_t>(archetype.chunks.size() - 1);
+        Chunk& last = archetype.chunks[lastChunk];
+        uint32_t lastRow = last.count - 1;
+        if (chunk != lastChunk || row != lastRow) {
+            Chunk& target = archetype.chunks[chunk];
+            Entity moved = GetEntities(archetype, last)[lastRow];
+            GetEntities(archetype, target)[row] = moved;
+            for (ComponentId component : archetype.components) {
+                std::memcpy(GetRow(archetype, target, component, row), GetRow(archetype, last, component, lastRow), archetype.sizes[component]);
+            }
+            m_Records[moved.index].chunk = chunk;
+            m_Records[moved.index].row = row;
+        }
+        last.count--;
+        if (last.count == 0) {
+            archetype.chunks.pop_back();
+        }
+        archetype.entityCount--;
+    }
+
+    const World::EntityRecord* World::FindRecord(Entity entity) const {
+        if (entity.index >= m_Records.size()) {
+            return nullptr;
+        }
+        const EntityRecord& record = m_Records[entity.index];
+        if (record.archetype == nullptr || record.generation != entity.generation) {
+            return nullptr;
+        }
+        return &record;
+    }
+}
@@ -0,0 +1,224 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_WORLD_H
+#define REDPLASMA_WORLD_H
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "Component.h"
+
+namespace RedPlasma {
+    class JobSystem;
+    class World;
+
+    // Generation 0 is never handed out, so a default constructed entity is null.
+    struct Entity {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool IsNull() const { return generation == 0; }
+        bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    };
+
+    constexpr size_t ChunkBytes = 16 * 1024;
+
+    // Entities of one archetype, every component in its own array so iterating a component touches only its data.
+    struct alignas(64) ChunkMemory {
+        std::byte bytes[ChunkBytes];
+    };
+
+    struct Chunk {
+        std::unique_ptr<ChunkMemory> memory;
+        uint32_t count = 0;
+    };
+
+    // All entities with exactly the same set of components. Chunks are kept dense: only the last one has free rows.
+    struct Archetype {
+        ComponentMask mask = 0;
+        std::vector<ComponentId> components;
+        uint32_t capacity = 0;
+        // Byte offsets of the entity array and of every component array inside a chunk.
+        uint32_t entityOffset = 0;
+        std::array<uint32_t, MaxComponents> offsets {};
+        // Taken from the registry at creation (its entries never move), so moving rows never has to take its lock.
+        std::array<uint32_t, MaxComponents> sizes {};
+        std::array<const std::byte*, MaxComponents> defaultValues {};
+        std::vector<Chunk> chunks;
+        uint32_t entityCount = 0;
+    };
+
+    // Matches every archetype that has all components of `all` and none of `none`. Created and kept by the world,
+    // the matching archetypes are cached and only newly created archetypes are checked again.
+    class Query {
+    public:
+        [[nodiscard]] ComponentMask GetAll() const { return m_All; }
+        [[nodiscard]] ComponentMask GetNone() const { return m_None; }
+
+    private:
+        friend class World;
+
+        ComponentMask m_All = 0;
+        ComponentMask m_None = 0;
+        std::vector<Archetype*> m_Archetypes;
+        size_t m_CheckedArchetypes = 0;
+    };
+
+    // The component arrays of one chunk while a query iterates it.
+    class ChunkView {
+    public:
+        ChunkView(World& world, const Archetype& archetype, Chunk& chunk, uint32_t firstIndex)
+            : m_World(world), m_Archetype(archetype), m_Chunk(chunk), m_FirstIndex(firstIndex) {}
+
+        [[nodiscard]] uint32_t GetCount() const { return m_Chunk.count; }
+        // Position of the chunk's first entity among everything the query visits, in the same order every time
+        // while nothing changes structurally. Lets parallel iteration write into one flat array.
+        [[nodiscard]] uint32_t GetFirstIndex() const { return m_FirstIndex; }
+        [[nodiscard]] const Entity* GetEntities() const {
+            return reinterpret_cast<const Entity*>(m_Chunk.memory->bytes + m_Archetype.entityOffset);
+        }
+        template<typename T>
+        [[nodiscard]] bool Has() const { return (m_Archetype.mask >> GetComponentId<T>()) & 1u; }
+        // nullptr when the archetype has no such component. Asking for a non-const T marks the component as
+        // written, see World::GetComponentVersion().
+        template<typename T>
+        T* Get();
+
+    private:
+        World& m_World;
+        const Archetype& m_Archetype;
+        Chunk& m_Chunk;
+        uint32_t m_FirstIndex;
+    };
+
+    // Owns entities and their components. Not thread safe: structural changes (create, destroy, add, remove) and
+    // query creation belong to one thread, and must not happen while chunks are being iterated. Record those with
+    // an EntityCommandBuffer instead. Iteration itself may fan out over the job system.
+    class World {
+    public:
+        World();
+        ~World();
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        Entity CreateEntity(ComponentMask components);
+        template<typename... Ts>
+        Entity CreateEntity(const Ts&... components);
+        // Returns 0, or -1 if the entity is already gone.
+        int DestroyEntity(Entity entity);
+        [[nodiscard]] bool IsAlive(Entity entity) const;
+        [[nodiscard]] uint32_t GetEntityCount() const { return m_EntityCount; }
+
+        // Moves the entity to the archetype with the component added (or removed). Adding a component the entity
+        // already has overwrites it. Return 0, or -1 if the entity is gone.
+        int AddComponent(Entity entity, ComponentId component, const void* value);
+        int RemoveComponent(Entity entity, ComponentId component);
+        // nullptr when the entity is gone or lacks the component. Marks the component as written.
+        void* GetComponentData(Entity entity, ComponentId component);
+        [[nodiscard]] const void* GetComponentData(Entity entity, ComponentId component) const;
+
+        template<typename T>
+        int AddComponent(Entity entity, const T& value) { return AddComponent(entity, GetComponentId<T>(), &value); }
+        template<typename T>
+        int RemoveComponent(Entity entity) { return RemoveComponent(entity, GetComponentId<T>()); }
+        template<typename T>
+        T* GetComponent(Entity entity) { return static_cast<T*>(GetComponentData(entity, GetComponentId<T>())); }
+        template<typename T>
+        const T* GetComponent(Entity entity) const { return static_cast<const T*>(GetComponentData(entity, GetComponentId<T>())); }
+
+        // Returns the query for these masks, the same object every time they are asked for.
+        Query& CreateQuery(ComponentMask all, ComponentMask none = 0);
+        template<typename... Ts>
+        Query& CreateQuery() { return CreateQuery(GetComponentMask<Ts...>()); }
+        // Entities matched by the query right now.
+        [[nodiscard]] uint32_t CountEntities(Query& query);
+
+        void ForEachChunk(Query& query, const std::function<void(ChunkView& chunk)>& function);
+        // Chunks are handed out in batches of chunksPerJob, the call returns when all of them ran.
+        void ForEachChunkParallel(Query& query, JobSystem& jobSystem, uint32_t chunksPerJob, const std::function<void(ChunkView& chunk)>& function);
+        // Calls function(entity, components&...) for every matched entity, the query has to include the components.
+        template<typename... Ts, typename F>
+        void ForEach(Query& query, F&& function);
+
+        // Increases whenever the component may have changed: on write access and when entities that have it are
+        // created, destroyed or moved between archetypes. Comparing versions tells whether anything needs updating.
+        [[nodiscard]] uint64_t GetComponentVersion(ComponentId component) const {
+            return m_ComponentVersions[component].load(std::memory_order_relaxed);
+        }
+        void MarkWritten(ComponentId component) { m_ComponentVersions[component].fetch_add(1, std::memory_order_relaxed); }
+
+    private:
+        struct EntityRecord {
+            Archetype* archetype = nullptr;
+            uint32_t chunk = 0;
+            uint32_t row = 0;
+            uint32_t generation = 1;
+        };
+
+        Archetype& GetOrCreateArchetype(ComponentMask mask);
+        void UpdateQuery(Query& query);
+        void MarkArchetypeWritten(const Archetype& archetype);
+        // Appends a row to the archetype's last chunk and returns where it went.
+        void AllocateRow(Archetype& archetype, uint32_t& chunk, uint32_t& row);
+        // Removes a row by moving the archetype's last row into it, fixing the moved entity's record.
+        void FreeRow(Archetype& archetype, uint32_t chunk, uint32_t row);
+        [[nodiscard]] const EntityRecord* FindRecord(Entity entity) const;
+
+        std::vector<EntityRecord> m_Records;
+        std::vector<uint32_t> m_FreeIndices;
+        uint32_t m_EntityCount = 0;
+        std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+        std::unordered_map<ComponentMask, Archetype*> m_ArchetypesByMask;
+        std::vector<std::unique_ptr<Query>> m_Queries;
+        std::array<std::atomic<uint64_t>, MaxComponents> m_ComponentVersions {};
+    };
+
+    template<typename T>
+    T* ChunkView::Get() {
+        ComponentId id = GetComponentId<T>();
+        if (((m_Archetype.mask >> id) & 1u) == 0) {
+            return nullptr;
+        }
+        if constexpr (!std::is_const_v<T>) {
+            m_World.MarkWritten(id);
+        }
+        return reinterpret_cast<T*>(m_Chunk.memory->bytes + m_Archetype.offsets[id]);
+    }
+
+    template<typename... Ts>
+    Entity World::CreateEntity(const Ts&... components) {
+        Entity entity = CreateEntity(GetComponentMask<Ts...>());
+        (std::memcpy(GetComponentData(entity, GetComponentId<Ts>()), &components, sizeof(Ts)), ...);
+        return entity;
+    }
+
+    template<typename... Ts, typename F>
+    void World::ForEach(Query& query, F&& function) {
+        ForEachChunk(query, [&](ChunkView& chunk) {
+            const Entity* entities = chunk.GetEntities();
+            std::tuple<Ts*...> arrays {chunk.Get<Ts>()...};
+            for (uint32_t i = 0; i < chunk.GetCount(); i++) {
+                function(entities[i], std::get<Ts*>(arrays)[i]...);
+            }
+        });
+    }
+}
+#endif //REDPLASMA_WORLD_H
\ No newline at end of file
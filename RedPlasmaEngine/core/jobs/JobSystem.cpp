@@ -0,0 +1,326 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace RedPlasma {
+    namespace {
+        struct ThreadSlot {
+            uint64_t systemId;
+            uint32_t index;
+        };
+
+        std::atomic<uint64_t> g_NextSystemId{1};
+        // Slots of the calling thread, one per system it used. Rarely more than one entry.
+        thread_local std::vector<ThreadSlot> t_Slots;
+
+        ThreadSlot* FindSlot(uint64_t systemId) {
+            for (ThreadSlot& slot : t_Slots) {
+                if (slot.systemId == systemId) {
+                    return &slot;
+                }
+            }
+            return nullptr;
+        }
+
+        void BindSlot(uint64_t systemId, uint32_t index) {
+            if (ThreadSlot* slot = FindSlot(systemId)) {
+                slot->index = index;
+            } else {
+                t_Slots.push_back({systemId, index});
+            }
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        Shutdown();
+    }
+
+    void JobSystem::Initialize(uint32_t workerCount) {
+        if (!m_Workers.empty()) {
+            return;
+        }
+
+        if (workerCount == 0) {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        m_MainThread = std::this_thread::get_id();
+        m_SystemId = g_NextSystemId.fetch_add(1, std::memory_order_relaxed);
+        m_Stopping = false;
+        m_Queues.clear();
+        // Slot 0 is the calling thread, the other external slots follow the workers.
+        m_NextExternalSlot.store(1, std::memory_order_relaxed);
+        BindSlot(m_SystemId, 0);
+        for (uint32_t i = 0; i < workerCount + MaxExternalThreads; i++) {
+            m_Queues.push_back(std::make_unique<WorkQueue>());
+        }
+        for (uint32_t i = 1; i <= workerCount; i++) {
+            m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+        }
+    }
+
+    void JobSystem::Shutdown() {
+        if (m_Workers.empty()) {
+            return;
+        }
+
+        m_Stopping = true;
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+        }
+        m_WakeCondition.notify_all();
+        for (auto& worker : m_Workers) {
+            worker.join();
+        }
+        m_Workers.clear();
+
+        // A job may have been queued from outside while the last worker was leaving.
+        while (RunOneJob(0)) {
+        }
+
+        m_Queues.clear();
+        m_MainThreadJobs.clear();
+        m_FrameJobs.clear();
+        m_CompletedFrame = 0;
+    }
+
+    uint32_t JobSystem::GetCurrentThreadIndex() const {
+        if (const ThreadSlot* slot = FindSlot(m_SystemId)) {
+            return slot->index;
+        }
+        if (m_Workers.empty()) {
+            // Not initialized (or shut down), nothing is queued per thread then.
+            return 0;
+        }
+
+        uint32_t external = m_NextExternalSlot.fetch_add(1, std::memory_order_relaxed);
+        if (external >= MaxExternalThreads) {
+            std::cout << "[Jobs] More than " << MaxExternalThreads << " threads outside the workers use the job system" << std::endl;
+            std::abort();
+        }
+        uint32_t index = GetWorkerCount() + external;
+        BindSlot(m_SystemId, index);
+        return index;
+    }
+
+    void JobSystem::Schedule(JobFunction job, JobCounter* counter) {
+        if (counter) {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        Enqueue({ std::move(job), counter });
+    }
+
+    void JobSystem::ScheduleAfter(JobCounter& dependency, JobFunction job, JobCounter* counter) {
+        if (counter) {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            // FinishJob decrements under the same lock, so the dependency cannot complete in between.
+            std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+            if (dependency.m_Pending.load(std::memory_order_acquire) != 0) {
+                dependency.m_Continuations.push_back({ std::move(job), counter });
+                return;
+            }
+        }
+        Enqueue({ std::move(job), counter });
+    }
+
+    void JobSystem::ScheduleAfterFrame(uint64_t frameNumber, JobFunction job, JobCounter* counter) {
+        if (counter) {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_FrameMutex);
+            if (frameNumber > m_CompletedFrame) {
+                m_FrameJobs.push_back({ frameNumber, { std::move(job), counter } });
+                return;
+            }
+        }
+        Enqueue({ std::move(job), counter });
+    }
+
+    void JobSystem::ScheduleOnMainThread(JobFunction job, JobCounter* counter) {
+        if (counter) {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+        m_MainThreadJobs.push_back({ std::move(job), counter });
+    }
+
+    void JobSystem::RunMainThreadJobs() {
+        std::vector<Job> jobs;
+        {
+            std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+            jobs.swap(m_MainThreadJobs);
+        }
+        for (auto& job : jobs) {
+            Execute(job);
+        }
+    }
+
+    void JobSystem::NotifyFrameCompleted(uint64_t frameNumber) {
+        std::vector<Job> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_FrameMutex);
+            m_CompletedFrame = std::max(m_CompletedFrame, frameNumber);
+            auto firstPending = std::partition(m_FrameJobs.begin(), m_FrameJobs.end(),
+                                               [this](const FrameJob& frameJob) { return frameJob.frameNumber > m_CompletedFrame; });
+            for (auto it = firstPending; it != m_FrameJobs.end(); ++it) {
+                ready.push_back(std::move(it->job));
+            }
+            m_FrameJobs.erase(firstPending, m_FrameJobs.end());
+        }
+        for (auto& job : ready) {
+            Enqueue(std::move(job));
+        }
+    }
+
+    void JobSystem::Wait(JobCounter& counter) {
+        uint32_t index = GetCurrentThreadIndex();
+        while (!counter.IsDone()) {
+            if (RunOneJob(index)) {
+                continue;
+            }
+            if (IsMainThread()) {
+                RunMainThreadJobs();
+            }
+            std::this_thread::yield();
+        }
+
+        // The last FinishJob may still hold the counter's mutex, the caller is free to destroy it after this.
+        std::lock_guard<std::mutex> lock(counter.m_Mutex);
+    }
+
+    void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t begin, uint32_t end)>& body) {
+        if (count == 0) {
+            return;
+        }
+        batchSize = std::max(batchSize, 1u);
+
+        JobCounter counter;
+        for (uint32_t begin = 0; begin < count; begin += batchSize) {
+            uint32_t end = std::min(count, begin + batchSize);
+            Schedule([&body, begin, end]() { body(begin, end); }, &counter);
+        }
+        Wait(counter);
+    }
+
+    void JobSystem::WorkerLoop(uint32_t index) {
+        BindSlot(m_SystemId, index);
+
+        while (true) {
+            if (RunOneJob(index)) {
+                continue;
+            }
+            if (m_Stopping && m_QueuedJobs.load(std::memory_order_acquire) == 0) {
+                break;
+            }
+
+            std::unique_lock<std::mutex> lock(m_SleepMutex);
+            m_WakeCondition.wait(lock, [this]() {
+                return m_QueuedJobs.load(std::memory_order_acquire) > 0 || m_Stopping.load();
+            });
+        }
+    }
+
+    void JobSystem::Enqueue(Job job) {
+        if (m_Queues.empty()) {
+            // Not initialized, behave like a system without workers.
+            Execute(job);
+            return;
+        }
+
+        WorkQueue& queue = *m_Queues[GetCurrentThreadIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+        m_QueuedJobs.fetch_add(1, std::memory_order_release);
+
+        // Taking the lock orders this against a worker that just checked the predicate, so the wakeup is not lost.
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+        }
+        m_WakeCondition.notify_one();
+    }
+
+    bool JobSystem::TryPop(uint32_t index, Job& outJob) {
+        WorkQueue& queue = *m_Queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            return false;
+        }
+        // Newest first, its data is most likely still in cache.
+        outJob = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    bool JobSystem::TrySteal(uint32_t thiefIndex, Job& outJob) {
+        auto queueCount = static_cast<uint32_t>(m_Queues.size());
+        for (uint32_t offset = 1; offset < queueCount; offset++) {
+            WorkQueue& queue = *m_Queues[(thiefIndex + offset) % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                outJob = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool JobSystem::RunOneJob(uint32_t index) {
+        if (m_Queues.empty()) {
+            return false;
+        }
+
+        Job job;
+        if (!TryPop(index, job) && !TrySteal(index, job)) {
+            return false;
+        }
+        m_QueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+        Execute(job);
+        return true;
+    }
+
+    void JobSystem::Execute(Job& job) {
+        job.function();
+        FinishJob(job.counter);
+    }
+
+    void JobSystem::FinishJob(JobCounter* counter) {
+        if (counter == nullptr) {
+            return;
+        }
+
+        std::vector<JobCounter::Continuation> continuations;
+        {
+            std::lock_guard<std::mutex> lock(counter->m_Mutex);
+            if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+            continuations.swap(counter->m_Continuations);
+        }
+        for (auto& continuation : continuations) {
+            Enqueue({ std::move(continuation.function), continuation.counter });
+        }
+    }
+}
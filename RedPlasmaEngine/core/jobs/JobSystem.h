@@ -0,0 +1,134 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_JOBSYSTEM_H
+#define REDPLASMA_JOBSYSTEM_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace RedPlasma {
+    using JobFunction = std::function<void()>;
+
+    // Counts the unfinished jobs of a group. Jobs can be chained behind it with JobSystem::ScheduleAfter.
+    // Has to outlive every job that was scheduled with it, so Wait() before destroying one.
+    class JobCounter {
+    public:
+        [[nodiscard]] bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        struct Continuation {
+            JobFunction function;
+            JobCounter* counter;
+        };
+
+        std::atomic<uint32_t> m_Pending{0};
+        std::mutex m_Mutex;
+        std::vector<Continuation> m_Continuations;
+    };
+
+    // Fixed pool of worker threads. Every thread using the system owns a deque it pushes to and pops from at
+    // the back, idle threads steal from the front of the others. Threads that are not workers (main, render,
+    // simulation, ...) get a queue of their own the first time they use the system, so per thread resources can
+    // be keyed on GetCurrentThreadIndex() no matter which thread ends up running a job.
+    class JobSystem {
+    public:
+        // Threads besides the workers that may use one system, the one calling Initialize() included.
+        static constexpr uint32_t MaxExternalThreads = 8;
+
+        JobSystem() = default;
+        ~JobSystem();
+
+        // 0 picks one worker per hardware thread minus the main thread.
+        void Initialize(uint32_t workerCount = 0);
+        // Finishes every queued job, then joins the workers. Jobs still waiting for a frame are dropped.
+        void Shutdown();
+
+        void Schedule(JobFunction job, JobCounter* counter = nullptr);
+        // Starts the job once every job counted by dependency has finished.
+        void ScheduleAfter(JobCounter& dependency, JobFunction job, JobCounter* counter = nullptr);
+        // Starts the job once the GPU has finished the given frame (see NotifyFrameCompleted).
+        void ScheduleAfterFrame(uint64_t frameNumber, JobFunction job, JobCounter* counter = nullptr);
+        // For work that must happen on the main thread (window system, ...), runs in RunMainThreadJobs().
+        void ScheduleOnMainThread(JobFunction job, JobCounter* counter = nullptr);
+
+        // Runs other jobs until the counter reaches zero instead of blocking the thread.
+        void Wait(JobCounter& counter);
+        // Splits [0, count) into batches of batchSize and returns once all of them ran.
+        void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t begin, uint32_t end)>& body);
+
+        // Called by the main thread once per frame.
+        void RunMainThreadJobs();
+        void NotifyFrameCompleted(uint64_t frameNumber);
+
+        [[nodiscard]] uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+        // Unique per thread and below GetThreadSlotCount(): 0 for the thread that called Initialize(),
+        // 1..GetWorkerCount() for the workers, higher values for other threads in the order they first used the system.
+        [[nodiscard]] uint32_t GetCurrentThreadIndex() const;
+        [[nodiscard]] uint32_t GetThreadSlotCount() const { return GetWorkerCount() + MaxExternalThreads; }
+        [[nodiscard]] bool IsMainThread() const { return std::this_thread::get_id() == m_MainThread; }
+
+    private:
+        struct Job {
+            JobFunction function;
+            JobCounter* counter = nullptr;
+        };
+
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        struct FrameJob {
+            uint64_t frameNumber;
+            Job job;
+        };
+
+        void WorkerLoop(uint32_t index);
+        void Enqueue(Job job);
+        bool TryPop(uint32_t index, Job& outJob);
+        bool TrySteal(uint32_t thiefIndex, Job& outJob);
+        bool RunOneJob(uint32_t index);
+        void Execute(Job& job);
+        void FinishJob(JobCounter* counter);
+
+        // Queue i belongs to the thread whose GetCurrentThreadIndex() is i.
+        std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+        // Tells threads of this system apart from those of an earlier one that lived at the same address.
+        uint64_t m_SystemId = 0;
+        mutable std::atomic<uint32_t> m_NextExternalSlot{0};
+        std::vector<std::thread> m_Workers;
+        std::thread::id m_MainThread;
+
+        std::atomic<uint32_t> m_QueuedJobs{0};
+        std::atomic<bool> m_Stopping{false};
+        std::mutex m_SleepMutex;
+        std::condition_variable m_WakeCondition;
+
+        std::mutex m_MainThreadMutex;
+        std::vector<Job> m_MainThreadJobs;
+
+        std::mutex m_FrameMutex;
+        std::vector<FrameJob> m_FrameJobs;
+        uint64_t m_CompletedFrame = 0;
+    };
+}
+#endif //REDPLASMA_JOBSYSTEM_H
\ No newline at end of file
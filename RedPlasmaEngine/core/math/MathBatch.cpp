@@ -0,0 +1,279 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "MathBatch.h"
+
+#include <bit>
+#include <cmath>
+
+#include "SimdLanes.h"
+
+namespace RedPlasma {
+    Frustum ExtractFrustum(const Mat4& viewProjection) {
+        // Rows of the matrix, clip space is -w <= x, y <= w and 0 <= z <= w.
+        const float* m = viewProjection.m;
+        Vec4 rows[4];
+        for (int row = 0; row < 4; row++) {
+            rows[row] = {m[row], m[4 + row], m[8 + row], m[12 + row]};
+        }
+        Frustum frustum;
+        frustum.planes[0] = rows[3] + rows[0];
+        frustum.planes[1] = rows[3] - rows[0];
+        frustum.planes[2] = rows[3] + rows[1];
+        frustum.planes[3] = rows[3] - rows[1];
+        frustum.planes[4] = rows[2];
+        frustum.planes[5] = rows[3] - rows[2];
+        for (Vec4& plane : frustum.planes) {
+            float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            if (length > 0.0f) {
+                plane = plane * (1.0f / length);
+            }
+        }
+        return frustum;
+    }
+
+    void PackMatrices(const Mat4* matrices, size_t count, Mat4Block* blocks) {
+        const Mat4 identity;
+        for (size_t block = 0; block < GetMatrixBlockCount(count); block++) {
+            for (size_t lane = 0; lane < MatrixBlockLanes; lane++) {
+                size_t index = block * MatrixBlockLanes + lane;
+                const Mat4& source = index < count ? matrices[index] : identity;
+                for (int element = 0; element < 16; element++) {
+                    blocks[block].m[element][lane] = source.m[element];
+                }
+            }
+        }
+    }
+
+    void UnpackMatrices(const Mat4Block* blocks, size_t count, Mat4* matrices) {
+        for (size_t index = 0; index < count; index++) {
+            const Mat4Block& block = blocks[index / MatrixBlockLanes];
+            size_t lane = index % MatrixBlockLanes;
+            for (int element = 0; element < 16; element++) {
+                matrices[index].m[element] = block.m[element][lane];
+            }
+        }
+    }
+
+    const char* GetSimdLevel() {
+#if defined(REDPLASMA_SIMD_AVX2)
+        return "AVX2";
+#elif defined(REDPLASMA_SIMD_SSE)
+        return "SSE";
+#else
+        return "Scalar";
+#endif
+    }
+
+#if defined(REDPLASMA_SIMD_ENABLED)
+    void MultiplyMatrices(const Mat4& left, const Mat4* right, Mat4* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = Multiply(left, right[i]);
+        }
+    }
+
+    void MultiplyMatrixBlocks(const Mat4& left, const Mat4Block* right, Mat4Block* out, size_t blockCount) {
+        // The left matrix is the same for every lane, its elements are broadcast once.
+        Simd::Float l[16];
+        for (int element = 0; element < 16; element++) {
+            l[element] = Simd::Splat(left.m[element]);
+        }
+        for (size_t block = 0; block < blockCount; block++) {
+            const Mat4Block& source = right[block];
+            Mat4Block& destination = out[block];
+            for (size_t lane = 0; lane < MatrixBlockLanes; lane += Simd::Width) {
+                for (int column = 0; column < 4; column++) {
+                    Simd::Float r0 = Simd::Load(&source.m[column * 4][lane]);
+                    Simd::Float r1 = Simd::Load(&source.m[column * 4 + 1][lane]);
+                    Simd::Float r2 = Simd::Load(&source.m[column * 4 + 2][lane]);
+                    Simd::Float r3 = Simd::Load(&source.m[column * 4 + 3][lane]);
+                    for (int row = 0; row < 4; row++) {
+                        Simd::Float sum = Simd::Mul(l[row], r0);
+                        sum = Simd::MulAdd(l[4 + row], r1, sum);
+                        sum = Simd::MulAdd(l[8 + row], r2, sum);
+                        sum = Simd::MulAdd(l[12 + row], r3, sum);
+                        Simd::Store(&destination.m[column * 4 + row][lane], sum);
+                    }
+                }
+            }
+        }
+    }
+
+    void ComposeHierarchy(const Mat4* local, const int32_t* parents, size_t count, Mat4* world) {
+        for (size_t i = 0; i < count; i++) {
+            world[i] = parents[i] < 0 ? local[i] : Multiply(world[parents[i]], local[i]);
+        }
+    }
+
+    size_t CullSpheres(const Frustum& frustum, const SphereSoa& spheres, size_t count, uint8_t* visible) {
+        Simd::Float planes[6][4];
+        for (int p = 0; p < 6; p++) {
+            planes[p][0] = Simd::Splat(frustum.planes[p].x);
+            planes[p][1] = Simd::Splat(frustum.planes[p].y);
+            planes[p][2] = Simd::Splat(frustum.planes[p].z);
+            planes[p][3] = Simd::Splat(frustum.planes[p].w);
+        }
+        const Simd::Float zero = Simd::Splat(0.0f);
+        const uint32_t allLanes = (1u << Simd::Width) - 1;
+
+        size_t visibleCount = 0;
+        size_t i = 0;
+        for (; i + Simd::Width <= count; i += Simd::Width) {
+            Simd::Float x = Simd::Load(spheres.centerX + i);
+            Simd::Float y = Simd::Load(spheres.centerY + i);
+            Simd::Float z = Simd::Load(spheres.centerZ + i);
+            Simd::Float radius = Simd::Load(spheres.radius + i);
+            uint32_t inside = allLanes;
+            for (const auto& plane : planes) {
+                // Signed distance plus radius, negative means fully behind the plane.
+                Simd::Float distance = Simd::MulAdd(plane[0], x, Simd::Add(plane[3], radius));
+                distance = Simd::MulAdd(plane[1], y, distance);
+                distance = Simd::MulAdd(plane[2], z, distance);
+                inside &= Simd::GreaterEqualMask(distance, zero);
+            }
+            for (size_t lane = 0; lane < Simd::Width; lane++) {
+                visible[i + lane] = static_cast<uint8_t>((inside >> lane) & 1u);
+            }
+            visibleCount += static_cast<size_t>(std::popcount(inside));
+        }
+
+        SphereSoa tail = {spheres.centerX + i, spheres.centerY + i, spheres.centerZ + i, spheres.radius + i};
+        return visibleCount + ScalarMath::CullSpheres(frustum, tail, count - i, visible + i);
+    }
+
+    size_t CullAabbs(const Frustum& frustum, const AabbSoa& boxes, size_t count, uint8_t* visible) {
+        // Per plane the normal, its absolute value for the extents and the distance.
+        Simd::Float planes[6][7];
+        for (int p = 0; p < 6; p++) {
+            const Vec4& plane = frustum.planes[p];
+            planes[p][0] = Simd::Splat(plane.x);
+            planes[p][1] = Simd::Splat(plane.y);
+            planes[p][2] = Simd::Splat(plane.z);
+            planes[p][3] = Simd::Splat(std::fabs(plane.x));
+            planes[p][4] = Simd::Splat(std::fabs(plane.y));
+            planes[p][5] = Simd::Splat(std::fabs(plane.z));
+            planes[p][6] = Simd::Splat(plane.w);
+        }
+        const Simd::Float zero = Simd::Splat(0.0f);
+        const uint32_t allLanes = (1u << Simd::Width) - 1;
+
+        size_t visibleCount = 0;
+        size_t i = 0;
+        for (; i + Simd::Width <= count; i += Simd::Width) {
+            Simd::Float x = Simd::Load(boxes.centerX + i);
+            Simd::Float y = Simd::Load(boxes.centerY + i);
+            Simd::Float z = Simd::Load(boxes.centerZ + i);
+            Simd::Float ex = Simd::Load(boxes.extentX + i);
+            Simd::Float ey = Simd::Load(boxes.extentY + i);
+            Simd::Float ez = Simd::Load(boxes.extentZ + i);
+            uint32_t inside = allLanes;
+            for (const auto& plane : planes) {
+                // Distance of the corner furthest along the plane normal.
+                Simd::Float distance = Simd::MulAdd(plane[0], x, plane[6]);
+                distance = Simd::MulAdd(plane[1], y, distance);
+                distance = Simd::MulAdd(plane[2], z, distance);
+                distance = Simd::MulAdd(plane[3], ex, distance);
+                distance = Simd::MulAdd(plane[4], ey, distance);
+                distance = Simd::MulAdd(plane[5], ez, distance);
+                inside &= Simd::GreaterEqualMask(distance, zero);
+            }
+            for (size_t lane = 0; lane < Simd::Width; lane++) {
+                visible[i + lane] = static_cast<uint8_t>((inside >> lane) & 1u);
+            }
+            visibleCount += static_cast<size_t>(std::popcount(inside));
+        }
+
+        AabbSoa tail = {boxes.centerX + i, boxes.centerY + i, boxes.centerZ + i, boxes.extentX + i, boxes.extentY + i, boxes.extentZ + i};
+        return visibleCount + ScalarMath::CullAabbs(frustum, tail, count - i, visible + i);
+    }
+#else
+    void MultiplyMatrices(const Mat4& left, const Mat4* right, Mat4* out, size_t count) {
+        ScalarMath::MultiplyMatrices(left, right, out, count);
+    }
+
+    void MultiplyMatrixBlocks(const Mat4& left, const Mat4Block* right, Mat4Block* out, size_t blockCount) {
+        ScalarMath::MultiplyMatrixBlocks(left, right, out, blockCount);
+    }
+
+    void ComposeHierarchy(const Mat4* local, const int32_t* parents, size_t count, Mat4* world) {
+        ScalarMath::ComposeHierarchy(local, parents, count, world);
+    }
+
+    size_t CullSpheres(const Frustum& frustum, const SphereSoa& spheres, size_t count, uint8_t* visible) {
+        return ScalarMath::CullSpheres(frustum, spheres, count, visible);
+    }
+
+    size_t CullAabbs(const Frustum& frustum, const AabbSoa& boxes, size_t count, uint8_t* visible) {
+        return ScalarMath::CullAabbs(frustum, boxes, count, visible);
+    }
+#endif
+
+    namespace ScalarMath {
+        void MultiplyMatrices(const Mat4& left, const Mat4* right, Mat4* out, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                out[i] = ScalarMath::Multiply(left, right[i]);
+            }
+        }
+
+        void MultiplyMatrixBlocks(const Mat4& left, const Mat4Block* right, Mat4Block* out, size_t blockCount) {
+            for (size_t block = 0; block < blockCount; block++) {
+                for (size_t lane = 0; lane < MatrixBlockLanes; lane++) {
+                    for (int column = 0; column < 4; column++) {
+                        for (int row = 0; row < 4; row++) {
+                            float sum = 0.0f;
+                            for (int k = 0; k < 4; k++) {
+                                sum += left.m[k * 4 + row] * right[block].m[column * 4 + k][lane];
+                            }
+                            out[block].m[column * 4 + row][lane] = sum;
+                        }
+                    }
+                }
+            }
+        }
+
+        void ComposeHierarchy(const Mat4* local, const int32_t* parents, size_t count, Mat4* world) {
+            for (size_t i = 0; i < count; i++) {
+                world[i] = parents[i] < 0 ? local[i] : ScalarMath::Multiply(world[parents[i]], local[i]);
+            }
+        }
+
+        size_t CullSpheres(const Frustum& frustum, const SphereSoa& spheres, size_t count, uint8_t* visible) {
+            size_t visibleCount = 0;
+            for (size_t i = 0; i < count; i++) {
+                bool inside = true;
+                for (const Vec4& plane : frustum.planes) {
+                    float distance = plane.x * spheres.centerX[i] + plane.y * spheres.centerY[i] + plane.z * spheres.centerZ[i] + plane.w;
+                    inside = inside && distance >= -spheres.radius[i];
+                }
+                visible[i] = inside ? 1 : 0;
+                visibleCount += inside ? 1 : 0;
+            }
+            return visibleCount;
+        }
+
+        size_t CullAabbs(const Frustum& frustum, const AabbSoa& boxes, size_t count, uint8_t* visible) {
+            size_t visibleCount = 0;
+            for (size_t i = 0; i < count; i++) {
+                bool inside = true;
+                for (const Vec4& plane : frustum.planes) {
+                    float distance = plane.x * boxes.centerX[i] + plane.y * boxes.centerY[i] + plane.z * boxes.centerZ[i] + plane.w
+                                   + std::fabs(plane.x) * boxes.extentX[i] + std::fabs(plane.y) * boxes.extentY[i] + std::fabs(plane.z) * boxes.extentZ[i];
+                    inside = inside && distance >= 0.0f;
+                }
+                visible[i] = inside ? 1 : 0;
+                visibleCount += inside ? 1 : 0;
+            }
+            return visibleCount;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_MATHBATCH_H
+#define REDPLASMA_MATHBATCH_H
+#include <cstddef>
+#include <cstdint>
+
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace RedPlasma {
+    constexpr size_t MatrixBlockLanes = 8;
+
+    // Eight matrices interleaved element by element, m[element][lane]. The batch kernels run one lane per
+    // matrix, so a block is one AVX2 register or two SSE registers per element.
+    struct alignas(32) Mat4Block {
+        float m[16][MatrixBlockLanes];
+    };
+
+    // Inward facing planes (xyz normal, w distance), normalized so distances are in world units.
+    struct Frustum {
+        Vec4 planes[6];
+    };
+
+    // Structure of arrays inputs for the culling kernels, every array has count entries.
+    struct SphereSoa {
+        const float* centerX = nullptr;
+        const float* centerY = nullptr;
+        const float* centerZ = nullptr;
+        const float* radius = nullptr;
+    };
+
+    struct AabbSoa {
+        const float* centerX = nullptr;
+        const float* centerY = nullptr;
+        const float* centerZ = nullptr;
+        const float* extentX = nullptr;
+        const float* extentY = nullptr;
+        const float* extentZ = nullptr;
+    };
+
+    // Planes of a Vulkan clip space (0..1 depth) view projection.
+    Frustum ExtractFrustum(const Mat4& viewProjection);
+
+    // Blocks needed for count matrices, unused lanes of the last one hold identities.
+    inline size_t GetMatrixBlockCount(size_t count) { return (count + MatrixBlockLanes - 1) / MatrixBlockLanes; }
+    void PackMatrices(const Mat4* matrices, size_t count, Mat4Block* blocks);
+    void UnpackMatrices(const Mat4Block* blocks, size_t count, Mat4* matrices);
+
+    // out[i] = left * right[i], the batch form of Multiply().
+    void MultiplyMatrices(const Mat4& left, const Mat4* right, Mat4* out, size_t count);
+    void MultiplyMatrixBlocks(const Mat4& left, const Mat4Block* right, Mat4Block* out, size_t blockCount);
+    // world[i] = world[parents[i]] * local[i], or local[i] for roots (parent -1). Parents have to come before
+    // their children, which makes it one pass.
+    void ComposeHierarchy(const Mat4* local, const int32_t* parents, size_t count, Mat4* world);
+    // visible[i] is 1 when the bounds intersect the frustum, the return value is how many do.
+    size_t CullSpheres(const Frustum& frustum, const SphereSoa& spheres, size_t count, uint8_t* visible);
+    size_t CullAabbs(const Frustum& frustum, const AabbSoa& boxes, size_t count, uint8_t* visible);
+
+    // "AVX2", "SSE" or "Scalar", whichever the engine was built with.
+    const char* GetSimdLevel();
+
+    namespace ScalarMath {
+        void MultiplyMatrices(const Mat4& left, const Mat4* right, Mat4* out, size_t count);
+        void MultiplyMatrixBlocks(const Mat4& left, const Mat4Block* right, Mat4Block* out, size_t blockCount);
+        void ComposeHierarchy(const Mat4* local, const int32_t* parents, size_t count, Mat4* world);
+        size_t CullSpheres(const Frustum& frustum, const SphereSoa& spheres, size_t count, uint8_t* visible);
+        size_t CullAabbs(const Frustum& frustum, const AabbSoa& boxes, size_t count, uint8_t* visible);
+    }
+}
+#endif //REDPLASMA_MATHBATCH_H
\ No newline at end of file
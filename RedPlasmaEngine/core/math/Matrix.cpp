@@ -0,0 +1,201 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "Matrix.h"
+
+#include <cmath>
+
+#include "SimdLanes.h"
+
+namespace RedPlasma {
+    Mat4 Mat4::Translation(const Vec3& translation) {
+        Mat4 result;
+        result.m[12] = translation.x;
+        result.m[13] = translation.y;
+        result.m[14] = translation.z;
+        return result;
+    }
+
+    Mat4 Mat4::Scale(const Vec3& scale) {
+        Mat4 result;
+        result.m[0] = scale.x;
+        result.m[5] = scale.y;
+        result.m[10] = scale.z;
+        return result;
+    }
+
+    Mat4 Mat4::Rotation(const Quat& rotation) {
+        return Compose(Vec3{}, rotation, Vec3{1.0f, 1.0f, 1.0f});
+    }
+
+    Mat4 Mat4::Compose(const Vec3& translation, const Quat& rotation, const Vec3& scale) {
+        float x = rotation.x;
+        float y = rotation.y;
+        float z = rotation.z;
+        float w = rotation.w;
+        Mat4 result;
+        result.m[0] = (1.0f - 2.0f * (y * y + z * z)) * scale.x;
+        result.m[1] = 2.0f * (x * y + z * w) * scale.x;
+        result.m[2] = 2.0f * (x * z - y * w) * scale.x;
+        result.m[4] = 2.0f * (x * y - z * w) * scale.y;
+        result.m[5] = (1.0f - 2.0f * (x * x + z * z)) * scale.y;
+        result.m[6] = 2.0f * (y * z + x * w) * scale.y;
+        result.m[8] = 2.0f * (x * z + y * w) * scale.z;
+        result.m[9] = 2.0f * (y * z - x * w) * scale.z;
+        result.m[10] = (1.0f - 2.0f * (x * x + y * y)) * scale.z;
+        result.m[12] = translation.x;
+        result.m[13] = translation.y;
+        result.m[14] = translation.z;
+        return result;
+    }
+
+    Mat4 Mat4::LookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+        Vec3 forward = Normalize(target - eye);
+        Vec3 right = Normalize(Cross(forward, up));
+        Vec3 cameraUp = Cross(right, forward);
+        Mat4 result;
+        result.m[0] = right.x;
+        result.m[4] = right.y;
+        result.m[8] = right.z;
+        result.m[1] = cameraUp.x;
+        result.m[5] = cameraUp.y;
+        result.m[9] = cameraUp.z;
+        result.m[2] = -forward.x;
+        result.m[6] = -forward.y;
+        result.m[10] = -forward.z;
+        result.m[12] = -Dot(right, eye);
+        result.m[13] = -Dot(cameraUp, eye);
+        result.m[14] = Dot(forward, eye);
+        return result;
+    }
+
+    Mat4 Mat4::Perspective(float fieldOfView, float aspect, float nearPlane, float farPlane) {
+        float focal = 1.0f / std::tan(fieldOfView * 0.5f);
+        Mat4 result;
+        result.m[0] = focal / aspect;
+        // Vulkan's clip space y points down.
+        result.m[5] = -focal;
+        result.m[10] = farPlane / (nearPlane - farPlane);
+        result.m[11] = -1.0f;
+        result.m[14] = nearPlane * farPlane / (nearPlane - farPlane);
+        result.m[15] = 0.0f;
+        return result;
+    }
+
+    Mat4 Multiply(const Mat4& a, const Mat4& b) {
+#if defined(REDPLASMA_SIMD_ENABLED)
+        // Every result column is the columns of a weighted by one column of b.
+        Simd::Float4 column0 = Simd::Load4(a.m);
+        Simd::Float4 column1 = Simd::Load4(a.m + 4);
+        Simd::Float4 column2 = Simd::Load4(a.m + 8);
+        Simd::Float4 column3 = Simd::Load4(a.m + 12);
+        Mat4 result;
+        for (int column = 0; column < 4; column++) {
+            const float* weights = b.m + column * 4;
+            Simd::Float4 sum = Simd::Mul4(column0, Simd::Splat4(weights[0]));
+            sum = Simd::MulAdd4(column1, Simd::Splat4(weights[1]), sum);
+            sum = Simd::MulAdd4(column2, Simd::Splat4(weights[2]), sum);
+            sum = Simd::MulAdd4(column3, Simd::Splat4(weights[3]), sum);
+            Simd::Store4(result.m + column * 4, sum);
+        }
+        return result;
+#else
+        return ScalarMath::Multiply(a, b);
+#endif
+    }
+
+    Vec4 Transform(const Mat4& matrix, const Vec4& vector) {
+        const float* m = matrix.m;
+        return {
+            m[0] * vector.x + m[4] * vector.y + m[8] * vector.z + m[12] * vector.w,
+            m[1] * vector.x + m[5] * vector.y + m[9] * vector.z + m[13] * vector.w,
+            m[2] * vector.x + m[6] * vector.y + m[10] * vector.z + m[14] * vector.w,
+            m[3] * vector.x + m[7] * vector.y + m[11] * vector.z + m[15] * vector.w
+        };
+    }
+
+    Vec3 TransformPoint(const Mat4& matrix, const Vec3& point) {
+        Vec4 result = Transform(matrix, Vec4{point.x, point.y, point.z, 1.0f});
+        return {result.x, result.y, result.z};
+    }
+
+    Mat4 Transpose(const Mat4& matrix) {
+        Mat4 result;
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 4; row++) {
+                result.m[row * 4 + column] = matrix.m[column * 4 + row];
+            }
+        }
+        return result;
+    }
+
+    Mat4 Inverse(const Mat4& matrix) {
+        // Laplace expansion over 2x2 sub-determinants, written for row major storage. The inverse of the transpose
+        // is the transpose of the inverse, so it works on the column major storage unchanged.
+        const float* m = matrix.m;
+        float s0 = m[0] * m[5] - m[4] * m[1];
+        float s1 = m[0] * m[6] - m[4] * m[2];
+        float s2 = m[0] * m[7] - m[4] * m[3];
+        float s3 = m[1] * m[6] - m[5] * m[2];
+        float s4 = m[1] * m[7] - m[5] * m[3];
+        float s5 = m[2] * m[7] - m[6] * m[3];
+        float c5 = m[10] * m[15] - m[14] * m[11];
+        float c4 = m[9] * m[15] - m[13] * m[11];
+        float c3 = m[9] * m[14] - m[13] * m[10];
+        float c2 = m[8] * m[15] - m[12] * m[11];
+        float c1 = m[8] * m[14] - m[12] * m[10];
+        float c0 = m[8] * m[13] - m[12] * m[9];
+
+        float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (determinant == 0.0f || !std::isfinite(determinant)) {
+            return {};
+        }
+        float inverse = 1.0f / determinant;
+
+        Mat4 result;
+        float* r = result.m;
+        r[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * inverse;
+        r[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * inverse;
+        r[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * inverse;
+        r[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * inverse;
+        r[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * inverse;
+        r[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * inverse;
+        r[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * inverse;
+        r[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * inverse;
+        r[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * inverse;
+        r[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * inverse;
+        r[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * inverse;
+        r[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * inverse;
+        r[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * inverse;
+        r[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * inverse;
+        r[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * inverse;
+        r[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * inverse;
+        return result;
+    }
+
+    namespace ScalarMath {
+        Mat4 Multiply(const Mat4& a, const Mat4& b) {
+            Mat4 result;
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) {
+                    float sum = 0.0f;
+                    for (int k = 0; k < 4; k++) {
+                        sum += a.m[k * 4 + row] * b.m[column * 4 + k];
+                    }
+                    result.m[column * 4 + row] = sum;
+                }
+            }
+            return result;
+        }
+    }
+}
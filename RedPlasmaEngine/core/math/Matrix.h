@@ -0,0 +1,55 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_MATRIX_H
+#define REDPLASMA_MATRIX_H
+#include "Quaternion.h"
+#include "Vector.h"
+
+namespace RedPlasma {
+    // Column major like every transform the renderer takes, element (row, column) is m[column * 4 + row].
+    struct alignas(16) Mat4 {
+        float m[16] = {
+            1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+
+        static Mat4 Identity() { return {}; }
+        static Mat4 Translation(const Vec3& translation);
+        static Mat4 Scale(const Vec3& scale);
+        static Mat4 Rotation(const Quat& rotation);
+        // translation * rotation * scale
+        static Mat4 Compose(const Vec3& translation, const Quat& rotation, const Vec3& scale);
+        // Right handed view and a perspective with Vulkan's 0..1 depth, field of view in radians.
+        static Mat4 LookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+        static Mat4 Perspective(float fieldOfView, float aspect, float nearPlane, float farPlane);
+    };
+
+    // a * b applies b first. SSE / AVX2 as selected by REDPLASMA_SIMD.
+    Mat4 Multiply(const Mat4& a, const Mat4& b);
+    Vec4 Transform(const Mat4& matrix, const Vec4& vector);
+    Vec3 TransformPoint(const Mat4& matrix, const Vec3& point);
+    Mat4 Transpose(const Mat4& matrix);
+    // General inverse, returns the identity for singular matrices.
+    Mat4 Inverse(const Mat4& matrix);
+
+    inline Mat4 operator*(const Mat4& a, const Mat4& b) { return Multiply(a, b); }
+
+    // Plain C++ versions of the vectorized functions, the reference the SIMD paths are checked and measured against.
+    namespace ScalarMath {
+        Mat4 Multiply(const Mat4& a, const Mat4& b);
+    }
+}
+#endif //REDPLASMA_MATRIX_H
\ No newline at end of file
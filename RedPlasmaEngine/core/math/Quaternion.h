@@ -0,0 +1,74 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_QUATERNION_H
+#define REDPLASMA_QUATERNION_H
+#include <cmath>
+
+#include "Vector.h"
+
+namespace RedPlasma {
+    // Unit quaternions are rotations, a * b rotates by b first.
+    struct Quat {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 1.0f;
+
+        // Axis has to be normalized, the angle is in radians.
+        static Quat FromAxisAngle(const Vec3& axis, float angle) {
+            float s = std::sin(angle * 0.5f);
+            return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f)};
+        }
+    };
+
+    inline Quat operator*(const Quat& a, const Quat& b) {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+        };
+    }
+
+    inline float Dot(const Quat& a, const Quat& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+    inline Quat Conjugate(const Quat& q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+    inline Quat Normalize(const Quat& q) {
+        float length = std::sqrt(Dot(q, q));
+        if (length <= 0.0f) {
+            return {};
+        }
+        float s = 1.0f / length;
+        return {q.x * s, q.y * s, q.z * s, q.w * s};
+    }
+
+    inline Vec3 Rotate(const Quat& q, const Vec3& v) {
+        // v + 2w (u x v) + 2 u x (u x v), with u the vector part.
+        Vec3 u {q.x, q.y, q.z};
+        Vec3 t = Cross(u, v) * 2.0f;
+        return v + t * q.w + Cross(u, t);
+    }
+
+    // Normalized lerp along the shorter arc, close enough to slerp for animation steps and much cheaper.
+    inline Quat Nlerp(const Quat& a, const Quat& b, float t) {
+        float sign = Dot(a, b) < 0.0f ? -1.0f : 1.0f;
+        return Normalize(Quat{
+            a.x + (b.x * sign - a.x) * t,
+            a.y + (b.y * sign - a.y) * t,
+            a.z + (b.z * sign - a.z) * t,
+            a.w + (b.w * sign - a.w) * t
+        });
+    }
+}
+#endif //REDPLASMA_QUATERNION_H
\ No newline at end of file
@@ -0,0 +1,77 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_SIMDLANES_H
+#define REDPLASMA_SIMDLANES_H
+#include <cstddef>
+#include <cstdint>
+
+// Internal to the math sources. One set of lane operations per instruction set, REDPLASMA_SIMD_AVX2 or
+// REDPLASMA_SIMD_SSE come from the REDPLASMA_SIMD CMake option, without either only the scalar code is built.
+#if defined(REDPLASMA_SIMD_AVX2)
+#if !defined(__AVX2__) || !defined(__FMA__)
+#error "REDPLASMA_SIMD=AVX2 needs the compiler to target AVX2 and FMA"
+#endif
+#include <immintrin.h>
+#define REDPLASMA_SIMD_ENABLED 1
+#elif defined(REDPLASMA_SIMD_SSE)
+#include <emmintrin.h>
+#define REDPLASMA_SIMD_ENABLED 1
+#endif
+
+#if defined(REDPLASMA_SIMD_ENABLED)
+namespace RedPlasma::Simd {
+    // Four wide operations, available on both levels.
+    using Float4 = __m128;
+
+    inline Float4 Load4(const float* source) { return _mm_loadu_ps(source); }
+    inline void Store4(float* destination, Float4 value) { _mm_storeu_ps(destination, value); }
+    inline Float4 Splat4(float value) { return _mm_set1_ps(value); }
+    // a * b + c
+    inline Float4 MulAdd4(Float4 a, Float4 b, Float4 c) {
+#if defined(REDPLASMA_SIMD_AVX2)
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+    inline Float4 Mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+
+    // The widest registers of the level, the batch kernels are written against these.
+#if defined(REDPLASMA_SIMD_AVX2)
+    constexpr size_t Width = 8;
+    using Float = __m256;
+
+    inline Float Load(const float* source) { return _mm256_loadu_ps(source); }
+    inline void Store(float* destination, Float value) { _mm256_storeu_ps(destination, value); }
+    inline Float Splat(float value) { return _mm256_set1_ps(value); }
+    inline Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    inline Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    inline Float MulAdd(Float a, Float b, Float c) { return _mm256_fmadd_ps(a, b, c); }
+    // One bit per lane, set where a >= b.
+    inline uint32_t GreaterEqualMask(Float a, Float b) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ))); }
+#else
+    constexpr size_t Width = 4;
+    using Float = __m128;
+
+    inline Float Load(const float* source) { return _mm_loadu_ps(source); }
+    inline void Store(float* destination, Float value) { _mm_storeu_ps(destination, value); }
+    inline Float Splat(float value) { return _mm_set1_ps(value); }
+    inline Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+    inline Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    inline Float MulAdd(Float a, Float b, Float c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    inline uint32_t GreaterEqualMask(Float a, Float b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(a, b))); }
+#endif
+}
+#endif
+#endif //REDPLASMA_SIMDLANES_H
\ No newline at end of file
@@ -0,0 +1,113 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "DrawList.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace RedPlasma {
+    namespace {
+        // Below this a comparison sort beats clearing and walking the histograms.
+        constexpr size_t RadixSortThreshold = 256;
+    }
+
+    uint64_t DrawKey::Pack(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) {
+        // clamp passes NaN through and converting it is undefined, broken transforms sort to the back instead.
+        float clamped = std::isfinite(depth) ? std::clamp(depth, 0.0f, 1.0f) : 1.0f;
+        auto quantized = static_cast<uint64_t>(clamped * static_cast<float>((1u << DepthBits) - 1) + 0.5f);
+        return (static_cast<uint64_t>(pass & MaxPass) << PassShift) |
+               (static_cast<uint64_t>(pipeline & MaxPipeline) << PipelineShift) |
+               (static_cast<uint64_t>(material & MaxMaterial) << MaterialShift) |
+               (static_cast<uint64_t>(mesh & MaxMesh) << MeshShift) |
+               quantized;
+    }
+
+    void DrawList::Clear() {
+        m_Entries.clear();
+        m_Instances.clear();
+        m_SortedInstances.clear();
+        m_Batches.clear();
+    }
+
+    void DrawList::Add(uint64_t key, const float transform[16]) {
+        m_Entries.push_back({ key, static_cast<uint32_t>(m_Instances.size()) });
+        DrawInstance& instance = m_Instances.emplace_back();
+        std::memcpy(instance.transform, transform, sizeof(instance.transform));
+    }
+
+    void DrawList::Build() {
+        m_Batches.clear();
+        m_SortedInstances.clear();
+        if (m_Entries.empty()) {
+            return;
+        }
+
+        if (m_Entries.size() < RadixSortThreshold) {
+            // Stable like the radix sort, so equal keys keep their submission order either way.
+            std::stable_sort(m_Entries.begin(), m_Entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        } else {
+            RadixSort();
+        }
+
+        m_SortedInstances.reserve(m_Entries.size());
+        uint64_t currentBatchKey = 0;
+        for (const Entry& entry : m_Entries) {
+            uint64_t batchKey = DrawKey::GetBatchKey(entry.key);
+            if (m_Batches.empty() || batchKey != currentBatchKey) {
+                currentBatchKey = batchKey;
+                DrawBatch batch;
+                batch.pass = DrawKey::GetPass(entry.key);
+                batch.pipeline = DrawKey::GetPipeline(entry.key);
+                batch.material = DrawKey::GetMaterial(entry.key);
+                batch.mesh = DrawKey::GetMesh(entry.key);
+                batch.firstInstance = static_cast<uint32_t>(m_SortedInstances.size());
+                m_Batches.push_back(batch);
+            }
+            m_Batches.back().instanceCount++;
+            m_SortedInstances.push_back(m_Instances[entry.instance]);
+        }
+    }
+
+    void DrawList::RadixSort() {
+        // LSD over the eight key bytes. All histograms come from one read of the keys, and bytes that are equal
+        // for every entry (unused passes, a single pipeline) are skipped without moving anything.
+        uint32_t histograms[8][256] = {};
+        for (const Entry& entry : m_Entries) {
+            for (uint32_t byte = 0; byte < 8; byte++) {
+                histograms[byte][(entry.key >> (byte * 8)) & 0xFF]++;
+            }
+        }
+
+        auto count = static_cast<uint32_t>(m_Entries.size());
+        m_Scratch.resize(m_Entries.size());
+        for (uint32_t byte = 0; byte < 8; byte++) {
+            uint32_t* histogram = histograms[byte];
+            if (histogram[(m_Entries[0].key >> (byte * 8)) & 0xFF] == count) {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (uint32_t bucket = 0; bucket < 256; bucket++) {
+                uint32_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+            for (const Entry& entry : m_Entries) {
+                m_Scratch[histogram[(entry.key >> (byte * 8)) & 0xFF]++] = entry;
+            }
+            m_Entries.swap(m_Scratch);
+        }
+    }
+}
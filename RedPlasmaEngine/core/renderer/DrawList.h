@@ -0,0 +1,97 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_DRAWLIST_H
+#define REDPLASMA_DRAWLIST_H
+#include <cstdint>
+#include <vector>
+
+namespace RedPlasma {
+    // Sort key layout, most significant first: pass (4) | pipeline (8) | material (16) | mesh (20) | depth (16).
+    // Sorting by it groups state changes from the most to the least expensive, equal keys above the depth
+    // bits are the same draw and become one instanced draw.
+    namespace DrawKey {
+        constexpr uint32_t DepthBits = 16;
+        constexpr uint32_t MeshBits = 20;
+        constexpr uint32_t MaterialBits = 16;
+        constexpr uint32_t PipelineBits = 8;
+        constexpr uint32_t PassBits = 4;
+
+        constexpr uint32_t MeshShift = DepthBits;
+        constexpr uint32_t MaterialShift = MeshShift + MeshBits;
+        constexpr uint32_t PipelineShift = MaterialShift + MaterialBits;
+        constexpr uint32_t PassShift = PipelineShift + PipelineBits;
+
+        constexpr uint32_t MaxMesh = (1u << MeshBits) - 1;
+        constexpr uint32_t MaxMaterial = (1u << MaterialBits) - 1;
+        constexpr uint32_t MaxPipeline = (1u << PipelineBits) - 1;
+        constexpr uint32_t MaxPass = (1u << PassBits) - 1;
+
+        // Depth is normalized to [0, 1] and clamped, 0 sorts first.
+        uint64_t Pack(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+        inline uint32_t GetPass(uint64_t key) { return static_cast<uint32_t>(key >> PassShift) & MaxPass; }
+        inline uint32_t GetPipeline(uint64_t key) { return static_cast<uint32_t>(key >> PipelineShift) & MaxPipeline; }
+        inline uint32_t GetMaterial(uint64_t key) { return static_cast<uint32_t>(key >> MaterialShift) & MaxMaterial; }
+        inline uint32_t GetMesh(uint64_t key) { return static_cast<uint32_t>(key >> MeshShift) & MaxMesh; }
+        // Everything but the depth, equal batch keys can be drawn as instances of one draw.
+        inline uint64_t GetBatchKey(uint64_t key) { return key >> DepthBits; }
+    }
+
+    // Per-instance data exactly as it is laid out in the instance buffer. Transform is column major.
+    struct DrawInstance {
+        float transform[16];
+    };
+
+    // One instanced draw after sorting, its instances are [firstInstance, firstInstance + instanceCount).
+    struct DrawBatch {
+        uint32_t pass = 0;
+        uint32_t pipeline = 0;
+        uint32_t material = 0;
+        uint32_t mesh = 0;
+        uint32_t firstInstance = 0;
+        uint32_t instanceCount = 0;
+    };
+
+    // Draws submitted over one frame. Not thread safe, it belongs to the thread that renders.
+    class DrawList {
+    public:
+        void Clear();
+        void Add(uint64_t key, const float transform[16]);
+
+        // Sorts by key and merges runs that share a batch key into instanced batches. Instances are reordered
+        // to match, so every batch reads a contiguous range.
+        void Build();
+
+        [[nodiscard]] bool IsEmpty() const { return m_Entries.empty(); }
+        [[nodiscard]] uint32_t GetDrawCount() const { return static_cast<uint32_t>(m_Entries.size()); }
+        // Valid after Build().
+        [[nodiscard]] const std::vector<DrawBatch>& GetBatches() const { return m_Batches; }
+        [[nodiscard]] const std::vector<DrawInstance>& GetInstances() const { return m_SortedInstances; }
+
+    private:
+        struct Entry {
+            uint64_t key;
+            uint32_t instance;
+        };
+
+        void RadixSort();
+
+        std::vector<Entry> m_Entries;
+        std::vector<Entry> m_Scratch;
+        std::vector<DrawInstance> m_Instances;
+        std::vector<DrawInstance> m_SortedInstances;
+        std::vector<DrawBatch> m_Batches;
+    };
+}
+#endif //REDPLASMA_DRAWLIST_H
\ No newline at end of file
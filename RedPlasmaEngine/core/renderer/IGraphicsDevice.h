@@ -13,16 +13,118 @@
 
 #ifndef REDPLASMA_IGRAPHICSDEVICE_H
 #define REDPLASMA_IGRAPHICSDEVICE_H
+#include <cstdint>
 #include <vector>
 
 #include "IWindowSurface.h"
 
 namespace RedPlasma {
+    class JobSystem;
+
 
     struct Vertex {
         float x, y, z;
     };
 
+    // Tightly packed RGBA8 pixels, rows top to bottom.
+    struct TextureDesc {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        const uint8_t* pixels = nullptr;
+    };
+
+    // Color multiplied with the default vertex tint and the texture.
+    struct MaterialDesc {
+        float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        // Handle from CreateTexture(), 0 is the built-in white texture.
+        int texture = 0;
+    };
+
+    // Requested presentation policy; unsupported modes fall back to one the surface offers (FIFO is always available).
+    enum class PresentMode {
+        Fifo,
+        Mailbox,
+        Immediate,
+        FifoRelaxed
+    };
+
+    struct GraphicsDeviceSettings {
+        // Number of frames the CPU may record ahead of the GPU.
+        uint32_t framesInFlight = 2;
+        // Initial size of the host visible transient space of every frame, which holds the draw instance data. It grows
+        // when a frame needs more.
+        uint64_t uploadBytesPerFrame = 4 * 1024 * 1024;
+        // Persistently mapped ring that mesh data is staged through on its way to device local memory.
+        uint64_t stagingBufferBytes = 32 * 1024 * 1024;
+        // Device local pools all meshes are placed in.
+        uint64_t meshVertexBufferBytes = 64 * 1024 * 1024;
+        uint64_t meshIndexBufferBytes = 64 * 1024 * 1024;
+        PresentMode presentMode = PresentMode::Fifo;
+        // Copy every presented image into host memory so ReadbackFrame() can return it.
+        bool enableReadback = false;
+        // Timestamp queries around the recorded passes, see GetGpuTimings().
+        bool enableGpuProfiling = true;
+        // Keeps compiled pipelines on disk between runs, see VulkanPipelineCache for the location.
+        bool enablePipelineCache = true;
+        // Draws per secondary command buffer when recording on the job system, smaller frames record inline.
+        uint32_t drawsPerRecordJob = 256;
+        // Frustum culling and draw generation in compute, issued with one indirect count draw. Devices without
+        // drawIndirectCount and multiDrawIndirect keep recording the draws on the CPU.
+        bool enableGpuCulling = true;
+        // Draws that stay the same from one frame to the next are recorded once per frame context into a
+        // secondary command buffer and replayed from there until the draw list, camera or swapchain changes.
+        bool cacheStaticDraws = true;
+    };
+
+    // CPU side timings of the last DrawFrame() call, in milliseconds.
+    struct FrameStats {
+        double waitMs = 0.0;    // frame fence wait + image acquire
+        double recordMs = 0.0;  // command buffer recording
+        double submitMs = 0.0;  // queue submit + present
+        double totalMs = 0.0;
+        uint64_t frameNumber = 0;
+        // Draw recording time per job system thread, indexed by JobSystem::GetCurrentThreadIndex().
+        std::vector<double> recordThreadMs;
+        uint32_t recordJobs = 0;
+        // Draws submitted for the frame and the instanced draw calls they were merged into. With GPU culling
+        // drawCalls is the upper bound, batches without a visible instance are dropped on the GPU.
+        uint32_t submittedDraws = 0;
+        uint32_t drawCalls = 0;
+        // The draws came from a cached secondary, nothing was recorded for them this frame.
+        bool drawsReplayed = false;
+    };
+
+    // GPU duration of one profiled zone, resolved a few frames after it was recorded.
+    struct GpuZoneTiming {
+        const char* name = nullptr;
+        double milliseconds = 0.0;
+        uint32_t depth = 0;
+    };
+
+    // Device memory usage as seen by the engine's allocator.
+    struct GpuMemoryStats {
+        // vkAllocateMemory calls that are currently alive, split into shared blocks and dedicated allocations.
+        uint64_t blockCount = 0;
+        uint64_t dedicatedCount = 0;
+        uint64_t allocationCount = 0;
+        uint64_t reservedBytes = 0;
+        // Bytes handed out to resources, including rounding inside the blocks.
+        uint64_t usedBytes = 0;
+        uint64_t largestFreeBytes = 0;
+        // Share of free bytes that the largest possible allocation of its block cannot use, 0 when nothing is split.
+        double fragmentation = 0.0;
+    };
+
+    // What the next DrawFrame() will draw so far.
+    enum class PendingDrawList {
+        // Nothing submitted or reused since the last frame.
+        None,
+        // Draws were submitted for this frame.
+        Submitted,
+        // The previous frame's list is drawn again, draws submitted on top of it are appended to it.
+        Reused
+    };
+
     struct NativeWindowHandle{
         void* window;
         void* display;
@@ -35,13 +137,46 @@ namespace RedPlasma {
         virtual int Initialize() = 0;
         virtual int Shutdown() = 0;
 
+        // Must be called before Initialize().
+        virtual void Configure(const GraphicsDeviceSettings& settings) = 0;
+        // Optional, without one all recording happens on the calling thread. Set before Initialize().
+        virtual void SetJobSystem(JobSystem* jobSystem) = 0;
+
         virtual void AddExtension(const std::vector<const char*> &extensions) = 0;
 
         virtual int CreateSurface(IWindowSurface* windowHandle) = 0;
 
+        // The window surface changed size, the swapchain is rebuilt before the next frame.
+        virtual void OnSurfaceResized() = 0;
+        virtual void SetPresentMode(PresentMode mode) = 0;
+
+        // Mesh data is copied to the GPU with the next frame. Returns a mesh handle (> 0) or a negative error.
         virtual int UploadMeshData(const std::vector<Vertex>& vertices) = 0;
+        virtual int UploadMeshData(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) = 0;
+        // Returns a texture handle (> 0) or a negative error. Safe from any thread, like the mesh uploads.
+        virtual int CreateTexture(const TextureDesc& desc) = 0;
+        // Returns a material handle (> 0) or a negative error. Handle 0 is the built-in white material.
+        virtual int CreateMaterial(const MaterialDesc& desc) = 0;
+
+        // Draw submission for the next DrawFrame(), only from the thread that calls it. The list is consumed by
+        // the frame, so every frame submits everything it wants drawn. Matrices are column major.
+        virtual void SetViewProjection(const float viewProjection[16]) = 0;
+        virtual int SubmitDraw(int mesh, int material, const float transform[16]) = 0;
+        // Draws the previous frame's list again instead of submitting it, which lets the device replay the
+        // recorded draws as well. Fails when there is no previous list or this frame already submitted draws.
+        virtual int ReuseLastDrawList() = 0;
+        [[nodiscard]] virtual PendingDrawList GetPendingDrawList() const = 0;
         virtual int DrawFrame() = 0;
+        // RGBA8 pixels of the last submitted frame, waits for that frame to finish. Requires enableReadback.
+        virtual int ReadbackFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) = 0;
         virtual const char* GetDeviceName() = 0;
+        [[nodiscard]] virtual const FrameStats& GetFrameStats() const = 0;
+        // Zones of the most recently resolved frame, in recording order. Empty if profiling is unavailable.
+        [[nodiscard]] virtual const std::vector<GpuZoneTiming>& GetGpuTimings() const = 0;
+        [[nodiscard]] virtual GpuMemoryStats GetMemoryStats() const = 0;
+        // Highest FrameStats::frameNumber the GPU is known to have finished. May be read from any thread.
+        [[nodiscard]] virtual uint64_t GetCompletedFrameNumber() const = 0;
+        virtual void WaitIdle() = 0;
     };
 }
 #endif //REDPLASMA_IGRAPHICSDEVICE_H
\ No newline at end of file
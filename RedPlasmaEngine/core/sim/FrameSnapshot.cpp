@@ -0,0 +1,63 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "FrameSnapshot.h"
+
+#include <algorithm>
+
+namespace RedPlasma {
+    void InterpolateSnapshots(const FrameSnapshot& previous, const FrameSnapshot& next, float alpha, FrameSnapshot& out) {
+        out.tick = next.tick;
+        out.time = previous.time + (next.time - previous.time) * alpha;
+        out.objects = next.objects;
+
+        size_t shared = std::min(previous.objects.size(), next.objects.size());
+        for (size_t i = 0; i < shared; i++) {
+            const RenderObject& from = previous.objects[i];
+            if (from.mesh != next.objects[i].mesh) {
+                continue;
+            }
+            RenderObject& object = out.objects[i];
+            for (int element = 0; element < 16; element++) {
+                object.transform[element] = from.transform[element] + (object.transform[element] - from.transform[element]) * alpha;
+            }
+        }
+    }
+
+    SnapshotQueue::SnapshotQueue(uint32_t capacity) : m_Capacity(capacity > 0 ? capacity : 1) {
+    }
+
+    void SnapshotQueue::Push(std::shared_ptr<const FrameSnapshot> snapshot) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Snapshots.size() >= m_Capacity) {
+            m_Snapshots.pop_front();
+            m_Dropped++;
+        }
+        m_Snapshots.push_back(std::move(snapshot));
+    }
+
+    std::shared_ptr<const FrameSnapshot> SnapshotQueue::TryPop() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Snapshots.empty()) {
+            return nullptr;
+        }
+        std::shared_ptr<const FrameSnapshot> snapshot = std::move(m_Snapshots.front());
+        m_Snapshots.pop_front();
+        return snapshot;
+    }
+
+    uint64_t SnapshotQueue::GetDroppedCount() const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Dropped;
+    }
+}
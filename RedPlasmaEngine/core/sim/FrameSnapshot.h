@@ -0,0 +1,67 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_FRAMESNAPSHOT_H
+#define REDPLASMA_FRAMESNAPSHOT_H
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace RedPlasma {
+    // One drawable as the simulation left it at the end of a tick. Transform is column major.
+    struct RenderObject {
+        int mesh = 0;
+        // 0 is the device's default material.
+        int material = 0;
+        float transform[16] = {
+            1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+    };
+
+    // Everything the renderer needs from one simulation tick. Never modified once it has been queued,
+    // so the render thread reads it without locks.
+    struct FrameSnapshot {
+        uint64_t tick = 0;
+        // Simulation time at the end of the tick, in seconds since the threaded mode started.
+        double time = 0.0;
+        std::vector<RenderObject> objects;
+    };
+
+    // Blends transforms of objects that sit at the same index with the same mesh in both snapshots, everything
+    // else is taken from next. Matrices are blended per element, fine for the small steps between two ticks.
+    void InterpolateSnapshots(const FrameSnapshot& previous, const FrameSnapshot& next, float alpha, FrameSnapshot& out);
+
+    // Bounded hand-off from the simulation thread to the render thread. When the render thread falls behind the
+    // oldest snapshot is dropped, so the simulation keeps its fixed rate and latency stays bounded.
+    class SnapshotQueue {
+    public:
+        explicit SnapshotQueue(uint32_t capacity);
+
+        void Push(std::shared_ptr<const FrameSnapshot> snapshot);
+        // Returns nullptr when the queue is empty.
+        std::shared_ptr<const FrameSnapshot> TryPop();
+        [[nodiscard]] uint64_t GetDroppedCount() const;
+
+    private:
+        mutable std::mutex m_Mutex;
+        std::deque<std::shared_ptr<const FrameSnapshot>> m_Snapshots;
+        uint32_t m_Capacity;
+        uint64_t m_Dropped = 0;
+    };
+}
+#endif //REDPLASMA_FRAMESNAPSHOT_H
\ No newline at end of file
@@ -0,0 +1,678 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "Bvh.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "jobs/JobSystem.h"
+
+namespace RedPlasma {
+    namespace {
+        constexpr uint32_t SahBins = 16;
+        constexpr uint32_t AllPlanes = 0x3F;
+        // Subtrees a parallel frustum query aims for per thread, a few so uneven subtrees still balance out.
+        constexpr size_t ParallelQueryTasksPerThread = 4;
+        constexpr size_t ParallelQueryMaxTasks = 64;
+        // Below this many items the serial query finishes before the jobs would have been picked up.
+        constexpr uint32_t ParallelQueryMinItems = 16384;
+        // Levels the parallel query descends at most while looking for enough subtrees.
+        constexpr uint32_t ParallelQueryMaxLevels = 16;
+        constexpr uint32_t StaticHandleBit = 0x80000000u;
+        // The dynamic tree is rebuilt once its inner area grew this much since its last build.
+        constexpr float DynamicRebuildFactor = 1.5f;
+
+        Aabb EmptyAabb() {
+            constexpr float infinity = std::numeric_limits<float>::infinity();
+            return {{infinity, infinity, infinity}, {-infinity, -infinity, -infinity}};
+        }
+
+        Vec3 GetCenter(const Aabb& bounds) {
+            return (bounds.min + bounds.max) * 0.5f;
+        }
+
+        float GetAxis(const Vec3& v, uint32_t axis) {
+            return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+        }
+
+        bool SameBounds(const Aabb& a, const Aabb& b) {
+            return a.min.x == b.min.x && a.min.y == b.min.y && a.min.z == b.min.z
+                && a.max.x == b.max.x && a.max.y == b.max.y && a.max.z == b.max.z;
+        }
+
+        // Returns false when the box is outside one of the planes in mask, and clears the planes it is fully
+        // inside of so the children skip them.
+        bool TestPlanes(const Frustum& frustum, const Aabb& bounds, uint32_t& mask) {
+            Vec3 center = GetCenter(bounds);
+            Vec3 extent = (bounds.max - bounds.min) * 0.5f;
+            for (uint32_t plane = 0; plane < 6; plane++) {
+                if ((mask & (1u << plane)) == 0) {
+                    continue;
+                }
+                const Vec4& p = frustum.planes[plane];
+                float distance = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+                float radius = std::fabs(p.x) * extent.x + std::fabs(p.y) * extent.y + std::fabs(p.z) * extent.z;
+                if (distance + radius < 0.0f) {
+                    return false;
+                }
+                if (distance - radius >= 0.0f) {
+                    mask &= ~(1u << plane);
+                }
+            }
+            return true;
+        }
+
+        // Distance at which the ray enters the box, negative when it misses it.
+        float IntersectRay(const Aabb& bounds, const Vec3& origin, const Vec3& inverseDirection, float maxDistance) {
+            float t1 = (bounds.min.x - origin.x) * inverseDirection.x;
+            float t2 = (bounds.max.x - origin.x) * inverseDirection.x;
+            float enter = std::fmin(t1, t2);
+            float exit = std::fmax(t1, t2);
+            t1 = (bounds.min.y - origin.y) * inverseDirection.y;
+            t2 = (bounds.max.y - origin.y) * inverseDirection.y;
+            enter = std::fmax(enter, std::fmin(t1, t2));
+            exit = std::fmin(exit, std::fmax(t1, t2));
+            t1 = (bounds.min.z - origin.z) * inverseDirection.z;
+            t2 = (bounds.max.z - origin.z) * inverseDirection.z;
+            enter = std::fmax(enter, std::fmin(t1, t2));
+            exit = std::fmin(exit, std::fmax(t1, t2));
+            enter = std::fmax(enter, 0.0f);
+            exit = std::fmin(exit, maxDistance);
+            return enter <= exit ? enter : -1.0f;
+        }
+    }
+
+    void Bvh::Build(const Aabb* bounds, const uint32_t* ids, uint32_t count) {
+        Clear();
+        m_Proxies.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            AllocateProxy(Fatten(bounds[i]), ids[i]);
+        }
+        Rebuild();
+    }
+
+    void Bvh::Rebuild() {
+        m_Nodes.clear();
+        m_Root = NullNode;
+        m_FreeNode = NullNode;
+        m_NodeCount = 0;
+        m_InnerArea = 0.0;
+
+        std::vector<int32_t> proxies;
+        proxies.reserve(m_ItemCount);
+        for (size_t i = 0; i < m_Proxies.size(); i++) {
+            if (m_Proxies[i].alive) {
+                proxies.push_back(static_cast<int32_t>(i));
+            }
+        }
+        if (proxies.empty()) {
+            return;
+        }
+        m_Nodes.reserve(proxies.size() * 2 - 1);
+        m_Root = BuildRange(proxies.data(), static_cast<uint32_t>(proxies.size()));
+    }
+
+    void Bvh::Clear() {
+        m_Nodes.clear();
+        m_Proxies.clear();
+        m_Root = NullNode;
+        m_FreeNode = NullNode;
+        m_FreeProxy = NullNode;
+        m_NodeCount = 0;
+        m_ItemCount = 0;
+        m_InnerArea = 0.0;
+    }
+
+    int32_t Bvh::Insert(const Aabb& bounds, uint32_t id) {
+        int32_t proxy = AllocateProxy(Fatten(bounds), id);
+        int32_t leaf = AllocateNode();
+        m_Nodes[leaf].bounds = m_Proxies[proxy].bounds;
+        m_Nodes[leaf].proxy = proxy;
+        m_Proxies[proxy].leaf = leaf;
+        LinkLeaf(leaf);
+        return proxy;
+    }
+
+    int32_t Bvh::InsertDeferred(const Aabb& bounds, uint32_t id) {
+        return AllocateProxy(Fatten(bounds), id);
+    }
+
+    void Bvh::Remove(int32_t proxy) {
+        Proxy& item = m_Proxies[proxy];
+        if (item.leaf != NullNode) {
+            UnlinkLeaf(item.leaf);
+            FreeNode(item.leaf);
+        }
+        item.alive = false;
+        item.leaf = m_FreeProxy;
+        m_FreeProxy = proxy;
+        m_ItemCount--;
+    }
+
+    bool Bvh::Update(int32_t proxy, const Aabb& bounds) {
+        Proxy& item = m_Proxies[proxy];
+        if (Contains(item.bounds, bounds)) {
+            return false;
+        }
+        Aabb previous = item.bounds;
+        item.bounds = Fatten(bounds);
+        if (item.leaf == NullNode) {
+            return false;
+        }
+        int32_t leaf = item.leaf;
+        // A jump to somewhere else would stretch every ancestor across the gap, such leaves are reinserted.
+        if (!Overlaps(previous, item.bounds)) {
+            UnlinkLeaf(leaf);
+            m_Nodes[leaf].bounds = item.bounds;
+            LinkLeaf(leaf);
+            return true;
+        }
+        m_Nodes[leaf].bounds = item.bounds;
+        Refit(m_Nodes[leaf].parent);
+        return true;
+    }
+
+    uint32_t Bvh::GetDepth() const {
+        if (m_Root == NullNode) {
+            return 0;
+        }
+        uint32_t depth = 0;
+        std::vector<std::pair<int32_t, uint32_t>> stack {{m_Root, 1}};
+        while (!stack.empty()) {
+            auto [node, level] = stack.back();
+            stack.pop_back();
+            depth = std::max(depth, level);
+            if (!m_Nodes[node].IsLeaf()) {
+                stack.emplace_back(m_Nodes[node].children[0], level + 1);
+                stack.emplace_back(m_Nodes[node].children[1], level + 1);
+            }
+        }
+        return depth;
+    }
+
+    float Bvh::GetQuality() const {
+        if (m_Root == NullNode) {
+            return 0.0f;
+        }
+        float rootArea = HalfArea(m_Nodes[m_Root].bounds);
+        return rootArea > 0.0f ? static_cast<float>(m_InnerArea / rootArea) : 0.0f;
+    }
+
+    void Bvh::QueryAabb(const Aabb& bounds, std::vector<uint32_t>& ids) const {
+        if (m_Root == NullNode) {
+            return;
+        }
+        std::vector<int32_t> stack {m_Root};
+        while (!stack.empty()) {
+            const Node& node = m_Nodes[stack.back()];
+            stack.pop_back();
+            if (!Overlaps(node.bounds, bounds)) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                ids.push_back(m_Proxies[node.proxy].id);
+            } else {
+                stack.push_back(node.children[1]);
+                stack.push_back(node.children[0]);
+            }
+        }
+    }
+
+    void Bvh::QueryRay(const Ray& ray, std::vector<RayHit>& hits) const {
+        if (m_Root == NullNode) {
+            return;
+        }
+        Vec3 inverseDirection {1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+        float rootDistance = IntersectRay(m_Nodes[m_Root].bounds, ray.origin, inverseDirection, ray.maxDistance);
+        if (rootDistance < 0.0f) {
+            return;
+        }
+
+        // Every node on the stack has been hit already.
+        std::vector<std::pair<int32_t, float>> stack {{m_Root, rootDistance}};
+        while (!stack.empty()) {
+            auto [index, distance] = stack.back();
+            stack.pop_back();
+            const Node& node = m_Nodes[index];
+            if (node.IsLeaf()) {
+                hits.push_back({m_Proxies[node.proxy].id, distance});
+                continue;
+            }
+            float near = IntersectRay(m_Nodes[node.children[0]].bounds, ray.origin, inverseDirection, ray.maxDistance);
+            float far = IntersectRay(m_Nodes[node.children[1]].bounds, ray.origin, inverseDirection, ray.maxDistance);
+            int32_t nearChild = node.children[0];
+            int32_t farChild = node.children[1];
+            if (far >= 0.0f && (near < 0.0f || far < near)) {
+                std::swap(near, far);
+                std::swap(nearChild, farChild);
+            }
+            if (far >= 0.0f) {
+                stack.emplace_back(farChild, far);
+            }
+            if (near >= 0.0f) {
+                stack.emplace_back(nearChild, near);
+            }
+        }
+    }
+
+    void Bvh::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& ids) const {
+        if (m_Root != NullNode) {
+            CullSubtree(frustum, m_Root, AllPlanes, ids);
+        }
+    }
+
+    void Bvh::QueryFrustumParallel(const Frustum& frustum, JobSystem& jobSystem, std::vector<uint32_t>& ids) const {
+        if (m_Root == NullNode) {
+            return;
+        }
+        if (m_ItemCount < ParallelQueryMinItems) {
+            CullSubtree(frustum, m_Root, AllPlanes, ids);
+            return;
+        }
+
+        // Expand the culled tree level by level in depth first order, until there are enough subtrees to hand out.
+        size_t taskCount = std::min(ParallelQueryMaxTasks, (jobSystem.GetWorkerCount() + 1) * ParallelQueryTasksPerThread);
+        std::vector<std::pair<int32_t, uint32_t>> subtrees {{m_Root, AllPlanes}};
+        std::vector<std::pair<int32_t, uint32_t>> expanded;
+        for (uint32_t level = 0; level < ParallelQueryMaxLevels && subtrees.size() < taskCount; level++) {
+            expanded.clear();
+            bool split = false;
+            for (auto [index, mask] : subtrees) {
+                const Node& node = m_Nodes[index];
+                if (mask != 0 && !TestPlanes(frustum, node.bounds, mask)) {
+                    continue;
+                }
+                if (mask == 0 || node.IsLeaf()) {
+                    expanded.emplace_back(index, mask);
+                } else {
+                    expanded.emplace_back(node.children[0], mask);
+                    expanded.emplace_back(node.children[1], mask);
+                    split = true;
+                }
+            }
+            subtrees.swap(expanded);
+            if (!split) {
+                break;
+            }
+        }
+        // At most one subtree survived the expansion, there is nothing to spread over the workers.
+        if (subtrees.size() < 2) {
+            for (auto [index, mask] : subtrees) {
+                CullSubtree(frustum, index, mask, ids);
+            }
+            return;
+        }
+
+        std::vector<std::vector<uint32_t>> results(subtrees.size());
+        jobSystem.ParallelFor(static_cast<uint32_t>(subtrees.size()), 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                CullSubtree(frustum, subtrees[i].first, subtrees[i].second, results[i]);
+            }
+        });
+        size_t total = ids.size();
+        for (const std::vector<uint32_t>& result : results) {
+            total += result.size();
+        }
+        ids.reserve(total);
+        for (const std::vector<uint32_t>& result : results) {
+            ids.insert(ids.end(), result.begin(), result.end());
+        }
+    }
+
+    int32_t Bvh::AllocateProxy(const Aabb& bounds, uint32_t id) {
+        int32_t proxy;
+        if (m_FreeProxy != NullNode) {
+            proxy = m_FreeProxy;
+            m_FreeProxy = m_Proxies[proxy].leaf;
+        } else {
+            proxy = static_cast<int32_t>(m_Proxies.size());
+            m_Proxies.emplace_back();
+        }
+        Proxy& item = m_Proxies[proxy];
+        item.bounds = bounds;
+        item.id = id;
+        item.leaf = NullNode;
+        item.alive = true;
+        m_ItemCount++;
+        return proxy;
+    }
+
+    int32_t Bvh::AllocateNode() {
+        int32_t node;
+        if (m_FreeNode != NullNode) {
+            node = m_FreeNode;
+            m_FreeNode = m_Nodes[node].parent;
+            m_Nodes[node] = Node{};
+        } else {
+            node = static_cast<int32_t>(m_Nodes.size());
+            m_Nodes.emplace_back();
+        }
+        m_NodeCount++;
+        return node;
+    }
+
+    void Bvh::FreeNode(int32_t node) {
+        m_Nodes[node] = Node{};
+        m_Nodes[node].parent = m_FreeNode;
+        m_FreeNode = node;
+        m_NodeCount--;
+    }
+
+    void Bvh::LinkLeaf(int32_t leaf) {
+        if (m_Root == NullNode) {
+            m_Root = leaf;
+            m_Nodes[leaf].parent = NullNode;
+            return;
+        }
+
+        // Walk down to the sibling that grows the tree's area the least, paying for the area every ancestor
+        // gains on the way (the branch and bound descent of Box2D's dynamic tree).
+        Aabb bounds = m_Nodes[leaf].bounds;
+        int32_t index = m_Root;
+        while (!m_Nodes[index].IsLeaf()) {
+            const Node& node = m_Nodes[index];
+            float area = HalfArea(node.bounds);
+            float combinedArea = HalfArea(Union(node.bounds, bounds));
+            float cost = 2.0f * combinedArea;
+            float inheritance = 2.0f * (combinedArea - area);
+
+            float childCosts[2];
+            for (int child = 0; child < 2; child++) {
+                const Node& childNode = m_Nodes[node.children[child]];
+                float unionArea = HalfArea(Union(childNode.bounds, bounds));
+                childCosts[child] = childNode.IsLeaf() ? unionArea + inheritance : unionArea - HalfArea(childNode.bounds) + inheritance;
+            }
+            if (cost < childCosts[0] && cost < childCosts[1]) {
+                break;
+            }
+            index = childCosts[0] <= childCosts[1] ? node.children[0] : node.children[1];
+        }
+
+        int32_t sibling = index;
+        int32_t oldParent = m_Nodes[sibling].parent;
+        int32_t newParent = AllocateNode();
+        Node& parent = m_Nodes[newParent];
+        parent.parent = oldParent;
+        parent.children[0] = sibling;
+        parent.children[1] = leaf;
+        parent.bounds = Union(m_Nodes[sibling].bounds, bounds);
+        m_InnerArea += HalfArea(parent.bounds);
+        m_Nodes[sibling].parent = newParent;
+        m_Nodes[leaf].parent = newParent;
+
+        if (oldParent == NullNode) {
+            m_Root = newParent;
+            return;
+        }
+        Node& grandParent = m_Nodes[oldParent];
+        grandParent.children[grandParent.children[0] == sibling ? 0 : 1] = newParent;
+        Refit(oldParent);
+    }
+
+    void Bvh::UnlinkLeaf(int32_t leaf) {
+        if (leaf == m_Root) {
+            m_Root = NullNode;
+            return;
+        }
+
+        int32_t parent = m_Nodes[leaf].parent;
+        int32_t grandParent = m_Nodes[parent].parent;
+        int32_t sibling = m_Nodes[parent].children[0] == leaf ? m_Nodes[parent].children[1] : m_Nodes[parent].children[0];
+        m_InnerArea -= HalfArea(m_Nodes[parent].bounds);
+        FreeNode(parent);
+        m_Nodes[leaf].parent = NullNode;
+        m_Nodes[sibling].parent = grandParent;
+
+        if (grandParent == NullNode) {
+            m_Root = sibling;
+            return;
+        }
+        Node& node = m_Nodes[grandParent];
+        node.children[node.children[0] == parent ? 0 : 1] = sibling;
+        Refit(grandParent);
+    }
+
+    void Bvh::Refit(int32_t node) {
+        while (node != NullNode) {
+            const Node& current = m_Nodes[node];
+            Aabb bounds = Union(m_Nodes[current.children[0]].bounds, m_Nodes[current.children[1]].bounds);
+            // Inner bounds are always the exact union of their children, so nothing above changes either.
+            if (SameBounds(bounds, current.bounds)) {
+                return;
+            }
+            SetBounds(node, bounds);
+            node = m_Nodes[node].parent;
+        }
+    }
+
+    void Bvh::SetBounds(int32_t node, const Aabb& bounds) {
+        m_InnerArea += static_cast<double>(HalfArea(bounds)) - HalfArea(m_Nodes[node].bounds);
+        m_Nodes[node].bounds = bounds;
+    }
+
+    int32_t Bvh::BuildRange(const int32_t* proxies, uint32_t count) {
+        struct Task {
+            int32_t parent;
+            int32_t slot;
+            uint32_t begin;
+            uint32_t end;
+        };
+        struct Bin {
+            Aabb bounds = EmptyAabb();
+            uint32_t count = 0;
+        };
+
+        // Bounds and centers are copied out of the proxies and partitioned in place, so every level of the
+        // build streams through memory instead of chasing proxy indices.
+        std::vector<BuildItem> items(count);
+        for (uint32_t i = 0; i < count; i++) {
+            const Aabb& bounds = m_Proxies[proxies[i]].bounds;
+            items[i] = {bounds, GetCenter(bounds), proxies[i]};
+        }
+
+        int32_t root = NullNode;
+        std::vector<Task> tasks {{NullNode, 0, 0, count}};
+        while (!tasks.empty()) {
+            Task task = tasks.back();
+            tasks.pop_back();
+
+            int32_t index = AllocateNode();
+            m_Nodes[index].parent = task.parent;
+            if (task.parent == NullNode) {
+                root = index;
+            } else {
+                m_Nodes[task.parent].children[task.slot] = index;
+            }
+
+            if (task.end - task.begin == 1) {
+                const BuildItem& item = items[task.begin];
+                m_Nodes[index].bounds = item.bounds;
+                m_Nodes[index].proxy = item.proxy;
+                m_Proxies[item.proxy].leaf = index;
+                continue;
+            }
+
+            Aabb bounds = EmptyAabb();
+            Aabb centers = EmptyAabb();
+            for (uint32_t i = task.begin; i < task.end; i++) {
+                bounds = Union(bounds, items[i].bounds);
+                centers = Union(centers, Aabb{items[i].center, items[i].center});
+            }
+            m_Nodes[index].bounds = bounds;
+            m_InnerArea += HalfArea(bounds);
+
+            // Binned SAH over all three axes in one pass: the split minimizing count * area on both sides wins.
+            Bin bins[3][SahBins];
+            float low[3];
+            float scale[3];
+            for (uint32_t axis = 0; axis < 3; axis++) {
+                low[axis] = GetAxis(centers.min, axis);
+                float extent = GetAxis(centers.max, axis) - low[axis];
+                scale[axis] = extent > 0.0f ? static_cast<float>(SahBins) / extent : 0.0f;
+            }
+            for (uint32_t i = task.begin; i < task.end; i++) {
+                for (uint32_t axis = 0; axis < 3; axis++) {
+                    auto bin = std::min(static_cast<uint32_t>((GetAxis(items[i].center, axis) - low[axis]) * scale[axis]), SahBins - 1);
+                    bins[axis][bin].bounds = Union(bins[axis][bin].bounds, items[i].bounds);
+                    bins[axis][bin].count++;
+                }
+            }
+
+            float bestCost = std::numeric_limits<float>::infinity();
+            uint32_t bestAxis = 0;
+            uint32_t bestSplit = 0;
+            for (uint32_t axis = 0; axis < 3; axis++) {
+                if (scale[axis] == 0.0f) {
+                    continue;
+                }
+                float rightAreas[SahBins];
+                uint32_t rightCounts[SahBins];
+                Aabb right = EmptyAabb();
+                uint32_t rightCount = 0;
+                for (uint32_t bin = SahBins - 1; bin > 0; bin--) {
+                    right = Union(right, bins[axis][bin].bounds);
+                    rightCount += bins[axis][bin].count;
+                    rightAreas[bin] = HalfArea(right);
+                    rightCounts[bin] = rightCount;
+                }
+                Aabb left = EmptyAabb();
+                uint32_t leftCount = 0;
+                for (uint32_t split = 1; split < SahBins; split++) {
+                    left = Union(left, bins[axis][split - 1].bounds);
+                    leftCount += bins[axis][split - 1].count;
+                    if (leftCount == 0 || rightCounts[split] == 0) {
+                        continue;
+                    }
+                    float cost = static_cast<float>(leftCount) * HalfArea(left) + static_cast<float>(rightCounts[split]) * rightAreas[split];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+
+            uint32_t middle;
+            if (bestSplit == 0) {
+                // All centers coincide, any split is as good as another.
+                middle = task.begin + (task.end - task.begin) / 2;
+            } else {
+                BuildItem* split = std::partition(items.data() + task.begin, items.data() + task.end, [&](const BuildItem& item) {
+                    auto bin = std::min(static_cast<uint32_t>((GetAxis(item.center, bestAxis) - low[bestAxis]) * scale[bestAxis]), SahBins - 1);
+                    return bin < bestSplit;
+                });
+                middle = static_cast<uint32_t>(split - items.data());
+            }
+            // Right first, so the left child ends up right behind its parent.
+            tasks.push_back({index, 1, middle, task.end});
+            tasks.push_back({index, 0, task.begin, middle});
+        }
+        return root;
+    }
+
+    void Bvh::CollectLeaves(int32_t node, std::vector<uint32_t>& ids) const {
+        std::vector<int32_t> stack {node};
+        while (!stack.empty()) {
+            const Node& current = m_Nodes[stack.back()];
+            stack.pop_back();
+            if (current.IsLeaf()) {
+                ids.push_back(m_Proxies[current.proxy].id);
+            } else {
+                stack.push_back(current.children[1]);
+                stack.push_back(current.children[0]);
+            }
+        }
+    }
+
+    void Bvh::CullSubtree(const Frustum& frustum, int32_t node, uint32_t planeMask, std::vector<uint32_t>& ids) const {
+        std::vector<std::pair<int32_t, uint32_t>> stack {{node, planeMask}};
+        while (!stack.empty()) {
+            auto [index, mask] = stack.back();
+            stack.pop_back();
+            const Node& current = m_Nodes[index];
+            if (mask != 0 && !TestPlanes(frustum, current.bounds, mask)) {
+                continue;
+            }
+            // Entirely inside: everything below is visible without another plane test.
+            if (mask == 0) {
+                CollectLeaves(index, ids);
+            } else if (current.IsLeaf()) {
+                ids.push_back(m_Proxies[current.proxy].id);
+            } else {
+                stack.emplace_back(current.children[1], mask);
+                stack.emplace_back(current.children[0], mask);
+            }
+        }
+    }
+
+    Aabb Bvh::Fatten(const Aabb& bounds) const {
+        Vec3 margin {m_Margin, m_Margin, m_Margin};
+        return {bounds.min - margin, bounds.max + margin};
+    }
+
+    uint32_t SpatialIndex::Add(const Aabb& bounds, uint32_t id, bool isStatic) {
+        if (isStatic) {
+            m_StaticDirty = true;
+            return static_cast<uint32_t>(m_Static.InsertDeferred(bounds, id)) | StaticHandleBit;
+        }
+        return static_cast<uint32_t>(m_Dynamic.Insert(bounds, id));
+    }
+
+    void SpatialIndex::Remove(uint32_t handle) {
+        if (handle & StaticHandleBit) {
+            m_Static.Remove(static_cast<int32_t>(handle & ~StaticHandleBit));
+        } else {
+            m_Dynamic.Remove(static_cast<int32_t>(handle));
+        }
+    }
+
+    void SpatialIndex::Update(uint32_t handle, const Aabb& bounds) {
+        if (handle & StaticHandleBit) {
+            m_Static.Update(static_cast<int32_t>(handle & ~StaticHandleBit), bounds);
+        } else {
+            m_Dynamic.Update(static_cast<int32_t>(handle), bounds);
+        }
+    }
+
+    void SpatialIndex::Commit() {
+        if (m_StaticDirty) {
+            m_Static.Rebuild();
+            m_StaticDirty = false;
+        }
+        if (m_Dynamic.GetInnerArea() > m_DynamicBuildArea * DynamicRebuildFactor) {
+            m_Dynamic.Rebuild();
+            m_DynamicBuildArea = m_Dynamic.GetInnerArea();
+        }
+    }
+
+    void SpatialIndex::QueryAabb(const Aabb& bounds, std::vector<uint32_t>& ids) const {
+        m_Static.QueryAabb(bounds, ids);
+        m_Dynamic.QueryAabb(bounds, ids);
+    }
+
+    void SpatialIndex::QueryRay(const Ray& ray, std::vector<RayHit>& hits) const {
+        m_Static.QueryRay(ray, hits);
+        m_Dynamic.QueryRay(ray, hits);
+    }
+
+    void SpatialIndex::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& ids) const {
+        m_Static.QueryFrustum(frustum, ids);
+        m_Dynamic.QueryFrustum(frustum, ids);
+    }
+
+    void SpatialIndex::QueryFrustumParallel(const Frustum& frustum, JobSystem& jobSystem, std::vector<uint32_t>& ids) const {
+        m_Static.QueryFrustumParallel(frustum, jobSystem, ids);
+        m_Dynamic.QueryFrustumParallel(frustum, jobSystem, ids);
+    }
+}
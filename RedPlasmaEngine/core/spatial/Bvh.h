@@ -0,0 +1,192 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_BVH_H
+#define REDPLASMA_BVH_H
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "math/MathBatch.h"
+#include "math/Vector.h"
+
+namespace RedPlasma {
+    class JobSystem;
+
+    struct Aabb {
+        Vec3 min;
+        Vec3 max;
+    };
+
+    // direction does not have to be normalized, distances are in multiples of it.
+    struct Ray {
+        Vec3 origin;
+        Vec3 direction {0.0f, 0.0f, 1.0f};
+        float maxDistance = std::numeric_limits<float>::infinity();
+    };
+
+    // An item whose bounds the ray enters at distance (0 when the origin is inside).
+    struct RayHit {
+        uint32_t id = 0;
+        float distance = 0.0f;
+    };
+
+    // std::min/max instead of Min()/Max(): no NaN handling, but they compile to single instructions and the
+    // tree builds and refits spend most of their time here.
+    inline Aabb Union(const Aabb& a, const Aabb& b) {
+        return {{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+                {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)}};
+    }
+    inline bool Contains(const Aabb& outer, const Aabb& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+            && outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+    }
+    inline bool Overlaps(const Aabb& a, const Aabb& b) {
+        return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y
+            && a.min.z <= b.max.z && a.max.z >= b.min.z;
+    }
+    // Half the surface area, the SAH only ever compares areas.
+    inline float HalfArea(const Aabb& a) {
+        Vec3 size = a.max - a.min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    // Bounding volume hierarchy with one item per leaf. Items are addressed by the proxy Insert() returns,
+    // which stays valid across rebuilds until the item is removed.
+    //
+    // Build() and Rebuild() make a binned SAH tree in one batch, the path for objects that rarely move.
+    // Insert() links items one by one and Update() refits the path above a moved leaf, which is cheap but lets
+    // the tree drift away from a good SAH split; GetInnerArea() tells when a Rebuild() pays off again.
+    //
+    // Queries append to their output and only read the tree, any number of them may run at the same time as
+    // long as nothing modifies it.
+    class Bvh {
+    public:
+        // Leaves are fattened by margin on every side, so an item moving within it needs no refit at all.
+        explicit Bvh(float margin = 0.0f) : m_Margin(margin) {}
+
+        // Replaces the contents, the proxy of item i is i.
+        void Build(const Aabb* bounds, const uint32_t* ids, uint32_t count);
+        // Rebuilds the tree over the current items, proxies are kept.
+        void Rebuild();
+        void Clear();
+
+        int32_t Insert(const Aabb& bounds, uint32_t id);
+        // Added without touching the tree, the item is found by queries after the next Rebuild().
+        int32_t InsertDeferred(const Aabb& bounds, uint32_t id);
+        void Remove(int32_t proxy);
+        // Returns true when the leaf had to be refit. A leaf moved away from its old bounds is reinserted instead.
+        bool Update(int32_t proxy, const Aabb& bounds);
+
+        [[nodiscard]] uint32_t GetItemCount() const { return m_ItemCount; }
+        [[nodiscard]] uint32_t GetNodeCount() const { return m_NodeCount; }
+        [[nodiscard]] uint32_t GetDepth() const;
+        // Area of all inner nodes relative to the root: the expected number of inner nodes a random ray
+        // through the root visits, lower is better.
+        [[nodiscard]] float GetQuality() const;
+        // Sum of the inner nodes' half areas, proportional to the inner nodes a query of fixed size visits.
+        // Comparing it to the value right after a build shows how far refits degraded the tree.
+        [[nodiscard]] double GetInnerArea() const { return m_InnerArea; }
+
+        void QueryAabb(const Aabb& bounds, std::vector<uint32_t>& ids) const;
+        // Hits come unsorted, subtrees nearer to the origin are visited first.
+        void QueryRay(const Ray& ray, std::vector<RayHit>& hits) const;
+        void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& ids) const;
+        // Splits the tree into subtrees that are culled as separate jobs. Returns the same ids in the same order
+        // as QueryFrustum().
+        void QueryFrustumParallel(const Frustum& frustum, JobSystem& jobSystem, std::vector<uint32_t>& ids) const;
+
+    private:
+        static constexpr int32_t NullNode = -1;
+
+        // Inner nodes have two children, leaves none and point at their proxy.
+        struct Node {
+            Aabb bounds;
+            int32_t parent = NullNode;
+            int32_t children[2] = {NullNode, NullNode};
+            int32_t proxy = NullNode;
+
+            [[nodiscard]] bool IsLeaf() const { return children[0] == NullNode; }
+        };
+
+        struct BuildItem {
+            Aabb bounds;
+            Vec3 center;
+            int32_t proxy;
+        };
+
+        struct Proxy {
+            Aabb bounds;
+            uint32_t id = 0;
+            // NullNode while the item waits for a rebuild, the next free proxy once removed.
+            int32_t leaf = NullNode;
+            bool alive = false;
+        };
+
+        int32_t AllocateProxy(const Aabb& bounds, uint32_t id);
+        int32_t AllocateNode();
+        void FreeNode(int32_t node);
+        void LinkLeaf(int32_t leaf);
+        void UnlinkLeaf(int32_t leaf);
+        // Recomputes the bounds from node upwards, stops as soon as a node did not change.
+        void Refit(int32_t node);
+        void SetBounds(int32_t node, const Aabb& bounds);
+        int32_t BuildRange(const int32_t* proxies, uint32_t count);
+        void CollectLeaves(int32_t node, std::vector<uint32_t>& ids) const;
+        void CullSubtree(const Frustum& frustum, int32_t node, uint32_t planeMask, std::vector<uint32_t>& ids) const;
+        [[nodiscard]] Aabb Fatten(const Aabb& bounds) const;
+
+        float m_Margin;
+        std::vector<Node> m_Nodes;
+        std::vector<Proxy> m_Proxies;
+        int32_t m_Root = NullNode;
+        int32_t m_FreeNode = NullNode;
+        int32_t m_FreeProxy = NullNode;
+        uint32_t m_NodeCount = 0;
+        uint32_t m_ItemCount = 0;
+        // Sum of HalfArea() over inner nodes, kept up to date by every change so GetQuality() is free.
+        double m_InnerArea = 0.0;
+    };
+
+    // Visibility and overlap queries over a whole scene: static items live in a tree that is rebuilt in one
+    // batch, moving ones in a tree that is refit incrementally. Handles returned by Add() are tagged with
+    // the tree they went into.
+    class SpatialIndex {
+    public:
+        explicit SpatialIndex(float dynamicMargin = 0.1f) : m_Dynamic(dynamicMargin) {}
+
+        uint32_t Add(const Aabb& bounds, uint32_t id, bool isStatic);
+        void Remove(uint32_t handle);
+        // Static items may move as well, but every move refits the static tree and slowly degrades it.
+        void Update(uint32_t handle, const Aabb& bounds);
+        // Call once per frame before querying: rebuilds the static tree if items were added since, and the
+        // dynamic one if refits made it noticeably worse than its last build.
+        void Commit();
+
+        [[nodiscard]] const Bvh& GetStaticTree() const { return m_Static; }
+        [[nodiscard]] const Bvh& GetDynamicTree() const { return m_Dynamic; }
+
+        void QueryAabb(const Aabb& bounds, std::vector<uint32_t>& ids) const;
+        void QueryRay(const Ray& ray, std::vector<RayHit>& hits) const;
+        void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& ids) const;
+        void QueryFrustumParallel(const Frustum& frustum, JobSystem& jobSystem, std::vector<uint32_t>& ids) const;
+
+    private:
+        Bvh m_Static;
+        Bvh m_Dynamic;
+        bool m_StaticDirty = false;
+        double m_DynamicBuildArea = 0.0;
+    };
+}
+#endif //REDPLASMA_BVH_H
\ No newline at end of file
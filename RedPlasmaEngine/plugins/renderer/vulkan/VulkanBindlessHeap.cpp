@@ -0,0 +1,194 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "VulkanBindlessHeap.h"
+
+#include <algorithm>
+
+namespace RedPlasma {
+    namespace {
+        // Upper bounds, the device limits usually allow far more than a scene needs.
+        constexpr uint32_t MaxBindlessTextures = 16384;
+        constexpr uint32_t MaxBindlessStorageBuffers = 1024;
+    }
+
+    uint32_t VulkanBindlessHeap::IndexPool::Allocate() {
+        if (!free.empty()) {
+            uint32_t index = free.back();
+            free.pop_back();
+            return index;
+        }
+        return next < capacity ? next++ : InvalidIndex;
+    }
+
+    void VulkanBindlessHeap::IndexPool::Release(uint32_t index) {
+        if (index < next) {
+            free.push_back(index);
+        }
+    }
+
+    int VulkanBindlessHeap::Initialize(VkDevice device, const VkPhysicalDeviceLimits& limits) {
+        m_Device = device;
+        m_Textures = {};
+        m_Textures.capacity = std::min({ MaxBindlessTextures, limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                         limits.maxDescriptorSetUpdateAfterBindSampledImages });
+        m_StorageBuffers = {};
+        m_StorageBuffers.capacity = std::min({ MaxBindlessStorageBuffers, limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                               limits.maxDescriptorSetUpdateAfterBindStorageBuffers });
+        if (m_Textures.capacity == 0 || m_StorageBuffers.capacity == 0) {
+            return -1;
+        }
+
+        VkSamplerCreateInfo samplerInfo = {};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.maxLod = 1000.0f;
+        if (vkCreateSampler(m_Device, &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS) {
+            return -2;
+        }
+
+        VkDescriptorSetLayoutBinding bindings[3] = {};
+        bindings[0].binding = 0;
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        bindings[0].descriptorCount = 1;
+        bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+        bindings[0].pImmutableSamplers = &m_Sampler;
+        bindings[1].binding = 1;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        bindings[1].descriptorCount = m_Textures.capacity;
+        bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+        bindings[2].binding = 2;
+        bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[2].descriptorCount = m_StorageBuffers.capacity;
+        bindings[2].stageFlags = VK_SHADER_STAGE_ALL;
+
+        // Slots nobody wrote yet are never read, and slots are only written while in flight frames ignore them.
+        VkDescriptorBindingFlags arrayFlags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                              VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                                              VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+        VkDescriptorBindingFlags bindingFlags[3] = { 0, arrayFlags, arrayFlags };
+        VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = {};
+        flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        flagsInfo.bindingCount = 3;
+        flagsInfo.pBindingFlags = bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = &flagsInfo;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutInfo.bindingCount = 3;
+        layoutInfo.pBindings = bindings;
+        if (vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &m_Layout) != VK_SUCCESS) {
+            return -3;
+        }
+
+        VkDescriptorPoolSize poolSizes[3] = {
+            { VK_DESCRIPTOR_TYPE_SAMPLER, 1 },
+            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, m_Textures.capacity },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_StorageBuffers.capacity }
+        };
+        VkDescriptorPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = 3;
+        poolInfo.pPoolSizes = poolSizes;
+        if (vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &m_Pool) != VK_SUCCESS) {
+            return -4;
+        }
+
+        VkDescriptorSetAllocateInfo setInfo = {};
+        setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        setInfo.descriptorPool = m_Pool;
+        setInfo.descriptorSetCount = 1;
+        setInfo.pSetLayouts = &m_Layout;
+        if (vkAllocateDescriptorSets(m_Device, &setInfo, &m_Set) != VK_SUCCESS) {
+            return -5;
+        }
+        return 0;
+    }
+
+    void VulkanBindlessHeap::Shutdown() {
+        if (m_Device == VK_NULL_HANDLE) {
+            return;
+        }
+        // Destroying the pool frees the set allocated from it.
+        vkDestroyDescriptorPool(m_Device, m_Pool, nullptr);
+        vkDestroyDescriptorSetLayout(m_Device, m_Layout, nullptr);
+        vkDestroySampler(m_Device, m_Sampler, nullptr);
+        m_Pool = VK_NULL_HANDLE;
+        m_Set = VK_NULL_HANDLE;
+        m_Layout = VK_NULL_HANDLE;
+        m_Sampler = VK_NULL_HANDLE;
+        m_Textures = {};
+        m_StorageBuffers = {};
+        m_Device = VK_NULL_HANDLE;
+    }
+
+    uint32_t VulkanBindlessHeap::AddTexture(VkImageView view) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        uint32_t index = m_Textures.Allocate();
+        if (index == InvalidIndex) {
+            return InvalidIndex;
+        }
+
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageView = view;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_Set;
+        write.dstBinding = 1;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(m_Device, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    uint32_t VulkanBindlessHeap::AddStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        uint32_t index = m_StorageBuffers.Allocate();
+        if (index == InvalidIndex) {
+            return InvalidIndex;
+        }
+
+        VkDescriptorBufferInfo bufferInfo = { buffer, offset, range };
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_Set;
+        write.dstBinding = 2;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(m_Device, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    void VulkanBindlessHeap::ReleaseTexture(uint32_t index) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Textures.Release(index);
+    }
+
+    void VulkanBindlessHeap::ReleaseStorageBuffer(uint32_t index) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_StorageBuffers.Release(index);
+    }
+}
@@ -0,0 +1,72 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANBINDLESSHEAP_H
+#define REDPLASMA_VULKANBINDLESSHEAP_H
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    // One descriptor set for every texture and storage buffer the renderer uses. It is bound once per command
+    // buffer, and shaders reach resources through the integer index handed out here instead of per-draw sets.
+    // Bindings are update-after-bind and partially bound, so slots can be filled while frames using the set are
+    // in flight, as long as those frames never read the slot being written.
+    //
+    // Layout, shared with every shader that declares set 0:
+    //   binding 0: the immutable linear sampler
+    //   binding 1: sampled images, indexed by AddTexture()
+    //   binding 2: storage buffers, indexed by AddStorageBuffer()
+    class VulkanBindlessHeap {
+    public:
+        static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+        int Initialize(VkDevice device, const VkPhysicalDeviceLimits& limits);
+        void Shutdown();
+
+        // Returns InvalidIndex when the heap is full. Safe from any thread.
+        uint32_t AddTexture(VkImageView view);
+        uint32_t AddStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+        // The index may only be released once no submitted frame can still read it.
+        void ReleaseTexture(uint32_t index);
+        void ReleaseStorageBuffer(uint32_t index);
+
+        [[nodiscard]] VkDescriptorSetLayout GetLayout() const { return m_Layout; }
+        [[nodiscard]] VkDescriptorSet GetSet() const { return m_Set; }
+        [[nodiscard]] uint32_t GetTextureCapacity() const { return m_Textures.capacity; }
+        [[nodiscard]] uint32_t GetStorageBufferCapacity() const { return m_StorageBuffers.capacity; }
+
+    private:
+        // Hands out the lowest never used index first, released ones are reused before that.
+        struct IndexPool {
+            std::vector<uint32_t> free;
+            uint32_t next = 0;
+            uint32_t capacity = 0;
+
+            uint32_t Allocate();
+            void Release(uint32_t index);
+        };
+
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkSampler m_Sampler = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE;
+        VkDescriptorPool m_Pool = VK_NULL_HANDLE;
+        VkDescriptorSet m_Set = VK_NULL_HANDLE;
+        // Guards the index pools and the descriptor writes, which need the set externally synchronized.
+        std::mutex m_Mutex;
+        IndexPool m_Textures;
+        IndexPool m_StorageBuffers;
+    };
+}
+#endif //REDPLASMA_VULKANBINDLESSHEAP_H
\ No newline at end of file
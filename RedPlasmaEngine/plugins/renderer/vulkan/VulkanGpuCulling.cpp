@@ -0,0 +1,301 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "VulkanGpuCulling.h"
+#include "VulkanShaders.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace RedPlasma {
+    namespace {
+        // Must match local_size_x of both cull shaders.
+        constexpr uint32_t CullGroupSize = 64;
+        constexpr uint32_t CullBindingCount = 5;
+
+        // Must match the push constant block of both cull shaders.
+        struct CullConstants {
+            float planes[6][4];
+            uint32_t objectCount;
+            uint32_t batchCount;
+        };
+
+        VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    int VulkanGpuCulling::Initialize(VkDevice device, VulkanMemoryAllocator* allocator, const VkPhysicalDeviceLimits& limits,
+                                     VkPipelineCache pipelineCache, uint32_t frameCount) {
+        m_Device = device;
+        m_Allocator = allocator;
+        m_PipelineCache = pipelineCache;
+        m_StorageAlignment = std::max<VkDeviceSize>(limits.minStorageBufferOffsetAlignment, 16);
+        m_Frames.resize(frameCount);
+
+        // Objects, batches, counters, commands, instances. Both shaders use the same layout.
+        VkDescriptorSetLayoutBinding bindings[CullBindingCount] = {};
+        for (uint32_t i = 0; i < CullBindingCount; i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+        VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = CullBindingCount;
+        layoutInfo.pBindings = bindings;
+        if (vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &m_SetLayout) != VK_SUCCESS) {
+            return -1;
+        }
+
+        VkDescriptorPoolSize poolSize = {};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSize.descriptorCount = CullBindingCount * frameCount;
+        VkDescriptorPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = frameCount;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        if (vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS) {
+            return -1;
+        }
+
+        std::vector<VkDescriptorSetLayout> setLayouts(frameCount, m_SetLayout);
+        std::vector<VkDescriptorSet> sets(frameCount);
+        VkDescriptorSetAllocateInfo setInfo = {};
+        setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        setInfo.descriptorPool = m_DescriptorPool;
+        setInfo.descriptorSetCount = frameCount;
+        setInfo.pSetLayouts = setLayouts.data();
+        if (vkAllocateDescriptorSets(m_Device, &setInfo, sets.data()) != VK_SUCCESS) {
+            return -1;
+        }
+        for (uint32_t i = 0; i < frameCount; i++) {
+            m_Frames[i].descriptorSet = sets[i];
+        }
+
+        VkPushConstantRange pushConstantRange = {};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.size = sizeof(CullConstants);
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_SetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(m_Device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS) {
+            return -1;
+        }
+
+        if (CreatePipeline("cull.comp", m_CullPipeline) != 0 || CreatePipeline("cull_compact.comp", m_CompactPipeline) != 0) {
+            return -2;
+        }
+        return 0;
+    }
+
+    void VulkanGpuCulling::Shutdown() {
+        if (m_Device == VK_NULL_HANDLE) {
+            return;
+        }
+        for (auto& frame : m_Frames) {
+            DestroyBuffer(frame.input, frame.inputMemory, frame.inputSize);
+            DestroyBuffer(frame.output, frame.outputMemory, frame.outputSize);
+        }
+        m_Frames.clear();
+
+        vkDestroyPipeline(m_Device, m_CullPipeline, nullptr);
+        vkDestroyPipeline(m_Device, m_CompactPipeline, nullptr);
+        vkDestroyPipelineLayout(m_Device, m_PipelineLayout, nullptr);
+        // Destroying the pool frees the sets allocated from it.
+        vkDestroyDescriptorPool(m_Device, m_DescriptorPool, nullptr);
+        vkDestroyDescriptorSetLayout(m_Device, m_SetLayout, nullptr);
+        m_CullPipeline = VK_NULL_HANDLE;
+        m_CompactPipeline = VK_NULL_HANDLE;
+        m_PipelineLayout = VK_NULL_HANDLE;
+        m_DescriptorPool = VK_NULL_HANDLE;
+        m_SetLayout = VK_NULL_HANDLE;
+        m_Device = VK_NULL_HANDLE;
+    }
+
+    int VulkanGpuCulling::CreatePipeline(const char* shaderName, VkPipeline& outPipeline) {
+        VkShaderModule shaderModule = CreateShaderModule(m_Device, shaderName);
+        if (shaderModule == VK_NULL_HANDLE) {
+            return -1;
+        }
+
+        VkComputePipelineCreateInfo pipelineInfo = {};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = shaderModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = m_PipelineLayout;
+
+        VkResult result = vkCreateComputePipelines(m_Device, m_PipelineCache, 1, &pipelineInfo, nullptr, &outPipeline);
+        vkDestroyShaderModule(m_Device, shaderModule, nullptr);
+        if (result != VK_SUCCESS) {
+            std::cout << "Failed to create compute pipeline " << shaderName << std::endl;
+            outPipeline = VK_NULL_HANDLE;
+            return -1;
+        }
+        return 0;
+    }
+
+    int VulkanGpuCulling::ResizeBuffer(VkBuffer& buffer, MemoryAllocation& memory, VkDeviceSize& currentSize, VkDeviceSize size,
+                                       VkBufferUsageFlags usage, VkMemoryPropertyFlags required) {
+        if (currentSize >= size) {
+            return 0;
+        }
+        // Doubling keeps a slowly growing scene from reallocating every frame.
+        VkDeviceSize capacity = std::max(size, currentSize * 2);
+        DestroyBuffer(buffer, memory, currentSize);
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = capacity;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+            buffer = VK_NULL_HANDLE;
+            return -1;
+        }
+        if (m_Allocator->AllocateForBuffer(buffer, required, 0, memory) != 0) {
+            vkDestroyBuffer(m_Device, buffer, nullptr);
+            buffer = VK_NULL_HANDLE;
+            return -2;
+        }
+        currentSize = capacity;
+        return 0;
+    }
+
+    void VulkanGpuCulling::DestroyBuffer(VkBuffer& buffer, MemoryAllocation& memory, VkDeviceSize& size) {
+        if (buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(m_Device, buffer, nullptr);
+            m_Allocator->Free(memory);
+        }
+        buffer = VK_NULL_HANDLE;
+        memory = {};
+        size = 0;
+    }
+
+    int VulkanGpuCulling::BeginFrame(uint32_t frameSlot, uint32_t objectCount, uint32_t batchCount,
+                                     CullObject*& outObjects, CullBatch*& outBatches) {
+        if (objectCount == 0 || batchCount == 0) {
+            return -1;
+        }
+        FrameResources& frame = m_Frames[frameSlot];
+        frame.objectCount = objectCount;
+        frame.batchCount = batchCount;
+
+        frame.batchesOffset = AlignUp(objectCount * sizeof(CullObject), m_StorageAlignment);
+        VkDeviceSize inputSize = frame.batchesOffset + batchCount * sizeof(CullBatch);
+        frame.countersSize = (1 + batchCount) * sizeof(uint32_t);
+        frame.commandsOffset = AlignUp(frame.countersSize, m_StorageAlignment);
+        frame.instancesOffset = AlignUp(frame.commandsOffset + batchCount * sizeof(VkDrawIndexedIndirectCommand), m_StorageAlignment);
+        VkDeviceSize outputSize = frame.instancesOffset + objectCount * sizeof(GpuInstance);
+
+        if (ResizeBuffer(frame.input, frame.inputMemory, frame.inputSize, inputSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0 ||
+            ResizeBuffer(frame.output, frame.outputMemory, frame.outputSize, outputSize,
+                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0) {
+            return -2;
+        }
+
+        // The ranges move with the counts, so the set is rewritten every frame. The slot has retired, nothing reads it.
+        VkDescriptorBufferInfo buffers[CullBindingCount] = {
+            { frame.input, 0, objectCount * sizeof(CullObject) },
+            { frame.input, frame.batchesOffset, batchCount * sizeof(CullBatch) },
+            { frame.output, 0, frame.countersSize },
+            { frame.output, frame.commandsOffset, batchCount * sizeof(VkDrawIndexedIndirectCommand) },
+            { frame.output, frame.instancesOffset, objectCount * sizeof(GpuInstance) }
+        };
+        VkWriteDescriptorSet writes[CullBindingCount] = {};
+        for (uint32_t i = 0; i < CullBindingCount; i++) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = frame.descriptorSet;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &buffers[i];
+        }
+        vkUpdateDescriptorSets(m_Device, CullBindingCount, writes, 0, nullptr);
+
+        auto* mapped = static_cast<char*>(frame.inputMemory.mapped);
+        outObjects = reinterpret_cast<CullObject*>(mapped);
+        outBatches = reinterpret_cast<CullBatch*>(mapped + frame.batchesOffset);
+        return 0;
+    }
+
+    void VulkanGpuCulling::SetViewProjection(uint32_t frameSlot, const float viewProjection[16]) {
+        // Planes from the rows of the column major matrix, for Vulkan's [0, 1] clip depth. Normals point inwards.
+        auto row = [viewProjection](int r, int c) { return viewProjection[c * 4 + r]; };
+        float (&planes)[6][4] = m_Frames[frameSlot].planes;
+        for (int c = 0; c < 4; c++) {
+            planes[0][c] = row(3, c) + row(0, c);
+            planes[1][c] = row(3, c) - row(0, c);
+            planes[2][c] = row(3, c) + row(1, c);
+            planes[3][c] = row(3, c) - row(1, c);
+            planes[4][c] = row(2, c);
+            planes[5][c] = row(3, c) - row(2, c);
+        }
+        for (auto& plane : planes) {
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f) {
+                for (float& value : plane) {
+                    value /= length;
+                }
+            }
+        }
+    }
+
+    void VulkanGpuCulling::RecordReset(VkCommandBuffer commandBuffer, uint32_t frameSlot) {
+        const FrameResources& frame = m_Frames[frameSlot];
+        vkCmdFillBuffer(commandBuffer, frame.output, 0, frame.countersSize, 0);
+    }
+
+    void VulkanGpuCulling::RecordCull(VkCommandBuffer commandBuffer, uint32_t frameSlot) {
+        const FrameResources& frame = m_Frames[frameSlot];
+        CullConstants constants = {};
+        std::copy(&frame.planes[0][0], &frame.planes[0][0] + 24, &constants.planes[0][0]);
+        constants.objectCount = frame.objectCount;
+        constants.batchCount = frame.batchCount;
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_CullPipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &frame.descriptorSet, 0, nullptr);
+        vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(commandBuffer, (frame.objectCount + CullGroupSize - 1) / CullGroupSize, 1, 1);
+    }
+
+    void VulkanGpuCulling::RecordCompact(VkCommandBuffer commandBuffer, uint32_t frameSlot) {
+        const FrameResources& frame = m_Frames[frameSlot];
+        CullConstants constants = {};
+        constants.objectCount = frame.objectCount;
+        constants.batchCount = frame.batchCount;
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_CompactPipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &frame.descriptorSet, 0, nullptr);
+        vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(commandBuffer, (frame.batchCount + CullGroupSize - 1) / CullGroupSize, 1, 1);
+    }
+
+    void VulkanGpuCulling::RecordDraws(VkCommandBuffer commandBuffer, uint32_t frameSlot) {
+        const FrameResources& frame = m_Frames[frameSlot];
+        // The draw count sits in the first counter, at most one command per batch was written.
+        vkCmdDrawIndexedIndirectCount(commandBuffer, frame.output, frame.commandsOffset, frame.output, 0,
+                                      frame.batchCount, sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
@@ -0,0 +1,115 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANGPUCULLING_H
+#define REDPLASMA_VULKANGPUCULLING_H
+#include "VulkanMemoryAllocator.h"
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    // Instance layout the main pipeline reads through its per-instance binding. The CPU path writes it directly,
+    // the GPU path has it written by cull.comp for the visible objects only.
+    struct GpuInstance {
+        float transform[16];
+        // Index into the bindless material buffer.
+        uint32_t material;
+        uint32_t padding[3];
+    };
+
+    // std430 layouts shared with cull.comp and cull_compact.comp.
+    struct CullObject {
+        float transform[16];
+        uint32_t batch;
+        uint32_t padding[3];
+    };
+
+    struct CullBatch {
+        // Mesh space bounding sphere, a negative radius culls every object of the batch.
+        float boundsCenter[3];
+        float boundsRadius;
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        // Visible instances of the batch are compacted into [firstInstance, firstInstance + objects in batch).
+        uint32_t firstInstance;
+        uint32_t material;
+        uint32_t padding[3];
+    };
+
+    // GPU driven draws for the sorted draw list. cull.comp tests every object against the frustum and appends
+    // the visible ones to their batch's instance range, cull_compact.comp turns the non-empty batches into
+    // VkDrawIndexedIndirectCommands, and one vkCmdDrawIndexedIndirectCount issues them.
+    class VulkanGpuCulling {
+    public:
+        int Initialize(VkDevice device, VulkanMemoryAllocator* allocator, const VkPhysicalDeviceLimits& limits,
+                       VkPipelineCache pipelineCache, uint32_t frameCount);
+        void Shutdown();
+
+        [[nodiscard]] bool IsInitialized() const { return m_CullPipeline != VK_NULL_HANDLE; }
+
+        // Sizes the frame slot's buffers, which has to be retired. The returned arrays are mapped memory,
+        // to be filled before the frame is submitted.
+        int BeginFrame(uint32_t frameSlot, uint32_t objectCount, uint32_t batchCount,
+                       CullObject*& outObjects, CullBatch*& outBatches);
+        void SetViewProjection(uint32_t frameSlot, const float viewProjection[16]);
+
+        // Everything below records for the slot prepared by BeginFrame(), in this order.
+        void RecordReset(VkCommandBuffer commandBuffer, uint32_t frameSlot);
+        void RecordCull(VkCommandBuffer commandBuffer, uint32_t frameSlot);
+        void RecordCompact(VkCommandBuffer commandBuffer, uint32_t frameSlot);
+        // Expects the main pipeline bound, with the instance binding at GetInstanceOffset().
+        void RecordDraws(VkCommandBuffer commandBuffer, uint32_t frameSlot);
+
+        // Written by the cull passes, read as indirect commands and instance data by the draws.
+        [[nodiscard]] VkBuffer GetOutputBuffer(uint32_t frameSlot) const { return m_Frames[frameSlot].output; }
+        [[nodiscard]] VkDeviceSize GetInstanceOffset(uint32_t frameSlot) const { return m_Frames[frameSlot].instancesOffset; }
+
+    private:
+        struct FrameResources {
+            VkBuffer input = VK_NULL_HANDLE;
+            MemoryAllocation inputMemory;
+            VkDeviceSize inputSize = 0;
+            VkBuffer output = VK_NULL_HANDLE;
+            MemoryAllocation outputMemory;
+            VkDeviceSize outputSize = 0;
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+            uint32_t objectCount = 0;
+            uint32_t batchCount = 0;
+            VkDeviceSize batchesOffset = 0;
+            // Output regions: counters (draw count, then one per batch), commands, instances.
+            VkDeviceSize countersSize = 0;
+            VkDeviceSize commandsOffset = 0;
+            VkDeviceSize instancesOffset = 0;
+            float planes[6][4] = {};
+        };
+
+        int CreatePipeline(const char* shaderName, VkPipeline& outPipeline);
+        int ResizeBuffer(VkBuffer& buffer, MemoryAllocation& memory, VkDeviceSize& currentSize, VkDeviceSize size,
+                         VkBufferUsageFlags usage, VkMemoryPropertyFlags required);
+        void DestroyBuffer(VkBuffer& buffer, MemoryAllocation& memory, VkDeviceSize& size);
+
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VulkanMemoryAllocator* m_Allocator = nullptr;
+        VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+        VkDeviceSize m_StorageAlignment = 256;
+        VkDescriptorSetLayout m_SetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+        VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_CullPipeline = VK_NULL_HANDLE;
+        VkPipeline m_CompactPipeline = VK_NULL_HANDLE;
+        std::vector<FrameResources> m_Frames;
+    };
+}
+#endif //REDPLASMA_VULKANGPUCULLING_H
\ No newline at end of file
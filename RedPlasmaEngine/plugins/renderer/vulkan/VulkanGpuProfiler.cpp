@@ -0,0 +1,131 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+#include "VulkanGpuProfiler.h"
+
+#include <iostream>
+
+namespace RedPlasma {
+
+    int VulkanGpuProfiler::Initialize(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, uint32_t frameCount) {
+        m_Device = device;
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+        uint32_t validBits = queueFamilyIndex < queueFamilyCount ? queueFamilies[queueFamilyIndex].timestampValidBits : 0;
+        if (validBits == 0) {
+            std::cout << "GPU profiler: queue does not support timestamps, profiling disabled" << std::endl;
+            return 1;
+        }
+        m_TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        m_NanosecondsPerTick = properties.limits.timestampPeriod;
+
+        m_Frames.resize(frameCount);
+        for (auto& frame : m_Frames) {
+            VkQueryPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            poolInfo.queryCount = MaxZonesPerFrame * 2;
+
+            if (vkCreateQueryPool(m_Device, &poolInfo, nullptr, &frame.pool) != VK_SUCCESS) {
+                Shutdown();
+                return -1;
+            }
+            frame.zones.reserve(MaxZonesPerFrame);
+        }
+
+        m_Scratch.resize(MaxZonesPerFrame * 2);
+        return 0;
+    }
+
+    void VulkanGpuProfiler::Shutdown() {
+        for (auto& frame : m_Frames) {
+            if (frame.pool != VK_NULL_HANDLE) {
+                vkDestroyQueryPool(m_Device, frame.pool, nullptr);
+            }
+        }
+        m_Frames.clear();
+        m_Results.clear();
+        m_Recording = nullptr;
+    }
+
+    void VulkanGpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+        if (m_Frames.empty()) {
+            return;
+        }
+
+        FrameQueries& frame = m_Frames[frameIndex % m_Frames.size()];
+        if (frame.pending) {
+            Resolve(frame);
+        }
+
+        frame.zones.clear();
+        frame.pending = true;
+        m_Recording = &frame;
+        m_Depth = 0;
+
+        vkCmdResetQueryPool(commandBuffer, frame.pool, 0, MaxZonesPerFrame * 2);
+    }
+
+    uint32_t VulkanGpuProfiler::BeginZone(VkCommandBuffer commandBuffer, const char* name) {
+        if (m_Recording == nullptr || m_Recording->zones.size() >= MaxZonesPerFrame) {
+            return UINT32_MAX;
+        }
+
+        auto zone = static_cast<uint32_t>(m_Recording->zones.size());
+        m_Recording->zones.push_back({ name, m_Depth++, false });
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_Recording->pool, zone * 2);
+        return zone;
+    }
+
+    void VulkanGpuProfiler::EndZone(VkCommandBuffer commandBuffer, uint32_t zone) {
+        if (m_Recording == nullptr || zone >= m_Recording->zones.size()) {
+            return;
+        }
+
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_Recording->pool, zone * 2 + 1);
+        m_Recording->zones[zone].closed = true;
+        m_Depth--;
+    }
+
+    void VulkanGpuProfiler::Resolve(FrameQueries& frame) {
+        frame.pending = false;
+        if (frame.zones.empty()) {
+            return;
+        }
+
+        // The owning frame's fence has signalled, so this does not wait; NOT_READY means it was never submitted.
+        auto queryCount = static_cast<uint32_t>(frame.zones.size() * 2);
+        VkResult result = vkGetQueryPoolResults(m_Device, frame.pool, 0, queryCount, queryCount * sizeof(uint64_t),
+                                                m_Scratch.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) {
+            return;
+        }
+
+        m_Results.clear();
+        for (size_t i = 0; i < frame.zones.size(); i++) {
+            const Zone& zone = frame.zones[i];
+            if (!zone.closed) {
+                continue;
+            }
+
+            uint64_t ticks = (m_Scratch[i * 2 + 1] - m_Scratch[i * 2]) & m_TimestampMask;
+            m_Results.push_back({ zone.name, static_cast<double>(ticks) * m_NanosecondsPerTick / 1e6, zone.depth });
+        }
+    }
+}
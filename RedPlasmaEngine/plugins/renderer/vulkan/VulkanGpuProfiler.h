@@ -0,0 +1,82 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANGPUPROFILER_H
+#define REDPLASMA_VULKANGPUPROFILER_H
+#include "renderer/IGraphicsDevice.h"
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    // Timestamp query ring with one query pool per frame in flight. A frame's results are collected
+    // when its slot is reused, i.e. after its fence signalled, so reading them never stalls.
+    class VulkanGpuProfiler {
+    public:
+        static constexpr uint32_t MaxZonesPerFrame = 64;
+
+        int Initialize(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, uint32_t frameCount);
+        void Shutdown();
+
+        // Call right after vkBeginCommandBuffer, outside of any render pass.
+        void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+        // The name has to outlive the frame, use string literals.
+        uint32_t BeginZone(VkCommandBuffer commandBuffer, const char* name);
+        void EndZone(VkCommandBuffer commandBuffer, uint32_t zone);
+
+        [[nodiscard]] bool IsEnabled() const { return !m_Frames.empty(); }
+        [[nodiscard]] const std::vector<GpuZoneTiming>& GetResults() const { return m_Results; }
+
+    private:
+        struct Zone {
+            const char* name;
+            uint32_t depth;
+            bool closed;
+        };
+
+        struct FrameQueries {
+            VkQueryPool pool = VK_NULL_HANDLE;
+            std::vector<Zone> zones;
+            bool pending = false;
+        };
+
+        void Resolve(FrameQueries& frame);
+
+        VkDevice m_Device = VK_NULL_HANDLE;
+        double m_NanosecondsPerTick = 1.0;
+        uint64_t m_TimestampMask = ~0ull;
+        std::vector<FrameQueries> m_Frames;
+        FrameQueries* m_Recording = nullptr;
+        uint32_t m_Depth = 0;
+        std::vector<uint64_t> m_Scratch;
+        std::vector<GpuZoneTiming> m_Results;
+    };
+
+    // Profiles everything recorded between construction and destruction.
+    class ScopedGpuZone {
+    public:
+        ScopedGpuZone(VulkanGpuProfiler& profiler, VkCommandBuffer commandBuffer, const char* name) :
+        m_Profiler(profiler),
+        m_CommandBuffer(commandBuffer),
+        m_Zone(profiler.BeginZone(commandBuffer, name)) {}
+
+        ~ScopedGpuZone() { m_Profiler.EndZone(m_CommandBuffer, m_Zone); }
+
+        ScopedGpuZone(const ScopedGpuZone&) = delete;
+        ScopedGpuZone& operator=(const ScopedGpuZone&) = delete;
+
+    private:
+        VulkanGpuProfiler& m_Profiler;
+        VkCommandBuffer m_CommandBuffer;
+        uint32_t m_Zone;
+    };
+}
+#endif //REDPLASMA_VULKANGPUPROFILER_H
\ No newline at end of file
@@ -12,13 +12,18 @@
 //
 
 #include "VulkanGraphicsDevice.h"
+#include "VulkanShaders.h"
+#include "jobs/JobSystem.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 
 #include "renderer/IWindowSurface.h"
 #include <iostream>
 #include <vector>
-#include <fstream>
 
 namespace RedPlasma {
     struct QueueFamilyIndices {
@@ -38,37 +43,24 @@ namespace RedPlasma {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
 
-    std::vector<char> ReadFile(const std::string &filename) {
-        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    using FrameClock = std::chrono::steady_clock;
 
-        if (!file.is_open()) {
-            throw std::runtime_error("failed to open file: " + filename);
-        }
-
-        size_t fileSize = (size_t)file.tellg();
-        std::vector<char> buffer(fileSize);
-
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-
-        file.close();
-
-        return buffer;
+    double ElapsedMs(FrameClock::time_point start, FrameClock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
     }
 
-    VkShaderModule CreateShaderModule(VkDevice device, const std::vector<char> &code) {
-        VkShaderModuleCreateInfo createInfo = {};
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = code.size();
-        createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
-
-        VkShaderModule shaderModule;
-        if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
-            return VK_NULL_HANDLE;
-        }
+    // Must match the push constant block in shader.vert.
+    struct DrawPushConstants {
+        float viewProjection[16];
+        uint32_t materialBuffer;
+    };
 
-        return shaderModule;
-    }
+    // std430 layout of one entry in the material buffer, must match Material in shader.vert.
+    struct GpuMaterial {
+        float color[4];
+        uint32_t texture;
+        uint32_t padding[3];
+    };
 
     int VulkanGraphicsDevice::InitializeDevice(IWindowSurface* surface) {
         if (!surface) {
@@ -81,38 +73,85 @@ namespace RedPlasma {
             return -1;
         }
 
-        uint32_t queueFamilyCount = 0;
-        vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &queueFamilyCount, nullptr);
-        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
-        vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &queueFamilyCount, queueFamilies.data());
-
-        int i = 0;
-        for (const auto& queueFamily : queueFamilies) {
-            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-                m_graphicsFamilyIndex = i;
-            }
+        if (FindQueueFamilies(vkSurface) != 0) {
+            return -3;
+        }
 
-            VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(m_PhysicalDevice, i, vkSurface, &presentSupport);
-            if (presentSupport) {
-                m_PresentFamilyIndex = i;
+        // One queue per distinct family, roles that share a family share its queue.
+        std::vector<uint32_t> uniqueFamilies;
+        for (int family : { m_graphicsFamilyIndex, m_PresentFamilyIndex, m_TransferFamilyIndex, m_ComputeFamilyIndex }) {
+            if (family >= 0 && std::find(uniqueFamilies.begin(), uniqueFamilies.end(), static_cast<uint32_t>(family)) == uniqueFamilies.end()) {
+                uniqueFamilies.push_back(static_cast<uint32_t>(family));
             }
-            i++;
         }
 
         float queuePriority = 1.0f;
-        VkDeviceQueueCreateInfo queueCreateInfo = {};
-        queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        queueCreateInfo.queueFamilyIndex = m_graphicsFamilyIndex;
-        queueCreateInfo.queueCount = 1;
-        queueCreateInfo.pQueuePriorities = &queuePriority;
+        std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+        for (uint32_t family : uniqueFamilies) {
+            VkDeviceQueueCreateInfo queueCreateInfo = {};
+            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.queueFamilyIndex = family;
+            queueCreateInfo.queueCount = 1;
+            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfos.push_back(queueCreateInfo);
+        }
+
+        VkPhysicalDeviceVulkan12Features supported12 = {};
+        supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceVulkan13Features supported13 = {};
+        supported13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        supported13.pNext = &supported12;
+        VkPhysicalDeviceFeatures2 supportedFeatures = {};
+        supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures.pNext = &supported13;
+        vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supportedFeatures);
+        bool bindless = supported12.descriptorIndexing && supported12.runtimeDescriptorArray &&
+                        supported12.descriptorBindingPartiallyBound && supported12.descriptorBindingUpdateUnusedWhilePending &&
+                        supported12.descriptorBindingSampledImageUpdateAfterBind &&
+                        supported12.descriptorBindingStorageBufferUpdateAfterBind &&
+                        supported12.shaderSampledImageArrayNonUniformIndexing &&
+                        supportedFeatures.features.shaderStorageBufferArrayDynamicIndexing &&
+                        supportedFeatures.features.shaderSampledImageArrayDynamicIndexing;
+        if (!supported13.dynamicRendering || !supported13.synchronization2 || !supported12.timelineSemaphore || !bindless) {
+            std::cout << "Device does not support dynamic rendering, synchronization2, timeline semaphores and descriptor indexing" << std::endl;
+            return -7;
+        }
+        // Optional, the draws are recorded on the CPU without them.
+        m_GpuCullingSupported = supported12.drawIndirectCount && supportedFeatures.features.multiDrawIndirect;
+
+        // Rendering goes straight into image views, there are no render pass or framebuffer objects to keep in sync.
+        // The render graph records its barriers with synchronization2.
+        VkPhysicalDeviceVulkan13Features features13 = {};
+        features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        features13.dynamicRendering = VK_TRUE;
+        features13.synchronization2 = VK_TRUE;
+
+        // Frame pacing, uploads and deferred destruction all wait on timeline values instead of fences.
+        VkPhysicalDeviceVulkan12Features features12 = {};
+        features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        features12.timelineSemaphore = VK_TRUE;
+        // Materials and textures are reached through one bindless descriptor set, see VulkanBindlessHeap.
+        features12.descriptorIndexing = VK_TRUE;
+        features12.runtimeDescriptorArray = VK_TRUE;
+        features12.descriptorBindingPartiallyBound = VK_TRUE;
+        features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        features12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        features12.drawIndirectCount = m_GpuCullingSupported;
+        features13.pNext = &features12;
 
         VkPhysicalDeviceFeatures deviceFeatures = {};
+        // The vertex shader picks the material buffer out of the bindless array with a push constant index.
+        deviceFeatures.shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
+        deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+        deviceFeatures.multiDrawIndirect = m_GpuCullingSupported;
 
         VkDeviceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        createInfo.queueCreateInfoCount = 1;
-        createInfo.pQueueCreateInfos = &queueCreateInfo;
+        createInfo.pNext = &features13;
+        createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+        createInfo.pQueueCreateInfos = queueCreateInfos.data();
         createInfo.pEnabledFeatures = &deviceFeatures;
 
         createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
@@ -122,10 +161,117 @@ namespace RedPlasma {
             return -2;
         }
 
+        m_MemoryAllocator.Initialize(m_PhysicalDevice, m_LogicalDevice);
+        if (m_Settings.enablePipelineCache && m_PipelineCache.Initialize(m_LogicalDevice, m_DeviceProperties) != 0) {
+            // Pipelines still build without one, just slower.
+            std::cout << "Failed to create the pipeline cache" << std::endl;
+        }
+
         vkGetDeviceQueue(m_LogicalDevice, m_graphicsFamilyIndex, 0, &m_GraphicsQueue);
         vkGetDeviceQueue(m_LogicalDevice, m_PresentFamilyIndex, 0, &m_PresentQueue);
+        if (m_TransferFamilyIndex >= 0) {
+            vkGetDeviceQueue(m_LogicalDevice, m_TransferFamilyIndex, 0, &m_TransferQueue);
+        }
+        if (m_ComputeFamilyIndex >= 0) {
+            vkGetDeviceQueue(m_LogicalDevice, m_ComputeFamilyIndex, 0, &m_ComputeQueue);
+        }
+
+        m_WindowSurface = surface;
+        m_DepthFormat = ChooseDepthFormat();
+        if (m_DepthFormat == VK_FORMAT_UNDEFINED) {
+            return -8;
+        }
 
-        return SetupSwapChain(surface);
+        // The pipeline layout is built around the heap's set layout, so it comes first.
+        if (m_BindlessHeap.Initialize(m_LogicalDevice, m_DeviceProperties.limits) != 0) {
+            std::cout << "Failed to create the bindless descriptor heap" << std::endl;
+            return -25;
+        }
+
+        int result;
+        if ((result = SetupSwapChain(surface)) != 0 ||
+            (result = CreateImageViews()) != 0 ||
+            (result = CreateGraphicsPipeline()) != 0 ||
+            (result = CreateCommandPool()) != 0 ||
+            (result = CreateSyncObjects()) != 0 ||
+            (result = CreateMeshBuffers()) != 0 ||
+            (result = CreateMaterialResources()) != 0) {
+            return result;
+        }
+        m_RenderGraph.Initialize(m_LogicalDevice, &m_MemoryAllocator, static_cast<uint32_t>(m_Frames.size()));
+        if (m_Settings.enableGpuCulling && m_GpuCullingSupported &&
+            m_GpuCulling.Initialize(m_LogicalDevice, &m_MemoryAllocator, m_DeviceProperties.limits, m_PipelineCache.GetHandle(),
+                                    static_cast<uint32_t>(m_Frames.size())) != 0) {
+            // Not fatal, the CPU recorded draws cover everything the GPU path does.
+            std::cout << "Failed to set up GPU culling, recording draws on the CPU" << std::endl;
+            m_GpuCulling.Shutdown();
+        }
+
+        if (m_Settings.enableGpuProfiling) {
+            // Not fatal, the frame renders fine without timings.
+            m_GpuProfiler.Initialize(m_LogicalDevice, m_PhysicalDevice, m_graphicsFamilyIndex, static_cast<uint32_t>(m_Frames.size()));
+        }
+        return 0;
+    }
+
+    int VulkanGraphicsDevice::FindQueueFamilies(VkSurfaceKHR surface) {
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &queueFamilyCount, queueFamilies.data());
+
+        m_graphicsFamilyIndex = -1;
+        m_PresentFamilyIndex = -1;
+        m_TransferFamilyIndex = -1;
+        m_ComputeFamilyIndex = -1;
+
+        // A graphics family that can present as well saves the cross-family swapchain sharing.
+        for (uint32_t i = 0; i < queueFamilyCount; i++) {
+            VkBool32 presentSupport = false;
+            vkGetPhysicalDeviceSurfaceSupportKHR(m_PhysicalDevice, i, surface, &presentSupport);
+            bool graphics = queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT;
+            if (graphics && presentSupport) {
+                m_graphicsFamilyIndex = static_cast<int>(i);
+                m_PresentFamilyIndex = static_cast<int>(i);
+                break;
+            }
+            if (graphics && m_graphicsFamilyIndex < 0) {
+                m_graphicsFamilyIndex = static_cast<int>(i);
+            }
+            if (presentSupport && m_PresentFamilyIndex < 0) {
+                m_PresentFamilyIndex = static_cast<int>(i);
+            }
+        }
+        if (m_graphicsFamilyIndex < 0 || m_PresentFamilyIndex < 0) {
+            std::cout << "No queue family for graphics or present found" << std::endl;
+            return -1;
+        }
+
+        // Transfer prefers a family that can do nothing else (the DMA engines), then any non-graphics one.
+        // Compute wants a family without graphics. Without either the work stays on the graphics queue.
+        int transferOnly = -1;
+        int transferNoGraphics = -1;
+        for (uint32_t i = 0; i < queueFamilyCount; i++) {
+            VkQueueFlags flags = queueFamilies[i].queueFlags;
+            if (flags & VK_QUEUE_GRAPHICS_BIT) {
+                continue;
+            }
+            if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_COMPUTE_BIT) && transferOnly < 0) {
+                transferOnly = static_cast<int>(i);
+            }
+            if ((flags & VK_QUEUE_TRANSFER_BIT) && transferNoGraphics < 0) {
+                transferNoGraphics = static_cast<int>(i);
+            }
+            if ((flags & VK_QUEUE_COMPUTE_BIT) && m_ComputeFamilyIndex < 0) {
+                m_ComputeFamilyIndex = static_cast<int>(i);
+            }
+        }
+        m_TransferFamilyIndex = transferOnly >= 0 ? transferOnly : transferNoGraphics;
+
+        std::cout << "Queue families: graphics " << m_graphicsFamilyIndex << ", present " << m_PresentFamilyIndex
+                  << ", transfer " << (m_TransferFamilyIndex >= 0 ? std::to_string(m_TransferFamilyIndex) : "shared")
+                  << ", compute " << (m_ComputeFamilyIndex >= 0 ? std::to_string(m_ComputeFamilyIndex) : "shared") << std::endl;
+        return 0;
     }
 
     int VulkanGraphicsDevice::SetupSwapChain(IWindowSurface* surface) {
@@ -183,17 +329,41 @@ namespace RedPlasma {
         createInfo.imageArrayLayers = 1;
         createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
-        createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        createInfo.queueFamilyIndexCount = 0;
-        createInfo.pQueueFamilyIndices = nullptr;
+        m_ReadbackSupported = m_Settings.enableReadback && (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+        if (m_ReadbackSupported) {
+            createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        } else if (m_Settings.enableReadback) {
+            std::cout << "Surface does not allow copying from swapchain images, readback disabled" << std::endl;
+        }
+
+        // Rendering and presenting from different families would need an ownership transfer per image otherwise.
+        uint32_t sharingFamilies[] = { static_cast<uint32_t>(m_graphicsFamilyIndex), static_cast<uint32_t>(m_PresentFamilyIndex) };
+        if (m_graphicsFamilyIndex != m_PresentFamilyIndex) {
+            createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+            createInfo.queueFamilyIndexCount = 2;
+            createInfo.pQueueFamilyIndices = sharingFamilies;
+        } else {
+            createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            createInfo.queueFamilyIndexCount = 0;
+            createInfo.pQueueFamilyIndices = nullptr;
+        }
 
         createInfo.preTransform = capabilities.currentTransform;
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-        createInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        createInfo.presentMode = ChoosePresentMode(vkSurface);
         createInfo.clipped = VK_TRUE;
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        createInfo.oldSwapchain = m_SwapChain;
 
-        if (vkCreateSwapchainKHR(m_LogicalDevice, &createInfo, nullptr, &m_SwapChain) != VK_SUCCESS) {
+        VkSwapchainKHR newSwapChain = VK_NULL_HANDLE;
+        VkResult result = vkCreateSwapchainKHR(m_LogicalDevice, &createInfo, nullptr, &newSwapChain);
+
+        // The old swapchain is retired either way; its images stay valid until it is destroyed here.
+        if (m_SwapChain != VK_NULL_HANDLE) {
+            vkDestroySwapchainKHR(m_LogicalDevice, m_SwapChain, nullptr);
+        }
+        m_SwapChain = newSwapChain;
+
+        if (result != VK_SUCCESS) {
             return -4;
         }
 
@@ -202,7 +372,106 @@ namespace RedPlasma {
         m_SwapChainImages.resize(actualImageCount);
         vkGetSwapchainImagesKHR(m_LogicalDevice, m_SwapChain, &actualImageCount, m_SwapChainImages.data());
 
-        return CreateImageViews(); // Success
+        return 0;
+    }
+
+    VkFormat VulkanGraphicsDevice::ChooseDepthFormat() const {
+        // The spec guarantees depth attachment support for at least one of the first two.
+        for (VkFormat format : { VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D16_UNORM }) {
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &properties);
+            if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+                return format;
+            }
+        }
+        std::cout << "No usable depth format found" << std::endl;
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    VkPresentModeKHR VulkanGraphicsDevice::ChoosePresentMode(VkSurfaceKHR surface) const {
+        uint32_t modeCount = 0;
+        vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, surface, &modeCount, nullptr);
+        std::vector<VkPresentModeKHR> availableModes(modeCount);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, surface, &modeCount, availableModes.data());
+
+        // Preference order per requested mode, FIFO is guaranteed by the spec and closes every chain.
+        std::vector<VkPresentModeKHR> candidates;
+        switch (m_Settings.presentMode) {
+            case PresentMode::Mailbox:
+                candidates = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+                break;
+            case PresentMode::Immediate:
+                candidates = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR };
+                break;
+            case PresentMode::FifoRelaxed:
+                candidates = { VK_PRESENT_MODE_FIFO_RELAXED_KHR };
+                break;
+            case PresentMode::Fifo:
+                break;
+        }
+
+        for (auto candidate : candidates) {
+            if (std::find(availableModes.begin(), availableModes.end(), candidate) != availableModes.end()) {
+                return candidate;
+            }
+        }
+
+        if (m_Settings.presentMode != PresentMode::Fifo) {
+            std::cout << "Requested present mode is not supported, falling back to FIFO" << std::endl;
+        }
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+
+    int VulkanGraphicsDevice::RecreateSwapChain() {
+        // A minimized window reports a zero extent, keep the old swapchain until it has a size again.
+        if (m_WindowSurface == nullptr || m_WindowSurface->GetWidth() <= 0 || m_WindowSurface->GetHeight() <= 0) {
+            return 1;
+        }
+
+        vkDeviceWaitIdle(m_LogicalDevice);
+
+        VkFormat previousFormat = m_SwapChainImageFormat;
+        DestroySwapChainResources();
+
+        int result = SetupSwapChain(m_WindowSurface);
+        if (result != 0) {
+            return result;
+        }
+
+        // The pipeline only depends on the attachment format, size changes are covered by dynamic viewport state.
+        if (m_SwapChainImageFormat != previousFormat) {
+            std::cout << "Swapchain format changed, rebuilding pipeline" << std::endl;
+            vkDestroyPipeline(m_LogicalDevice, m_GraphicsPipeline, nullptr);
+            vkDestroyPipelineLayout(m_LogicalDevice, m_PipelineLayout, nullptr);
+            m_GraphicsPipeline = VK_NULL_HANDLE;
+            m_PipelineLayout = VK_NULL_HANDLE;
+
+            if ((result = CreateGraphicsPipeline()) != 0) {
+                return result;
+            }
+        }
+
+        if ((result = CreateImageViews()) != 0 ||
+            (result = CreateRenderFinishedSemaphores()) != 0) {
+            return result;
+        }
+
+        m_SwapChainDirty = false;
+        // Recorded draws carry the viewport, the pipeline and the attachment formats.
+        m_DrawStateVersion++;
+        return 0;
+    }
+
+    void VulkanGraphicsDevice::DestroySwapChainResources() {
+        for (auto imageView : m_SwapChainImageViews) {
+            vkDestroyImageView(m_LogicalDevice, imageView, nullptr);
+        }
+        m_SwapChainImageViews.clear();
+
+        for (auto semaphore : m_RenderFinishedSemaphores) {
+            vkDestroySemaphore(m_LogicalDevice, semaphore, nullptr);
+        }
+        m_RenderFinishedSemaphores.clear();
     }
 
     int VulkanGraphicsDevice::CreateImageViews() {
@@ -230,49 +499,17 @@ namespace RedPlasma {
                 return -6;
             }
         }
-        return CreateRenderPass();
-    }
-
-    int VulkanGraphicsDevice::CreateRenderPass() {
-        VkAttachmentDescription colorAttachment = {};
-        colorAttachment.format = m_SwapChainImageFormat;
-        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-        VkAttachmentReference colorAttachmentRef = {};
-        colorAttachmentRef.attachment = 0;
-        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription subpass = {};
-        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.colorAttachmentCount = 1;
-        subpass.pColorAttachments = &colorAttachmentRef;
-
-        VkRenderPassCreateInfo renderPassInfo = {};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassInfo.attachmentCount = 1;
-        renderPassInfo.pAttachments = &colorAttachment;
-        renderPassInfo.subpassCount = 1;
-        renderPassInfo.pSubpasses = &subpass;
-
-        if (vkCreateRenderPass(m_LogicalDevice, &renderPassInfo, nullptr, &m_RenderPass) != VK_SUCCESS) {
-            return -7;
-        }
-
-        return CreateFramebuffers();
+        return 0;
     }
 
     int VulkanGraphicsDevice::CreateGraphicsPipeline() {
-        auto vertShaderCode = ReadFile("shaders/vert.spv");
-        auto fragShaderCode = ReadFile("shaders/frag.spv");
-
-        VkShaderModule vertShaderModule = CreateShaderModule(m_LogicalDevice, vertShaderCode);
-        VkShaderModule fragShaderModule = CreateShaderModule(m_LogicalDevice, fragShaderCode);
+        VkShaderModule vertShaderModule = CreateShaderModule(m_LogicalDevice, "shader.vert");
+        VkShaderModule fragShaderModule = CreateShaderModule(m_LogicalDevice, "shader.frag");
+        if (vertShaderModule == VK_NULL_HANDLE || fragShaderModule == VK_NULL_HANDLE) {
+            vkDestroyShaderModule(m_LogicalDevice, vertShaderModule, nullptr);
+            vkDestroyShaderModule(m_LogicalDevice, fragShaderModule, nullptr);
+            return -22;
+        }
 
         VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
         vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -288,31 +525,54 @@ namespace RedPlasma {
 
         VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
 
+        VkVertexInputBindingDescription bindingDescriptions[2] = {};
+        bindingDescriptions[0].binding = 0;
+        bindingDescriptions[0].stride = sizeof(Vertex);
+        bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        // Per-instance transforms from the frame's instance buffer.
+        bindingDescriptions[1].binding = 1;
+        bindingDescriptions[1].stride = sizeof(GpuInstance);
+        bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        VkVertexInputAttributeDescription attributes[6] = {};
+        attributes[0].binding = 0;
+        attributes[0].location = 0;
+        attributes[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributes[0].offset = offsetof(Vertex, x);
+        // A mat4 attribute takes one location per column.
+        for (uint32_t column = 0; column < 4; column++) {
+            attributes[1 + column].binding = 1;
+            attributes[1 + column].location = 1 + column;
+            attributes[1 + column].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attributes[1 + column].offset = offsetof(GpuInstance, transform) + column * 4 * sizeof(float);
+        }
+        attributes[5].binding = 1;
+        attributes[5].location = 5;
+        attributes[5].format = VK_FORMAT_R32_UINT;
+        attributes[5].offset = offsetof(GpuInstance, material);
+
         VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
         vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 2;
+        vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions;
+        vertexInputInfo.vertexAttributeDescriptionCount = 6;
+        vertexInputInfo.pVertexAttributeDescriptions = attributes;
 
         VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
         inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
         inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 
-        VkViewport viewport = {};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = (float)m_SwapChainExtent.width;
-        viewport.height = (float)m_SwapChainExtent.height;
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-
-        VkRect2D scissor = {};
-        scissor.offset = { 0, 0 };
-        scissor.extent = m_SwapChainExtent;
-
+        // Viewport and scissor are set while recording so a resize never invalidates the pipeline.
         VkPipelineViewportStateCreateInfo viewportState = {};
         viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewportState.viewportCount = 1;
-        viewportState.pViewports = &viewport;
         viewportState.scissorCount = 1;
-        viewportState.pScissors = &scissor;
+
+        VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+        VkPipelineDynamicStateCreateInfo dynamicState = {};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = 2;
+        dynamicState.pDynamicStates = dynamicStates;
 
         VkPipelineRasterizationStateCreateInfo rasterizer = {};
         rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -325,6 +585,12 @@ namespace RedPlasma {
         multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
         multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+        VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = VK_TRUE;
+        depthStencil.depthWriteEnable = VK_TRUE;
+        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
         VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
         colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
         colorBlendAttachment.blendEnable = VK_FALSE;
@@ -334,14 +600,31 @@ namespace RedPlasma {
         colorBlending.attachmentCount = 1;
         colorBlending.pAttachments = &colorBlendAttachment;
 
+        VkPipelineRenderingCreateInfo renderingInfo = {};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachmentFormats = &m_SwapChainImageFormat;
+        renderingInfo.depthAttachmentFormat = m_DepthFormat;
+
+        VkPushConstantRange pushConstantRange = {};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(DrawPushConstants);
+
         VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        VkDescriptorSetLayout bindlessLayout = m_BindlessHeap.GetLayout();
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &bindlessLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
         if (vkCreatePipelineLayout(m_LogicalDevice, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS) {
             return -9;
         }
 
         VkGraphicsPipelineCreateInfo pipelineInfo = {};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.pNext = &renderingInfo;
         pipelineInfo.stageCount = 2;
         pipelineInfo.pStages = shaderStages;
         pipelineInfo.pVertexInputState = &vertexInputInfo;
@@ -349,88 +632,278 @@ namespace RedPlasma {
         pipelineInfo.pViewportState = &viewportState;
         pipelineInfo.pRasterizationState = &rasterizer;
         pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState = &depthStencil;
         pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
         pipelineInfo.layout = m_PipelineLayout;
-        pipelineInfo.renderPass = m_RenderPass;
-        pipelineInfo.subpass = 0;
 
-        if (vkCreateGraphicsPipelines(m_LogicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_GraphicsPipeline) != VK_SUCCESS) {
+        if (vkCreateGraphicsPipelines(m_LogicalDevice, m_PipelineCache.GetHandle(), 1, &pipelineInfo, nullptr, &m_GraphicsPipeline) != VK_SUCCESS) {
             return -10;
         }
 
         vkDestroyShaderModule(m_LogicalDevice, fragShaderModule, nullptr);
         vkDestroyShaderModule(m_LogicalDevice, vertShaderModule, nullptr);
 
-        return CreateCommandPool();
+        return 0;
     }
 
-    int VulkanGraphicsDevice::CreateFramebuffers() {
-        m_Framebuffers.resize(m_SwapChainImageViews.size());
+    int VulkanGraphicsDevice::CreateCommandPool() {
+        m_Frames.resize(std::clamp<uint32_t>(m_Settings.framesInFlight, 1, 8));
+
+        for (auto& frame : m_Frames) {
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = m_graphicsFamilyIndex;
 
-        for (size_t i = 0; i < m_SwapChainImageViews.size(); i++) {
-            VkImageView attachments[] = {
-                m_SwapChainImageViews[i]
-            };
+            if (vkCreateCommandPool(m_LogicalDevice, &poolInfo, nullptr, &frame.commandPool) != VK_SUCCESS) {
+                return -11;
+            }
 
-            VkFramebufferCreateInfo framebufferInfo = {};
-            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-            framebufferInfo.renderPass = m_RenderPass;
-            framebufferInfo.attachmentCount = 1;
-            framebufferInfo.pAttachments = attachments;
-            framebufferInfo.width = m_SwapChainExtent.width;
-            framebufferInfo.height = m_SwapChainExtent.height;
-            framebufferInfo.layers = 1;
+            VkCommandBufferAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frame.commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
 
-            if (vkCreateFramebuffer(m_LogicalDevice, &framebufferInfo, nullptr, &m_Framebuffers[i]) != VK_SUCCESS) {
-                return -8;
+            if (vkAllocateCommandBuffers(m_LogicalDevice, &allocInfo, &frame.commandBuffer) != VK_SUCCESS) {
+                return -12;
             }
-        }
-        return CreateGraphicsPipeline();
-    }
 
-    int VulkanGraphicsDevice::CreateCommandPool() {
-        VkCommandPoolCreateInfo poolInfo = {};
-        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-        poolInfo.queueFamilyIndex = m_graphicsFamilyIndex;
+            if (m_TransferQueue != VK_NULL_HANDLE) {
+                VkCommandPoolCreateInfo transferPoolInfo = poolInfo;
+                transferPoolInfo.queueFamilyIndex = static_cast<uint32_t>(m_TransferFamilyIndex);
+                if (vkCreateCommandPool(m_LogicalDevice, &transferPoolInfo, nullptr, &frame.transferCommandPool) != VK_SUCCESS) {
+                    return -11;
+                }
+                allocInfo.commandPool = frame.transferCommandPool;
+                if (vkAllocateCommandBuffers(m_LogicalDevice, &allocInfo, &frame.transferCommandBuffer) != VK_SUCCESS) {
+                    return -12;
+                }
+            }
 
-        if (vkCreateCommandPool(m_LogicalDevice, &poolInfo, nullptr, &m_CommandPool) != VK_SUCCESS) {
-            return -11;
-        }
+            if (m_ComputeQueue != VK_NULL_HANDLE) {
+                VkCommandPoolCreateInfo computePoolInfo = poolInfo;
+                computePoolInfo.queueFamilyIndex = static_cast<uint32_t>(m_ComputeFamilyIndex);
+                if (vkCreateCommandPool(m_LogicalDevice, &computePoolInfo, nullptr, &frame.computeCommandPool) != VK_SUCCESS) {
+                    return -11;
+                }
+                allocInfo.commandPool = frame.computeCommandPool;
+                if (vkAllocateCommandBuffers(m_LogicalDevice, &allocInfo, &frame.computeCommandBuffer) != VK_SUCCESS) {
+                    return -12;
+                }
+            }
+
+            VkCommandPoolCreateInfo cachePoolInfo = poolInfo;
+            cachePoolInfo.flags = 0;
+            if (vkCreateCommandPool(m_LogicalDevice, &cachePoolInfo, nullptr, &frame.cachePool) != VK_SUCCESS) {
+                return -11;
+            }
+            allocInfo.commandPool = frame.cachePool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            if (vkAllocateCommandBuffers(m_LogicalDevice, &allocInfo, &frame.cachedDraws) != VK_SUCCESS) {
+                return -12;
+            }
 
-        m_CommandBuffers.resize(m_Framebuffers.size());
-        VkCommandBufferAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool = m_CommandPool;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandBufferCount = static_cast<uint32_t>(m_CommandBuffers.size());
+            // Secondaries are allocated on first use by the thread that owns the pool.
+            frame.threadPools.resize(m_JobSystem ? m_JobSystem->GetThreadSlotCount() : 0);
+            for (auto& threadPool : frame.threadPools) {
+                if (vkCreateCommandPool(m_LogicalDevice, &poolInfo, nullptr, &threadPool.pool) != VK_SUCCESS) {
+                    return -11;
+                }
+            }
+        }
+        m_RecordThreadMs.assign(m_JobSystem ? m_JobSystem->GetThreadSlotCount() : 1, 0.0);
 
-        if (vkAllocateCommandBuffers(m_LogicalDevice, &allocInfo, m_CommandBuffers.data()) != VK_SUCCESS) {
-            return -12;
+        if (m_FramePool.Initialize(m_LogicalDevice, m_MemoryAllocator, m_Settings.uploadBytesPerFrame, static_cast<uint32_t>(m_Frames.size()),
+                                   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT) != 0) {
+            return -17;
         }
 
-        return CreateSyncObjects();
+        return 0;
     }
 
     int VulkanGraphicsDevice::CreateSyncObjects() {
         VkSemaphoreCreateInfo semaphoreInfo = {};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        VkFenceCreateInfo fenceInfo = {};
-        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-        if (vkCreateSemaphore(m_LogicalDevice, &semaphoreInfo, nullptr, &m_ImageAvailableSemaphore) != VK_SUCCESS ||
-            vkCreateSemaphore(m_LogicalDevice, &semaphoreInfo, nullptr, &m_RenderFinishedSemaphore) != VK_SUCCESS ||
-            vkCreateFence(m_LogicalDevice, &fenceInfo, nullptr, &m_InFlightFence) != VK_SUCCESS) {
+        // The swapchain only takes binary semaphores, everything else syncs on the timelines.
+        for (auto& frame : m_Frames) {
+            if (vkCreateSemaphore(m_LogicalDevice, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS) {
+                return -13;
+            }
+        }
+        if (m_GraphicsTimeline.Initialize(m_LogicalDevice) != 0 ||
+            (m_TransferQueue != VK_NULL_HANDLE && m_TransferTimeline.Initialize(m_LogicalDevice) != 0) ||
+            (m_ComputeQueue != VK_NULL_HANDLE && m_ComputeTimeline.Initialize(m_LogicalDevice) != 0)) {
             return -13;
+        }
+
+        return CreateRenderFinishedSemaphores();
+    }
+
+    int VulkanGraphicsDevice::CreateRenderFinishedSemaphores() {
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        m_RenderFinishedSemaphores.resize(m_SwapChainImages.size(), VK_NULL_HANDLE);
+        for (auto& semaphore : m_RenderFinishedSemaphores) {
+            if (vkCreateSemaphore(m_LogicalDevice, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+                return -13;
             }
+        }
 
         return 0;
+    }
+
+    int VulkanGraphicsDevice::CreateHostBuffer(HostBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage, bool preferCached) {
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+        if (vkCreateBuffer(m_LogicalDevice, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS) {
+            return -1;
+        }
+
+        // Cached memory makes CPU reads (readback) fast, writes are fine with plain coherent memory.
+        VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        VkMemoryPropertyFlags preferred = preferCached ? static_cast<VkMemoryPropertyFlags>(VK_MEMORY_PROPERTY_HOST_CACHED_BIT) : 0;
+        if (m_MemoryAllocator.AllocateForBuffer(buffer.buffer, required, preferred, buffer.allocation) != 0) {
+            return -2;
+        }
+
+        buffer.mapped = buffer.allocation.mapped;
+        buffer.size = size;
+        return 0;
+    }
+
+    void VulkanGraphicsDevice::DestroyHostBuffer(HostBuffer& buffer) {
+        if (buffer.buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(m_LogicalDevice, buffer.buffer, nullptr);
+        }
+        m_MemoryAllocator.Free(buffer.allocation);
+        buffer = {};
+    }
+
+    int VulkanGraphicsDevice::CreateDeviceBuffer(DeviceBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateBuffer(m_LogicalDevice, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS) {
+            return -1;
+        }
+
+        if (m_MemoryAllocator.AllocateForBuffer(buffer.buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, buffer.allocation) != 0) {
+            return -2;
+        }
+
+        buffer.size = size;
+        return 0;
+    }
+
+    void VulkanGraphicsDevice::DestroyDeviceBuffer(DeviceBuffer& buffer) {
+        if (buffer.buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(m_LogicalDevice, buffer.buffer, nullptr);
+        }
+        m_MemoryAllocator.Free(buffer.allocation);
+        buffer = {};
+    }
+
+    int VulkanGraphicsDevice::CreateMeshBuffers() {
+        if (CreateHostBuffer(m_StagingBuffer, m_Settings.stagingBufferBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, false) != 0 ||
+            CreateDeviceBuffer(m_VertexBuffer, m_Settings.meshVertexBufferBytes,
+                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT) != 0 ||
+            CreateDeviceBuffer(m_IndexBuffer, m_Settings.meshIndexBufferBytes,
+                               VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT) != 0) {
+            return -21;
+        }
+
+        m_StagingRing.Initialize(m_StagingBuffer.mapped, m_StagingBuffer.size, static_cast<uint32_t>(m_Frames.size()));
+        m_VertexBufferUsed = 0;
+        m_IndexBufferUsed = 0;
+        m_Meshes.clear();
+        return 0;
+    }
+
+    int VulkanGraphicsDevice::CreateMaterialResources() {
+        // Sized for every handle a DrawKey can carry, so the buffer and its bindless slot never change.
+        VkDeviceSize materialBytes = (static_cast<VkDeviceSize>(DrawKey::MaxMaterial) + 1) * sizeof(GpuMaterial);
+        if (CreateDeviceBuffer(m_MaterialBuffer, materialBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT) != 0) {
+            return -26;
+        }
+        m_MaterialBufferIndex = m_BindlessHeap.AddStorageBuffer(m_MaterialBuffer.buffer, 0, m_MaterialBuffer.size);
+        if (m_MaterialBufferIndex == VulkanBindlessHeap::InvalidIndex) {
+            return -26;
+        }
+
+        // Texture and material handle 0, for materials without a texture and draws without a material.
+        const uint8_t white[4] = { 255, 255, 255, 255 };
+        TextureDesc whiteTexture;
+        whiteTexture.width = 1;
+        whiteTexture.height = 1;
+        whiteTexture.pixels = white;
+        m_Textures.clear();
+        m_Materials.clear();
+        m_MaterialCount.store(0, std::memory_order_release);
+        if (CreateTexture(whiteTexture) < 0 || CreateMaterial(MaterialDesc()) < 0) {
+            return -26;
+        }
+        return 0;
+    }
+
+    int VulkanGraphicsDevice::AllocateFrameUpload(VkDeviceSize size, VkDeviceSize alignment, LinearAllocation& outAllocation) {
+        if (m_FramePool.Allocate(m_CurrentFrame, size, alignment, outAllocation)) {
+            return 0;
+        }
+        if (!m_FramePool.IsInitialized()) {
+            return -1;
+        }
+
+        // Frames still in flight and the allocations this frame already made keep reading the old pool, so it
+        // is released once everything submitted up to now has retired.
+        VkDeviceSize bytesPerFrame = m_FramePool.GetBytesPerFrame() * 2;
+        while (bytesPerFrame < size + alignment) {
+            bytesPerFrame *= 2;
+        }
+        VulkanLinearPool grown;
+        if (grown.Initialize(m_LogicalDevice, m_MemoryAllocator, bytesPerFrame, m_FramePool.GetFrameCount(), m_FramePool.GetUsage()) != 0) {
+            return -2;
+        }
+        VulkanLinearPool retired = m_FramePool;
+        m_GraphicsTimeline.Defer(m_GraphicsTimeline.GetNextValue(), [this, retired]() mutable { retired.Shutdown(m_MemoryAllocator); });
+        m_FramePool = grown;
+
+        return m_FramePool.Allocate(m_CurrentFrame, size, alignment, outAllocation) ? 0 : -1;
+    }
+
+    void VulkanGraphicsDevice::DestroyFrameContexts() {
+        m_FramePool.Shutdown(m_MemoryAllocator);
+        for (auto& frame : m_Frames) {
+            DestroyHostBuffer(frame.readback.host);
+            vkDestroySemaphore(m_LogicalDevice, frame.imageAvailableSemaphore, nullptr);
+            // Destroying the pool frees its command buffer as well.
+            vkDestroyCommandPool(m_LogicalDevice, frame.commandPool, nullptr);
+            vkDestroyCommandPool(m_LogicalDevice, frame.transferCommandPool, nullptr);
+            vkDestroyCommandPool(m_LogicalDevice, frame.computeCommandPool, nullptr);
+            vkDestroyCommandPool(m_LogicalDevice, frame.cachePool, nullptr);
+            for (auto& threadPool : frame.threadPools) {
+                vkDestroyCommandPool(m_LogicalDevice, threadPool.pool, nullptr);
+            }
+        }
+        m_Frames.clear();
+        m_CurrentFrame = 0;
     }
 
     int VulkanGraphicsDevice::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+        FrameContext& frame = m_Frames[m_CurrentFrame];
+        frame.uploadPending = false;
+        frame.cullPending = false;
+
         VkCommandBufferBeginInfo beginInfo = {};
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
@@ -438,35 +911,635 @@ namespace RedPlasma {
             return -14;
         }
 
-        VkRenderPassBeginInfo renderPassInfo = {};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = m_RenderPass;
-        renderPassInfo.framebuffer = m_Framebuffers[imageIndex];
-        renderPassInfo.renderArea.offset = { 0, 0 };
-        renderPassInfo.renderArea.extent = m_SwapChainExtent;
+        m_GpuProfiler.BeginFrame(commandBuffer, m_CurrentFrame);
+        uint32_t frameZone = m_GpuProfiler.BeginZone(commandBuffer, "Frame");
+
+        std::vector<PendingCopy> copies;
+        std::vector<PendingImageCopy> imageCopies;
+        TakePendingUploads(copies, imageCopies);
+        std::fill(m_RecordThreadMs.begin(), m_RecordThreadMs.end(), 0.0);
+        m_FrameStats.recordJobs = 0;
+
+        m_RenderGraph.Reset();
+        // The acquire semaphore is waited on at this stage, the first barrier on the image has to chain with it.
+        RenderResourceState acquired;
+        acquired.stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        RenderResource backbuffer = m_RenderGraph.ImportImage(m_SwapChainImages[imageIndex], m_SwapChainImageViews[imageIndex],
+                                                              m_SwapChainImageFormat, m_SwapChainExtent, VK_IMAGE_ASPECT_COLOR_BIT, acquired);
+        RenderResource vertexBuffer = InvalidRenderResource;
+        RenderResource indexBuffer = InvalidRenderResource;
+        RenderResource materialBuffer = InvalidRenderResource;
+        bool transferred = !copies.empty() && m_TransferQueue != VK_NULL_HANDLE && RecordTransferUploads(frame, copies) == 0;
+        // Also used on its own when the full graph fails, the staging space of the copies retires with this frame.
+        auto addUploadPasses = [&]() {
+            vertexBuffer = m_RenderGraph.ImportBuffer(m_VertexBuffer.buffer, {});
+            indexBuffer = m_RenderGraph.ImportBuffer(m_IndexBuffer.buffer, {});
+            materialBuffer = m_RenderGraph.ImportBuffer(m_MaterialBuffer.buffer, {});
+            if (transferred) {
+                // The copies already ran on the transfer queue, this only takes the written ranges over to graphics.
+                m_RenderGraph.AddPass("UploadAcquire", [this, &copies](VkCommandBuffer cmd) { RecordUploadOwnership(cmd, copies, false); })
+                    .Write(vertexBuffer, RenderAccess::TransferWrite)
+                    .Write(indexBuffer, RenderAccess::TransferWrite)
+                    .Write(materialBuffer, RenderAccess::TransferWrite);
+            } else if (!copies.empty()) {
+                m_RenderGraph.AddPass("Upload", [this, &copies](VkCommandBuffer cmd) { RecordPendingUploads(cmd, copies); })
+                    .Write(vertexBuffer, RenderAccess::TransferWrite)
+                    .Write(indexBuffer, RenderAccess::TransferWrite)
+                    .Write(materialBuffer, RenderAccess::TransferWrite);
+            }
+            if (!imageCopies.empty()) {
+                m_RenderGraph.AddPass("TextureUpload", [this, &imageCopies](VkCommandBuffer cmd) { RecordTextureUploads(cmd, imageCopies); })
+                    .SetSideEffect();
+            }
+        };
+        addUploadPasses();
+
+        TransientImageDesc depthDesc;
+        depthDesc.format = m_DepthFormat;
+        depthDesc.extent = m_SwapChainExtent;
+        depthDesc.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        depthDesc.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        RenderResource depth = m_RenderGraph.CreateTransientImage(depthDesc);
+
+        if (m_DrawListConsumed && !m_DrawList.IsEmpty()) {
+            // Nothing was submitted or reused since the last frame, so there is nothing to draw.
+            m_DrawList.Clear();
+            m_DrawListVersion++;
+        }
+        if (m_BuiltDrawListVersion != m_DrawListVersion) {
+            m_DrawList.Build();
+            m_BuiltDrawListVersion = m_DrawListVersion;
+        }
+        bool gpuCulling = m_GpuCulling.IsInitialized() && !m_DrawList.IsEmpty() && UploadCullInput(frame) == 0;
+        if (gpuCulling) {
+            // The frame upload space may go to other data this frame, the instances are written again next time.
+            frame.instancesVersion = 0;
+        } else if (UploadDrawInstances(frame) != 0) {
+            std::cout << "Failed to grow the frame upload space, skipping the draws of this frame" << std::endl;
+            m_DrawList.Clear();
+            m_DrawList.Build();
+            m_DrawListVersion++;
+            m_BuiltDrawListVersion = m_DrawListVersion;
+        }
+        uint32_t drawCount = static_cast<uint32_t>(m_DrawList.GetBatches().size());
+        m_FrameStats.submittedDraws = m_DrawList.GetDrawCount();
+        m_FrameStats.drawCalls = drawCount;
+
+        // Draws that match the previous frame are likely to stay, so they are recorded once into the context's
+        // cached secondary. Draws that change every frame never pay for recording twice.
+        bool replay = frame.cachedListVersion == m_DrawListVersion && frame.cachedStateVersion == m_DrawStateVersion;
+        if (!replay && m_Settings.cacheStaticDraws && drawCount > 0 &&
+            m_LastDrawListVersion == m_DrawListVersion && m_LastDrawStateVersion == m_DrawStateVersion) {
+            replay = RecordCachedDraws(frame, gpuCulling, drawCount) == 0;
+        }
+        m_LastDrawListVersion = m_DrawListVersion;
+        m_LastDrawStateVersion = m_DrawStateVersion;
+        m_FrameStats.drawsReplayed = replay;
+
+        RenderResource cullOutput = InvalidRenderResource;
+        if (gpuCulling) {
+            cullOutput = m_RenderGraph.ImportBuffer(m_GpuCulling.GetOutputBuffer(m_CurrentFrame), {});
+            if (m_ComputeQueue != VK_NULL_HANDLE && RecordComputeCulling(frame) == 0) {
+                // The cull passes already ran on the compute queue, this only takes their output over to graphics.
+                m_RenderGraph.AddPass("CullAcquire", [this](VkCommandBuffer cmd) { RecordCullOwnership(cmd, false); })
+                    .Write(cullOutput, RenderAccess::ComputeStorageWrite);
+            } else {
+                m_RenderGraph.AddPass("CullReset", [this](VkCommandBuffer cmd) { m_GpuCulling.RecordReset(cmd, m_CurrentFrame); })
+                    .Write(cullOutput, RenderAccess::TransferWrite);
+                m_RenderGraph.AddPass("Cull", [this](VkCommandBuffer cmd) { m_GpuCulling.RecordCull(cmd, m_CurrentFrame); })
+                    .Write(cullOutput, RenderAccess::ComputeStorageWrite);
+                m_RenderGraph.AddPass("CullCompact", [this](VkCommandBuffer cmd) { m_GpuCulling.RecordCompact(cmd, m_CurrentFrame); })
+                    .Write(cullOutput, RenderAccess::ComputeStorageWrite);
+            }
+        }
+
+        bool parallel = !replay && !gpuCulling && m_JobSystem != nullptr && !frame.threadPools.empty() &&
+                        drawCount > m_Settings.drawsPerRecordJob;
+        RenderPassBuilder mainPass = m_RenderGraph.AddPass("MainPass", [this, &frame, replay, parallel, gpuCulling, drawCount](VkCommandBuffer cmd) {
+            if (replay) {
+                vkCmdExecuteCommands(cmd, 1, &frame.cachedDraws);
+            } else if (gpuCulling) {
+                RecordGpuCulledDraws(cmd);
+            } else if (parallel) {
+                std::vector<VkCommandBuffer> secondaries;
+                RecordDrawsParallel(frame, secondaries);
+                if (!secondaries.empty()) {
+                    vkCmdExecuteCommands(cmd, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+                }
+            } else {
+                FrameClock::time_point drawStart = FrameClock::now();
+                RecordDrawRange(cmd, frame.instances, 0, drawCount);
+                if (!m_RecordThreadMs.empty()) {
+                    m_RecordThreadMs[GetRecordThreadIndex()] = ElapsedMs(drawStart, FrameClock::now());
+                }
+            }
+        });
+        mainPass.SetColorAttachment(backbuffer, {{0.0f, 0.0f, 0.0f, 1.0f}})
+                .SetDepthAttachment(depth, 1.0f)
+                .Read(vertexBuffer, RenderAccess::VertexInputRead)
+                .Read(indexBuffer, RenderAccess::VertexInputRead)
+                .Read(materialBuffer, RenderAccess::GraphicsStorageRead);
+        if (gpuCulling) {
+            mainPass.Read(cullOutput, RenderAccess::IndirectRead)
+                    .Read(cullOutput, RenderAccess::VertexInputRead);
+        }
+        if (replay || parallel) {
+            mainPass.SetRenderingFlags(VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+        }
+
+        if (m_ReadbackSupported) {
+            RenderResource readbackBuffer = m_RenderGraph.ImportBuffer(frame.readback.host.buffer, {});
+            m_RenderGraph.AddPass("Readback", [this, imageIndex, &frame](VkCommandBuffer cmd) { RecordReadback(cmd, imageIndex, frame.readback); })
+                .Read(backbuffer, RenderAccess::TransferRead)
+                .Write(readbackBuffer, RenderAccess::TransferWrite);
+            m_RenderGraph.MarkOutput(readbackBuffer, RenderAccess::HostRead);
+        }
+        m_RenderGraph.MarkOutput(backbuffer, RenderAccess::Present);
+
+        int graphResult = m_RenderGraph.Compile(m_CurrentFrame);
+        if (graphResult != 0) {
+            std::cout << "Failed to compile the render graph (" << graphResult << "), recording only the uploads" << std::endl;
+            // Nothing draws, so nothing takes the cull output over either.
+            frame.cullPending = false;
+            m_RenderGraph.Reset();
+            addUploadPasses();
+            // Nothing reads the buffers in this graph, without outputs the copies would be culled.
+            m_RenderGraph.MarkOutput(vertexBuffer, RenderAccess::VertexInputRead);
+            m_RenderGraph.MarkOutput(indexBuffer, RenderAccess::VertexInputRead);
+            m_RenderGraph.MarkOutput(materialBuffer, RenderAccess::GraphicsStorageRead);
+            if (m_RenderGraph.Compile(m_CurrentFrame) != 0) {
+                std::cout << "Failed to compile the upload passes, the uploads of this frame are lost" << std::endl;
+                m_RenderGraph.Reset();
+            }
+        }
+        m_RenderGraph.Execute(commandBuffer, m_GpuProfiler);
+        m_FrameStats.recordThreadMs = m_RecordThreadMs;
+        m_GpuProfiler.EndZone(commandBuffer, frameZone);
+        m_DrawListConsumed = true;
+        m_DrawListReused = false;
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            // Nothing of this frame runs, the other queues must not release ranges graphics never acquires.
+            frame.uploadPending = false;
+            frame.cullPending = false;
+            return -15;
+        }
+
+        return graphResult == 0 ? 0 : -23;
+    }
+
+    int VulkanGraphicsDevice::UploadDrawInstances(FrameContext& frame) {
+        const std::vector<DrawInstance>& instances = m_DrawList.GetInstances();
+        VkDeviceSize size = instances.size() * sizeof(GpuInstance);
+        if (size == 0) {
+            frame.instances = {};
+            frame.instancesVersion = 0;
+            return 0;
+        }
+
+        LinearAllocation allocation;
+        if (AllocateFrameUpload(size, alignof(GpuInstance), allocation) != 0) {
+            frame.instances = {};
+            frame.instancesVersion = 0;
+            return -1;
+        }
+
+        // The instances come first in the frame upload space, so an unchanged list usually lands on the range
+        // this context wrote last time and does not need copying again.
+        if (allocation.buffer == frame.instances.buffer && allocation.offset == frame.instances.offset &&
+            frame.instancesVersion == m_DrawListVersion) {
+            return 0;
+        }
+        if (allocation.buffer != frame.instances.buffer || allocation.offset != frame.instances.offset) {
+            // The cached draws bind the instance range they were recorded with.
+            frame.cachedListVersion = 0;
+        }
+        frame.instances = allocation;
+        frame.instancesVersion = 0;
+
+        // Batches are contiguous instance ranges that share one material.
+        auto* target = static_cast<GpuInstance*>(frame.instances.mapped);
+        for (const DrawBatch& batch : m_DrawList.GetBatches()) {
+            for (uint32_t i = batch.firstInstance; i < batch.firstInstance + batch.instanceCount; i++) {
+                std::memcpy(target[i].transform, instances[i].transform, sizeof(target[i].transform));
+                target[i].material = batch.material;
+            }
+        }
+        frame.instancesVersion = m_DrawListVersion;
+        return 0;
+    }
+
+    int VulkanGraphicsDevice::UploadCullInput(FrameContext& frame) {
+        // The planes are pushed with every dispatch, only the objects and batches can be left as they are.
+        m_GpuCulling.SetViewProjection(m_CurrentFrame, m_ViewProjection);
+        if (frame.cullInputVersion == m_DrawListVersion && frame.cullStateVersion == m_DrawStateVersion) {
+            return 0;
+        }
+        frame.cullInputVersion = 0;
+        frame.cullStateVersion = 0;
+
+        const std::vector<DrawBatch>& batches = m_DrawList.GetBatches();
+        const std::vector<DrawInstance>& instances = m_DrawList.GetInstances();
+        CullObject* objects = nullptr;
+        CullBatch* cullBatches = nullptr;
+        if (m_GpuCulling.BeginFrame(m_CurrentFrame, static_cast<uint32_t>(instances.size()), static_cast<uint32_t>(batches.size()),
+                                    objects, cullBatches) != 0) {
+            return -1;
+        }
 
-        VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};;
-        renderPassInfo.clearValueCount = 1;
-        renderPassInfo.pClearValues = &clearColor;
+        for (uint32_t b = 0; b < batches.size(); b++) {
+            const DrawBatch& batch = batches[b];
+            CullBatch& cullBatch = cullBatches[b];
+            cullBatch = {};
+            cullBatch.firstInstance = batch.firstInstance;
+            cullBatch.material = batch.material;
+            // The mesh may have been uploaded after this frame took its list, its objects are culled.
+            if (batch.mesh == 0 || batch.mesh > m_DrawMeshes.size()) {
+                cullBatch.boundsRadius = -1.0f;
+            } else {
+                const MeshRecord& mesh = m_DrawMeshes[batch.mesh - 1];
+                std::memcpy(cullBatch.boundsCenter, mesh.boundsCenter, sizeof(cullBatch.boundsCenter));
+                cullBatch.boundsRadius = mesh.boundsRadius;
+                cullBatch.indexCount = mesh.indexCount;
+                cullBatch.firstIndex = mesh.firstIndex;
+                cullBatch.vertexOffset = mesh.vertexOffset;
+            }
 
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+            for (uint32_t i = batch.firstInstance; i < batch.firstInstance + batch.instanceCount; i++) {
+                std::memcpy(objects[i].transform, instances[i].transform, sizeof(objects[i].transform));
+                objects[i].batch = b;
+            }
+        }
+        frame.cullInputVersion = m_DrawListVersion;
+        frame.cullStateVersion = m_DrawStateVersion;
+        return 0;
+    }
 
+    void VulkanGraphicsDevice::BindDrawState(VkCommandBuffer commandBuffer, VkBuffer instanceBuffer, VkDeviceSize instanceOffset) {
         vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipeline);
 
-        vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+        VkViewport viewport = {};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float)m_SwapChainExtent.width;
+        viewport.height = (float)m_SwapChainExtent.height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        VkRect2D scissor = {};
+        scissor.offset = { 0, 0 };
+        scissor.extent = m_SwapChainExtent;
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        // Bound once, every material and texture is reached through it by index.
+        VkDescriptorSet bindlessSet = m_BindlessHeap.GetSet();
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &bindlessSet, 0, nullptr);
 
-        vkCmdEndRenderPass(commandBuffer);
+        DrawPushConstants constants = {};
+        std::memcpy(constants.viewProjection, m_ViewProjection, sizeof(constants.viewProjection));
+        constants.materialBuffer = m_MaterialBufferIndex;
+        vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
 
-        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        VkBuffer vertexBuffers[] = { m_VertexBuffer.buffer, instanceBuffer };
+        VkDeviceSize vertexOffsets[] = { 0, instanceOffset };
+        vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, vertexOffsets);
+        vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    }
+
+    void VulkanGraphicsDevice::RecordGpuCulledDraws(VkCommandBuffer commandBuffer) {
+        BindDrawState(commandBuffer, m_GpuCulling.GetOutputBuffer(m_CurrentFrame), m_GpuCulling.GetInstanceOffset(m_CurrentFrame));
+        m_GpuCulling.RecordDraws(commandBuffer, m_CurrentFrame);
+    }
+
+    void VulkanGraphicsDevice::RecordDrawRange(VkCommandBuffer commandBuffer, const LinearAllocation& instances, uint32_t firstBatch, uint32_t lastBatch) {
+        BindDrawState(commandBuffer, instances.buffer, instances.offset);
+
+        // The material color travels with each instance, so batches only differ in mesh and instance range.
+        const std::vector<DrawBatch>& batches = m_DrawList.GetBatches();
+        for (uint32_t i = firstBatch; i < lastBatch; i++) {
+            const DrawBatch& batch = batches[i];
+            // Handles are validated on submit, but the mesh may have been uploaded after this frame took its list.
+            if (batch.mesh == 0 || batch.mesh > m_DrawMeshes.size()) {
+                continue;
+            }
+            const MeshRecord& mesh = m_DrawMeshes[batch.mesh - 1];
+            vkCmdDrawIndexed(commandBuffer, mesh.indexCount, batch.instanceCount, mesh.firstIndex, mesh.vertexOffset, batch.firstInstance);
+        }
+    }
+
+    VkCommandBuffer VulkanGraphicsDevice::AcquireSecondaryCommandBuffer(ThreadCommandPool& threadPool) {
+        if (threadPool.used == threadPool.secondaries.size()) {
+            VkCommandBufferAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = threadPool.pool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer;
+            if (vkAllocateCommandBuffers(m_LogicalDevice, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+                return VK_NULL_HANDLE;
+            }
+            threadPool.secondaries.push_back(commandBuffer);
+        }
+        return threadPool.secondaries[threadPool.used++];
+    }
+
+    int VulkanGraphicsDevice::BeginDrawSecondary(VkCommandBuffer secondary, VkCommandBufferUsageFlags flags) {
+        // Has to describe the attachments of the vkCmdBeginRendering the secondary is executed in.
+        VkCommandBufferInheritanceRenderingInfo renderingInheritance = {};
+        renderingInheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+        renderingInheritance.colorAttachmentCount = 1;
+        renderingInheritance.pColorAttachmentFormats = &m_SwapChainImageFormat;
+        renderingInheritance.depthAttachmentFormat = m_DepthFormat;
+        renderingInheritance.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkCommandBufferInheritanceInfo inheritanceInfo = {};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext = &renderingInheritance;
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        return vkBeginCommandBuffer(secondary, &beginInfo) == VK_SUCCESS ? 0 : -1;
+    }
+
+    int VulkanGraphicsDevice::RecordCachedDraws(FrameContext& frame, bool gpuCulling, uint32_t drawCount) {
+        // The last submission from this context has retired, so its cached draws are free to be re-recorded.
+        frame.cachedListVersion = 0;
+        frame.cachedStateVersion = 0;
+        vkResetCommandPool(m_LogicalDevice, frame.cachePool, 0);
+        if (BeginDrawSecondary(frame.cachedDraws, 0) != 0) {
+            return -1;
+        }
+
+        FrameClock::time_point start = FrameClock::now();
+        if (gpuCulling) {
+            RecordGpuCulledDraws(frame.cachedDraws);
+        } else {
+            RecordDrawRange(frame.cachedDraws, frame.instances, 0, drawCount);
+        }
+        if (!m_RecordThreadMs.empty()) {
+            m_RecordThreadMs[GetRecordThreadIndex()] = ElapsedMs(start, FrameClock::now());
+        }
+        if (vkEndCommandBuffer(frame.cachedDraws) != VK_SUCCESS) {
+            return -2;
+        }
+
+        frame.cachedListVersion = m_DrawListVersion;
+        frame.cachedStateVersion = m_DrawStateVersion;
+        return 0;
+    }
+
+    uint32_t VulkanGraphicsDevice::GetRecordThreadIndex() const {
+        return m_JobSystem != nullptr ? m_JobSystem->GetCurrentThreadIndex() : 0;
+    }
+
+    void VulkanGraphicsDevice::RecordDrawsParallel(FrameContext& frame, std::vector<VkCommandBuffer>& outSecondaries) {
+        uint32_t drawCount = static_cast<uint32_t>(m_DrawList.GetBatches().size());
+        uint32_t drawsPerJob = std::max(m_Settings.drawsPerRecordJob, 1u);
+        uint32_t jobCount = (drawCount + drawsPerJob - 1) / drawsPerJob;
+        std::vector<VkCommandBuffer> secondaries(jobCount, VK_NULL_HANDLE);
+
+        // Pools and timing slots are keyed on the job system's thread index, which is unique per executing thread
+        // however many threads drive the system. The chunks keep their draw order in the primary.
+        m_JobSystem->ParallelFor(jobCount, 1, [&](uint32_t begin, uint32_t end) {
+            uint32_t threadIndex = GetRecordThreadIndex();
+            FrameClock::time_point start = FrameClock::now();
+            for (uint32_t job = begin; job < end; job++) {
+                VkCommandBuffer secondary = AcquireSecondaryCommandBuffer(frame.threadPools[threadIndex]);
+                if (secondary == VK_NULL_HANDLE || BeginDrawSecondary(secondary, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT) != 0) {
+                    continue;
+                }
+                RecordDrawRange(secondary, frame.instances, job * drawsPerJob, std::min(drawCount, (job + 1) * drawsPerJob));
+                if (vkEndCommandBuffer(secondary) == VK_SUCCESS) {
+                    secondaries[job] = secondary;
+                }
+            }
+            m_RecordThreadMs[threadIndex] += ElapsedMs(start, FrameClock::now());
+        });
+
+        outSecondaries.clear();
+        for (VkCommandBuffer secondary : secondaries) {
+            if (secondary != VK_NULL_HANDLE) {
+                outSecondaries.push_back(secondary);
+            }
+        }
+        m_FrameStats.recordJobs = jobCount;
+    }
+
+    void VulkanGraphicsDevice::TakePendingUploads(std::vector<PendingCopy>& outCopies, std::vector<PendingImageCopy>& outImageCopies) {
+        std::lock_guard<std::mutex> lock(m_UploadMutex);
+
+        // Everything staged up to here is consumed by this frame, later uploads go with the next one.
+        m_StagingRing.OnFrameRecorded(m_CurrentFrame);
+        uint64_t retireValue = m_GraphicsTimeline.GetNextValue();
+        for (auto& staging : m_PendingStaging) {
+            m_GraphicsTimeline.Defer(retireValue, [this, staging]() mutable { DestroyHostBuffer(staging); });
+        }
+        m_PendingStaging.clear();
+        if (m_DrawMeshes.size() != m_Meshes.size()) {
+            // Draws of meshes that were not uploaded yet were skipped while recording.
+            m_DrawMeshes = m_Meshes;
+            m_DrawStateVersion++;
+        }
+        outCopies.swap(m_PendingCopies);
+        m_PendingCopies.clear();
+        outImageCopies.swap(m_PendingImageCopies);
+        m_PendingImageCopies.clear();
+    }
+
+    void VulkanGraphicsDevice::RecordPendingUploads(VkCommandBuffer commandBuffer, const std::vector<PendingCopy>& copies) {
+        // Copies are queued in upload order, so batch consecutive ones that share source and destination.
+        std::vector<VkBufferCopy> regions;
+        size_t batchStart = 0;
+        for (size_t i = 0; i <= copies.size(); i++) {
+            bool flush = i == copies.size() ||
+                         copies[i].source != copies[batchStart].source ||
+                         copies[i].destination != copies[batchStart].destination;
+            if (flush) {
+                vkCmdCopyBuffer(commandBuffer, copies[batchStart].source, copies[batchStart].destination,
+                                static_cast<uint32_t>(regions.size()), regions.data());
+                regions.clear();
+                batchStart = i;
+            }
+            if (i < copies.size()) {
+                regions.push_back(copies[i].region);
+            }
+        }
+    }
+
+    int VulkanGraphicsDevice::RecordTransferUploads(FrameContext& frame, const std::vector<PendingCopy>& copies) {
+        // Safe to reset, the graphics submit that waited on the last transfer from this context has retired.
+        vkResetCommandPool(m_LogicalDevice, frame.transferCommandPool, 0);
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(frame.transferCommandBuffer, &beginInfo) != VK_SUCCESS) {
+            return -14;
+        }
+        RecordPendingUploads(frame.transferCommandBuffer, copies);
+        RecordUploadOwnership(frame.transferCommandBuffer, copies, true);
+        if (vkEndCommandBuffer(frame.transferCommandBuffer) != VK_SUCCESS) {
             return -15;
         }
+        frame.uploadPending = true;
+        return 0;
+    }
+
+    void VulkanGraphicsDevice::RecordUploadOwnership(VkCommandBuffer commandBuffer, const std::vector<PendingCopy>& copies, bool release) {
+        // Only the written ranges change hands. They held nothing before the copy, so the transfer queue writes them
+        // without a release from graphics first, and ranges already in use by draws stay with graphics throughout.
+        std::vector<VkBufferMemoryBarrier2> barriers;
+        barriers.reserve(copies.size());
+        for (const auto& copy : copies) {
+            VkBufferMemoryBarrier2 barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+            if (release) {
+                barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+                barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            } else {
+                // Acquired as if the copy had happened here, the render graph then orders it against the draws.
+                barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+                barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            }
+            barrier.srcQueueFamilyIndex = static_cast<uint32_t>(m_TransferFamilyIndex);
+            barrier.dstQueueFamilyIndex = static_cast<uint32_t>(m_graphicsFamilyIndex);
+            barrier.buffer = copy.destination;
+            barrier.offset = copy.region.dstOffset;
+            barrier.size = copy.region.size;
+            barriers.push_back(barrier);
+        }
+
+        VkDependencyInfo dependency = {};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+        dependency.pBufferMemoryBarriers = barriers.data();
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+    }
+
+    int VulkanGraphicsDevice::RecordComputeCulling(FrameContext& frame) {
+        // Safe to reset, the graphics submit that waited on the last cull from this context has retired.
+        vkResetCommandPool(m_LogicalDevice, frame.computeCommandPool, 0);
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(frame.computeCommandBuffer, &beginInfo) != VK_SUCCESS) {
+            return -14;
+        }
 
+        // The same order the render graph gives the passes on the graphics queue: clear, cull, compact.
+        VkBufferMemoryBarrier2 barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = m_GpuCulling.GetOutputBuffer(m_CurrentFrame);
+        barrier.size = VK_WHOLE_SIZE;
+        VkDependencyInfo dependency = {};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.bufferMemoryBarrierCount = 1;
+        dependency.pBufferMemoryBarriers = &barrier;
+
+        m_GpuCulling.RecordReset(frame.computeCommandBuffer, m_CurrentFrame);
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        vkCmdPipelineBarrier2(frame.computeCommandBuffer, &dependency);
+
+        m_GpuCulling.RecordCull(frame.computeCommandBuffer, m_CurrentFrame);
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        vkCmdPipelineBarrier2(frame.computeCommandBuffer, &dependency);
+
+        m_GpuCulling.RecordCompact(frame.computeCommandBuffer, m_CurrentFrame);
+        RecordCullOwnership(frame.computeCommandBuffer, true);
+        if (vkEndCommandBuffer(frame.computeCommandBuffer) != VK_SUCCESS) {
+            return -15;
+        }
+        frame.cullPending = true;
         return 0;
     }
 
+    void VulkanGraphicsDevice::RecordCullOwnership(VkCommandBuffer commandBuffer, bool release) {
+        // The passes overwrite everything the draws read, so the buffer goes back to compute next time without a
+        // release from graphics, like the upload ranges do.
+        VkBufferMemoryBarrier2 barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        if (release) {
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        } else {
+            // Acquired as if the compact pass had run here, the render graph then orders it against the draws.
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        }
+        barrier.srcQueueFamilyIndex = static_cast<uint32_t>(m_ComputeFamilyIndex);
+        barrier.dstQueueFamilyIndex = static_cast<uint32_t>(m_graphicsFamilyIndex);
+        barrier.buffer = m_GpuCulling.GetOutputBuffer(m_CurrentFrame);
+        barrier.size = VK_WHOLE_SIZE;
+
+        VkDependencyInfo dependency = {};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.bufferMemoryBarrierCount = 1;
+        dependency.pBufferMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+    }
+
+    void VulkanGraphicsDevice::RecordTextureUploads(VkCommandBuffer commandBuffer, const std::vector<PendingImageCopy>& copies) {
+        // The images live outside the render graph. They go from undefined to sampled within this pass,
+        // and nothing samples them before the draws that follow it.
+        std::vector<VkImageMemoryBarrier2> barriers(copies.size());
+        for (size_t i = 0; i < copies.size(); i++) {
+            VkImageMemoryBarrier2& barrier = barriers[i];
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = copies[i].image;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        }
+        VkDependencyInfo dependency = {};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+        dependency.pImageMemoryBarriers = barriers.data();
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+
+        for (const auto& copy : copies) {
+            vkCmdCopyBufferToImage(commandBuffer, copy.source, copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+        }
+
+        for (auto& barrier : barriers) {
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+    }
+
+    void VulkanGraphicsDevice::RecordReadback(VkCommandBuffer commandBuffer, uint32_t imageIndex, const ReadbackTarget& target) {
+        VkBufferImageCopy region = {};
+        region.bufferOffset = 0;
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        region.imageExtent = { target.width, target.height, 1 };
+        vkCmdCopyImageToBuffer(commandBuffer, m_SwapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, target.host.buffer, 1, &region);
+    }
+
     void VulkanGraphicsDevice::WaitIdle() {
         if (m_LogicalDevice != VK_NULL_HANDLE) {
             vkDeviceWaitIdle(m_LogicalDevice);
+            m_GraphicsTimeline.Collect();
+            m_CompletedFrameNumber = m_FrameStats.frameNumber;
         }
     }
 
@@ -478,6 +1551,14 @@ namespace RedPlasma {
 
     }
 
+    void VulkanGraphicsDevice::Configure(const GraphicsDeviceSettings &settings) {
+        m_Settings = settings;
+    }
+
+    void VulkanGraphicsDevice::SetJobSystem(JobSystem* jobSystem) {
+        m_JobSystem = jobSystem;
+    }
+
     int VulkanGraphicsDevice::Initialize() {
 
         VkApplicationInfo appInfo = {};
@@ -507,11 +1588,21 @@ namespace RedPlasma {
         std::vector<VkPhysicalDevice> devices(devicesCount);
         vkEnumeratePhysicalDevices(m_Instance, &devicesCount, devices.data());
 
-        m_PhysicalDevice = devices[0];
-
-        VkPhysicalDeviceProperties deviceProperties;
-        vkGetPhysicalDeviceProperties(m_PhysicalDevice, &deviceProperties);
-        m_DeviceName = deviceProperties.deviceName;
+        // Dynamic rendering is core in 1.3, older devices are not usable by this backend.
+        for (VkPhysicalDevice device : devices) {
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(device, &properties);
+            if (properties.apiVersion >= VK_API_VERSION_1_3) {
+                m_PhysicalDevice = device;
+                m_DeviceProperties = properties;
+                break;
+            }
+        }
+        if (m_PhysicalDevice == VK_NULL_HANDLE) {
+            std::cout << "No Vulkan 1.3 capable GPU found!" << std::endl;
+            return -3;
+        }
+        m_DeviceName = m_DeviceProperties.deviceName;
 
         std::cout << "Vulkan GPU selected: " << m_DeviceName << std::endl;
 
@@ -523,7 +1614,10 @@ namespace RedPlasma {
         // 1. Wait for GPU to be completely finished
         vkDeviceWaitIdle(m_LogicalDevice);
 
-        // 2. Destroy "Level 3" objects (Pipeline, Framebuffers)
+        m_GpuProfiler.Shutdown();
+        m_PipelineCache.Shutdown();
+
+        // 2. Destroy "Level 3" objects (Pipeline)
         if (m_GraphicsPipeline != VK_NULL_HANDLE) {
             vkDestroyPipeline(m_LogicalDevice, m_GraphicsPipeline, nullptr);
             m_GraphicsPipeline = VK_NULL_HANDLE;
@@ -533,31 +1627,39 @@ namespace RedPlasma {
             m_PipelineLayout = VK_NULL_HANDLE;
         }
 
-        for (auto framebuffer : m_Framebuffers) {
-            vkDestroyFramebuffer(m_LogicalDevice, framebuffer, nullptr);
+        // 3. Destroy "Level 2" objects (CommandPool, Sync, render graph transients)
+        // Runs the deferred destruction that is still queued, the device is idle so all of it is due.
+        m_GraphicsTimeline.Shutdown();
+        m_TransferTimeline.Shutdown();
+        m_ComputeTimeline.Shutdown();
+        m_GpuCulling.Shutdown();
+        m_RenderGraph.Shutdown();
+        DestroyFrameContexts();
+        for (auto& staging : m_PendingStaging) {
+            DestroyHostBuffer(staging);
         }
-        m_Framebuffers.clear();
-
-        // 3. Destroy "Level 2" objects (RenderPass, CommandPool, Sync)
-        if (m_RenderPass != VK_NULL_HANDLE) {
-            vkDestroyRenderPass(m_LogicalDevice, m_RenderPass, nullptr);
-            m_RenderPass = VK_NULL_HANDLE;
-        }
-        vkDestroySemaphore(m_LogicalDevice, m_ImageAvailableSemaphore, nullptr);
-        vkDestroySemaphore(m_LogicalDevice, m_RenderFinishedSemaphore, nullptr);
-        vkDestroyFence(m_LogicalDevice, m_InFlightFence, nullptr);
+        m_PendingStaging.clear();
+        m_PendingCopies.clear();
+        m_PendingImageCopies.clear();
+        m_Meshes.clear();
+        DestroyTextures();
+        DestroyDeviceBuffer(m_MaterialBuffer);
+        m_MaterialBufferIndex = VulkanBindlessHeap::InvalidIndex;
+        m_BindlessHeap.Shutdown();
+        DestroyHostBuffer(m_StagingBuffer);
+        DestroyDeviceBuffer(m_VertexBuffer);
+        DestroyDeviceBuffer(m_IndexBuffer);
 
         // 4. Destroy "Level 1" objects (Swapchain, ImageViews)
-        for (auto imageView : m_SwapChainImageViews) {
-            vkDestroyImageView(m_LogicalDevice, imageView, nullptr);
-        }
-        m_SwapChainImageViews.clear();
+        DestroySwapChainResources();
 
         if (m_SwapChain != VK_NULL_HANDLE) {
             vkDestroySwapchainKHR(m_LogicalDevice, m_SwapChain, nullptr);
             m_SwapChain = VK_NULL_HANDLE;
         }
 
+        m_MemoryAllocator.Shutdown();
+
         // 5. FINALLY destroy the Logical Device
         vkDestroyDevice(m_LogicalDevice, nullptr);
         m_LogicalDevice = VK_NULL_HANDLE;
@@ -578,58 +1680,517 @@ namespace RedPlasma {
 }
 
     int VulkanGraphicsDevice::UploadMeshData(const std::vector<Vertex> &vertices) {
+        std::vector<uint32_t> indices(vertices.size());
+        for (uint32_t i = 0; i < indices.size(); i++) {
+            indices[i] = i;
+        }
+        return UploadMeshData(vertices.data(), static_cast<uint32_t>(vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+    }
+
+    int VulkanGraphicsDevice::UploadMeshData(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) {
+        if (m_VertexBuffer.buffer == VK_NULL_HANDLE) {
+            return -1;
+        }
+        if (vertices == nullptr || indices == nullptr || vertexCount == 0 || indexCount == 0) {
+            return -2;
+        }
+
+        std::lock_guard<std::mutex> lock(m_UploadMutex);
+
+        VkDeviceSize vertexBytes = static_cast<VkDeviceSize>(vertexCount) * sizeof(Vertex);
+        VkDeviceSize indexBytes = static_cast<VkDeviceSize>(indexCount) * sizeof(uint32_t);
+        if (m_VertexBufferUsed + vertexBytes > m_VertexBuffer.size || m_IndexBufferUsed + indexBytes > m_IndexBuffer.size) {
+            std::cout << "Mesh buffers are full, increase meshVertexBufferBytes / meshIndexBufferBytes" << std::endl;
+            return -3;
+        }
+
+        int result;
+        if ((result = StageCopy(vertices, vertexBytes, m_VertexBuffer.buffer, m_VertexBufferUsed)) != 0 ||
+            (result = StageCopy(indices, indexBytes, m_IndexBuffer.buffer, m_IndexBufferUsed)) != 0) {
+            return result;
+        }
+
+        MeshRecord mesh;
+        mesh.firstIndex = static_cast<uint32_t>(m_IndexBufferUsed / sizeof(uint32_t));
+        mesh.indexCount = indexCount;
+        mesh.vertexOffset = static_cast<int32_t>(m_VertexBufferUsed / sizeof(Vertex));
+        mesh.vertexCount = vertexCount;
+
+        // Sphere around the box center, loose but cheap and stable under any transform.
+        float minimum[3] = { vertices[0].x, vertices[0].y, vertices[0].z };
+        float maximum[3] = { vertices[0].x, vertices[0].y, vertices[0].z };
+        for (uint32_t i = 1; i < vertexCount; i++) {
+            const float position[3] = { vertices[i].x, vertices[i].y, vertices[i].z };
+            for (int axis = 0; axis < 3; axis++) {
+                minimum[axis] = std::min(minimum[axis], position[axis]);
+                maximum[axis] = std::max(maximum[axis], position[axis]);
+            }
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            mesh.boundsCenter[axis] = (minimum[axis] + maximum[axis]) * 0.5f;
+        }
+        float radiusSquared = 0.0f;
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            float dx = vertices[i].x - mesh.boundsCenter[0];
+            float dy = vertices[i].y - mesh.boundsCenter[1];
+            float dz = vertices[i].z - mesh.boundsCenter[2];
+            radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+        }
+        mesh.boundsRadius = std::sqrt(radiusSquared);
+        m_Meshes.push_back(mesh);
+
+        m_VertexBufferUsed += vertexBytes;
+        m_IndexBufferUsed += indexBytes;
+        return static_cast<int>(m_Meshes.size());
+    }
+
+    // Caller holds m_UploadMutex. Returns nullptr when not even a dedicated staging buffer could be created.
+    void* VulkanGraphicsDevice::AllocateStaging(VkDeviceSize size, VkDeviceSize alignment, VkBuffer& outSource, VkDeviceSize& outOffset) {
+        void* target = m_StagingRing.Allocate(size, alignment, outOffset);
+        if (target != nullptr) {
+            outSource = m_StagingBuffer.buffer;
+            return target;
+        }
+
+        // Bigger than what the ring has free right now, give it a staging buffer of its own instead of stalling.
+        HostBuffer overflow;
+        if (CreateHostBuffer(overflow, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, false) != 0) {
+            DestroyHostBuffer(overflow);
+            return nullptr;
+        }
+        m_PendingStaging.push_back(overflow);
+        outSource = overflow.buffer;
+        outOffset = 0;
+        return overflow.mapped;
+    }
+
+    // Caller holds m_UploadMutex.
+    int VulkanGraphicsDevice::StageCopy(const void* data, VkDeviceSize size, VkBuffer destination, VkDeviceSize destinationOffset) {
+        PendingCopy copy;
+        copy.destination = destination;
+        copy.region.dstOffset = destinationOffset;
+        copy.region.size = size;
+
+        void* target = AllocateStaging(size, 16, copy.source, copy.region.srcOffset);
+        if (target == nullptr) {
+            return -4;
+        }
+        std::memcpy(target, data, size);
+        m_PendingCopies.push_back(copy);
         return 0;
     }
 
+    int VulkanGraphicsDevice::CreateTexture(const TextureDesc& desc) {
+        if (m_BindlessHeap.GetSet() == VK_NULL_HANDLE) {
+            return -1;
+        }
+        if (desc.pixels == nullptr || desc.width == 0 || desc.height == 0) {
+            return -2;
+        }
+
+        std::lock_guard<std::mutex> lock(m_UploadMutex);
+
+        TextureRecord texture;
+        VkImageCreateInfo imageInfo = {};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+        imageInfo.extent = { desc.width, desc.height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        if (vkCreateImage(m_LogicalDevice, &imageInfo, nullptr, &texture.image) != VK_SUCCESS) {
+            return -3;
+        }
+        if (m_MemoryAllocator.AllocateForImage(texture.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, texture.allocation) != 0) {
+            vkDestroyImage(m_LogicalDevice, texture.image, nullptr);
+            return -3;
+        }
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = texture.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = imageInfo.format;
+        viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        if (vkCreateImageView(m_LogicalDevice, &viewInfo, nullptr, &texture.view) != VK_SUCCESS) {
+            vkDestroyImage(m_LogicalDevice, texture.image, nullptr);
+            m_MemoryAllocator.Free(texture.allocation);
+            return -3;
+        }
+
+        // The slot is written now but only read once a material points at it, which is after the copy below.
+        texture.bindlessIndex = m_BindlessHeap.AddTexture(texture.view);
+        PendingImageCopy copy;
+        copy.image = texture.image;
+        copy.region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        copy.region.imageExtent = { desc.width, desc.height, 1 };
+        VkDeviceSize size = static_cast<VkDeviceSize>(desc.width) * desc.height * 4;
+        void* target = texture.bindlessIndex != VulkanBindlessHeap::InvalidIndex
+                       ? AllocateStaging(size, 16, copy.source, copy.region.bufferOffset) : nullptr;
+        if (target == nullptr) {
+            if (texture.bindlessIndex != VulkanBindlessHeap::InvalidIndex) {
+                m_BindlessHeap.ReleaseTexture(texture.bindlessIndex);
+            }
+            vkDestroyImageView(m_LogicalDevice, texture.view, nullptr);
+            vkDestroyImage(m_LogicalDevice, texture.image, nullptr);
+            m_MemoryAllocator.Free(texture.allocation);
+            return -4;
+        }
+
+        std::memcpy(target, desc.pixels, size);
+        m_PendingImageCopies.push_back(copy);
+        m_Textures.push_back(texture);
+        return static_cast<int>(m_Textures.size() - 1);
+    }
+
+    void VulkanGraphicsDevice::DestroyTextures() {
+        for (auto& texture : m_Textures) {
+            vkDestroyImageView(m_LogicalDevice, texture.view, nullptr);
+            vkDestroyImage(m_LogicalDevice, texture.image, nullptr);
+            m_MemoryAllocator.Free(texture.allocation);
+            m_BindlessHeap.ReleaseTexture(texture.bindlessIndex);
+        }
+        m_Textures.clear();
+    }
+
+    int VulkanGraphicsDevice::CreateMaterial(const MaterialDesc& desc) {
+        std::lock_guard<std::mutex> lock(m_UploadMutex);
+        if (m_Materials.size() > DrawKey::MaxMaterial) {
+            return -1;
+        }
+        if (desc.texture < 0 || static_cast<size_t>(desc.texture) >= m_Textures.size()) {
+            return -2;
+        }
+
+        // Lands in the material buffer with the next frame's uploads, before any draw can reference the handle.
+        GpuMaterial material = {};
+        std::memcpy(material.color, desc.color, sizeof(material.color));
+        material.texture = m_Textures[desc.texture].bindlessIndex;
+        if (StageCopy(&material, sizeof(material), m_MaterialBuffer.buffer, m_Materials.size() * sizeof(GpuMaterial)) != 0) {
+            return -3;
+        }
+        m_Materials.push_back(desc);
+        m_MaterialCount.store(static_cast<uint32_t>(m_Materials.size()), std::memory_order_release);
+        return static_cast<int>(m_Materials.size() - 1);
+    }
+
+    void VulkanGraphicsDevice::SetViewProjection(const float viewProjection[16]) {
+        if (std::memcmp(m_ViewProjection, viewProjection, sizeof(m_ViewProjection)) != 0) {
+            std::memcpy(m_ViewProjection, viewProjection, sizeof(m_ViewProjection));
+            m_DrawStateVersion++;
+        }
+    }
+
+    int VulkanGraphicsDevice::SubmitDraw(int mesh, int material, const float transform[16]) {
+        if (mesh <= 0 || static_cast<uint32_t>(mesh) > DrawKey::MaxMesh) {
+            return -1;
+        }
+        if (material < 0 || static_cast<uint32_t>(material) >= m_MaterialCount.load(std::memory_order_acquire)) {
+            return -2;
+        }
+
+        // Normalized depth of the object origin, opaque draws of one batch go front to back.
+        const float* m = m_ViewProjection;
+        float x = transform[12], y = transform[13], z = transform[14];
+        float clipZ = m[2] * x + m[6] * y + m[10] * z + m[14];
+        float clipW = m[3] * x + m[7] * y + m[11] * z + m[15];
+        float depth = clipW > 0.0f ? clipZ / clipW : 0.0f;
+
+        if (m_DrawListConsumed) {
+            m_DrawList.Clear();
+            m_DrawListConsumed = false;
+        }
+        m_DrawList.Add(DrawKey::Pack(0, 0, static_cast<uint32_t>(material), static_cast<uint32_t>(mesh), depth), transform);
+        m_DrawListVersion++;
+        return 0;
+    }
+
+    int VulkanGraphicsDevice::ReuseLastDrawList() {
+        if (!m_DrawListConsumed) {
+            // Either no frame was drawn yet or this one already has draws of its own.
+            return -1;
+        }
+        m_DrawListConsumed = false;
+        m_DrawListReused = true;
+        return 0;
+    }
+
+    PendingDrawList VulkanGraphicsDevice::GetPendingDrawList() const {
+        if (m_DrawListConsumed || m_DrawList.IsEmpty()) {
+            return PendingDrawList::None;
+        }
+        return m_DrawListReused ? PendingDrawList::Reused : PendingDrawList::Submitted;
+    }
+
     int VulkanGraphicsDevice::DrawFrame() {
-        vkWaitForFences(m_LogicalDevice, 1, &m_InFlightFence, VK_TRUE, UINT64_MAX);
-        vkResetFences(m_LogicalDevice, 1, &m_InFlightFence);
+        if (m_SwapChainDirty && RecreateSwapChain() != 0) {
+            // Nothing to present into right now (e.g. minimized), try again next frame.
+            return 0;
+        }
+
+        FrameContext& frame = m_Frames[m_CurrentFrame];
+        FrameClock::time_point frameStart = FrameClock::now();
+
+        // Only wait for the frame that last used this context, the others keep running on the GPU.
+        if (!m_GraphicsTimeline.Wait(frame.timelineValue)) {
+            return -24;
+        }
+        m_FramePool.Reset(m_CurrentFrame);
+        {
+            std::lock_guard<std::mutex> lock(m_UploadMutex);
+            m_StagingRing.OnFrameRetired(m_CurrentFrame);
+        }
+        m_GraphicsTimeline.Collect();
+
+        // The other contexts may have finished as well, the counter read above covers all of them.
+        uint64_t completedFrame = frame.frameNumber;
+        for (const auto& other : m_Frames) {
+            if (other.frameNumber > completedFrame && m_GraphicsTimeline.IsComplete(other.timelineValue)) {
+                completedFrame = other.frameNumber;
+            }
+        }
+        if (completedFrame > m_CompletedFrameNumber) {
+            m_CompletedFrameNumber = completedFrame;
+        }
 
         uint32_t imageIndex;
-        vkAcquireNextImageKHR(m_LogicalDevice, m_SwapChain, UINT64_MAX, m_ImageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+        VkResult acquireResult = vkAcquireNextImageKHR(m_LogicalDevice, m_SwapChain, UINT64_MAX, frame.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+        if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+            // Nothing was submitted and the semaphore is untouched, so the frame can simply be skipped.
+            m_SwapChainDirty = true;
+            return 0;
+        }
+        if (acquireResult == VK_SUBOPTIMAL_KHR) {
+            m_SwapChainDirty = true;
+        } else if (acquireResult != VK_SUCCESS) {
+            return -18;
+        }
 
-        vkResetCommandBuffer(m_CommandBuffers[imageIndex], 0);
-        RecordCommandBuffer(m_CommandBuffers[imageIndex], imageIndex);
+        if (m_ReadbackSupported &&
+            (frame.readback.width != m_SwapChainExtent.width || frame.readback.height != m_SwapChainExtent.height)) {
+            // Safe to replace, the fence above guarantees the previous copy into it has finished.
+            DestroyHostBuffer(frame.readback.host);
+            VkDeviceSize size = static_cast<VkDeviceSize>(m_SwapChainExtent.width) * m_SwapChainExtent.height * 4;
+            if (CreateHostBuffer(frame.readback.host, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, true) != 0) {
+                return -20;
+            }
+            frame.readback.width = m_SwapChainExtent.width;
+            frame.readback.height = m_SwapChainExtent.height;
+        }
 
-        VkSubmitInfo submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        FrameClock::time_point recordStart = FrameClock::now();
 
-        VkSemaphore waitSemaphores[] = { m_ImageAvailableSemaphore };
-        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores;
-        submitInfo.pWaitDstStageMask = waitStages;
+        vkResetCommandPool(m_LogicalDevice, frame.commandPool, 0);
+        for (auto& threadPool : frame.threadPools) {
+            vkResetCommandPool(m_LogicalDevice, threadPool.pool, 0);
+            threadPool.used = 0;
+        }
+        int recordResult = RecordCommandBuffer(frame.commandBuffer, imageIndex);
+        // A graph that failed to compile still leaves the frame's uploads in the command buffer, nothing else does.
+        bool submitCommands = recordResult == 0 || recordResult == -23;
+        FrameClock::time_point submitStart = FrameClock::now();
+
+        if (frame.uploadPending) {
+            VkCommandBufferSubmitInfo transferBuffer = {};
+            transferBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+            transferBuffer.commandBuffer = frame.transferCommandBuffer;
+
+            frame.uploadValue = m_TransferTimeline.Advance();
+            VkSemaphoreSubmitInfo uploadSignal = {};
+            uploadSignal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            uploadSignal.semaphore = m_TransferTimeline.GetSemaphore();
+            uploadSignal.value = frame.uploadValue;
+            uploadSignal.stageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+
+            VkSubmitInfo2 transferSubmit = {};
+            transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+            transferSubmit.commandBufferInfoCount = 1;
+            transferSubmit.pCommandBufferInfos = &transferBuffer;
+            transferSubmit.signalSemaphoreInfoCount = 1;
+            transferSubmit.pSignalSemaphoreInfos = &uploadSignal;
+            if (vkQueueSubmit2(m_TransferQueue, 1, &transferSubmit, VK_NULL_HANDLE) != VK_SUCCESS) {
+                return -16;
+            }
+        }
 
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &m_CommandBuffers[imageIndex];
+        if (frame.cullPending) {
+            VkCommandBufferSubmitInfo computeBuffer = {};
+            computeBuffer.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+            computeBuffer.commandBuffer = frame.computeCommandBuffer;
+
+            frame.cullValue = m_ComputeTimeline.Advance();
+            VkSemaphoreSubmitInfo cullSignal = {};
+            cullSignal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            cullSignal.semaphore = m_ComputeTimeline.GetSemaphore();
+            cullSignal.value = frame.cullValue;
+            cullSignal.stageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+
+            VkSubmitInfo2 computeSubmit = {};
+            computeSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+            computeSubmit.commandBufferInfoCount = 1;
+            computeSubmit.pCommandBufferInfos = &computeBuffer;
+            computeSubmit.signalSemaphoreInfoCount = 1;
+            computeSubmit.pSignalSemaphoreInfos = &cullSignal;
+            if (vkQueueSubmit2(m_ComputeQueue, 1, &computeSubmit, VK_NULL_HANDLE) != VK_SUCCESS) {
+                return -16;
+            }
+        }
 
-        VkSemaphore signalSemaphores[] = { m_RenderFinishedSemaphore };
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = signalSemaphores;
+        VkSemaphoreSubmitInfo waitInfos[3] = {};
+        uint32_t waitCount = 0;
+        waitInfos[waitCount].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        waitInfos[waitCount].semaphore = frame.imageAvailableSemaphore;
+        waitInfos[waitCount++].stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        // The acquire barriers for the uploaded ranges and the cull output sit ahead of the passes that use them.
+        if (frame.uploadPending) {
+            waitInfos[waitCount].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            waitInfos[waitCount].semaphore = m_TransferTimeline.GetSemaphore();
+            waitInfos[waitCount].value = frame.uploadValue;
+            waitInfos[waitCount++].stageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        }
+        if (frame.cullPending) {
+            waitInfos[waitCount].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            waitInfos[waitCount].semaphore = m_ComputeTimeline.GetSemaphore();
+            waitInfos[waitCount].value = frame.cullValue;
+            waitInfos[waitCount++].stageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        }
 
-        if (vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, m_InFlightFence) != VK_SUCCESS) {
+        VkCommandBufferSubmitInfo commandBufferInfo = {};
+        commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+        commandBufferInfo.commandBuffer = frame.commandBuffer;
+
+        uint64_t timelineValue = m_GraphicsTimeline.Advance();
+        VkSemaphoreSubmitInfo signalInfos[2] = {};
+        signalInfos[0].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signalInfos[0].semaphore = m_RenderFinishedSemaphores[imageIndex];
+        signalInfos[0].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        signalInfos[1].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signalInfos[1].semaphore = m_GraphicsTimeline.GetSemaphore();
+        signalInfos[1].value = timelineValue;
+        signalInfos[1].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+        VkSubmitInfo2 submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        submitInfo.waitSemaphoreInfoCount = waitCount;
+        submitInfo.pWaitSemaphoreInfos = waitInfos;
+        submitInfo.commandBufferInfoCount = submitCommands ? 1 : 0;
+        submitInfo.pCommandBufferInfos = &commandBufferInfo;
+        // A frame that failed to record is never presented, so it only signals the timeline.
+        submitInfo.signalSemaphoreInfoCount = recordResult == 0 ? 2 : 1;
+        submitInfo.pSignalSemaphoreInfos = recordResult == 0 ? signalInfos : &signalInfos[1];
+
+        if (vkQueueSubmit2(m_GraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
             return -16;
         }
+        frame.timelineValue = timelineValue;
+        if (recordResult != 0) {
+            // The submit above still consumed the acquire semaphore and retires the context as usual. The acquired
+            // image was never rendered to, recreating the swapchain hands it back without presenting it.
+            std::cout << "Failed to record the frame (" << recordResult << "), skipping present" << std::endl;
+            m_SwapChainDirty = true;
+            return recordResult;
+        }
+        m_LastSubmittedFrame = static_cast<int>(m_CurrentFrame);
+        frame.frameNumber = m_FrameStats.frameNumber + 1;
 
         VkPresentInfoKHR presentInfo = {};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
         presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = signalSemaphores;
+        presentInfo.pWaitSemaphores = &m_RenderFinishedSemaphores[imageIndex];
 
         VkSwapchainKHR swapChains[] = { m_SwapChain };
         presentInfo.swapchainCount = 1;
         presentInfo.pSwapchains = swapChains;
         presentInfo.pImageIndices = &imageIndex;
 
-        vkQueuePresentKHR(m_PresentQueue, &presentInfo);
+        VkResult presentResult = vkQueuePresentKHR(m_PresentQueue, &presentInfo);
+        if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
+            m_SwapChainDirty = true;
+        } else if (presentResult != VK_SUCCESS) {
+            return -19;
+        }
+
+        FrameClock::time_point frameEnd = FrameClock::now();
+        m_FrameStats.waitMs = ElapsedMs(frameStart, recordStart);
+        m_FrameStats.recordMs = ElapsedMs(recordStart, submitStart);
+        m_FrameStats.submitMs = ElapsedMs(submitStart, frameEnd);
+        m_FrameStats.totalMs = ElapsedMs(frameStart, frameEnd);
+        m_FrameStats.frameNumber++;
 
+        m_CurrentFrame = (m_CurrentFrame + 1) % static_cast<uint32_t>(m_Frames.size());
         return 0;
     }
 
+    int VulkanGraphicsDevice::ReadbackFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) {
+        if (!m_ReadbackSupported) {
+            return -1;
+        }
+        if (m_LastSubmittedFrame < 0) {
+            return -2;
+        }
+
+        FrameContext& frame = m_Frames[m_LastSubmittedFrame];
+        if (!m_GraphicsTimeline.Wait(frame.timelineValue)) {
+            return -3;
+        }
+
+        width = frame.readback.width;
+        height = frame.readback.height;
+        size_t pixelCount = static_cast<size_t>(width) * height;
+        pixels.resize(pixelCount * 4);
+
+        const auto* source = static_cast<const uint8_t*>(frame.readback.host.mapped);
+        bool isBgra = m_SwapChainImageFormat == VK_FORMAT_B8G8R8A8_SRGB || m_SwapChainImageFormat == VK_FORMAT_B8G8R8A8_UNORM;
+        if (!isBgra) {
+            std::copy(source, source + pixels.size(), pixels.begin());
+            return 0;
+        }
+
+        for (size_t i = 0; i < pixelCount; i++) {
+            pixels[i * 4 + 0] = source[i * 4 + 2];
+            pixels[i * 4 + 1] = source[i * 4 + 1];
+            pixels[i * 4 + 2] = source[i * 4 + 0];
+            pixels[i * 4 + 3] = source[i * 4 + 3];
+        }
+        return 0;
+    }
+
+    void VulkanGraphicsDevice::OnSurfaceResized() {
+        m_SwapChainDirty = true;
+    }
+
+    void VulkanGraphicsDevice::SetPresentMode(PresentMode mode) {
+        if (m_Settings.presentMode != mode) {
+            m_Settings.presentMode = mode;
+            m_SwapChainDirty = true;
+        }
+    }
+
     const char * VulkanGraphicsDevice::GetDeviceName() {
         return m_DeviceName;
     }
 
+    const FrameStats& VulkanGraphicsDevice::GetFrameStats() const {
+        return m_FrameStats;
+    }
+
+    const std::vector<GpuZoneTiming>& VulkanGraphicsDevice::GetGpuTimings() const {
+        return m_GpuProfiler.GetResults();
+    }
+
+    GpuMemoryStats VulkanGraphicsDevice::GetMemoryStats() const {
+        return m_MemoryAllocator.GetStats();
+    }
+
+    uint64_t VulkanGraphicsDevice::GetCompletedFrameNumber() const {
+        return m_CompletedFrameNumber;
+    }
+
     int VulkanGraphicsDevice::CreateSurface(IWindowSurface* windowHandle) {
         m_Surface = windowHandle->CreateSurface(m_Instance);
 
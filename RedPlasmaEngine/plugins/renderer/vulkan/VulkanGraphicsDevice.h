@@ -13,10 +13,120 @@
 
 #ifndef REDPLASMA_VULKANGRAPHICSDEVICE_H
 #define REDPLASMA_VULKANGRAPHICSDEVICE_H
+#include "renderer/DrawList.h"
 #include "renderer/IGraphicsDevice.h"
+#include "VulkanBindlessHeap.h"
+#include "VulkanGpuCulling.h"
+#include "VulkanGpuProfiler.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanStagingRing.h"
+#include "VulkanTimeline.h"
+#include <atomic>
+#include <mutex>
 #include <vulkan/vulkan.h>
 
 namespace RedPlasma {
+    // Host visible buffer that stays mapped for its whole lifetime.
+    struct HostBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        MemoryAllocation allocation;
+        void* mapped = nullptr;
+        VkDeviceSize size = 0;
+    };
+
+    struct DeviceBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        MemoryAllocation allocation;
+        VkDeviceSize size = 0;
+    };
+
+    // Location of a mesh inside the shared vertex and index buffers.
+    struct MeshRecord {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        int32_t vertexOffset = 0;
+        uint32_t vertexCount = 0;
+        // Mesh space bounding sphere, used by the GPU culling.
+        float boundsCenter[3] = {};
+        float boundsRadius = 0.0f;
+    };
+
+    struct PendingCopy {
+        VkBuffer source = VK_NULL_HANDLE;
+        VkBuffer destination = VK_NULL_HANDLE;
+        VkBufferCopy region = {};
+    };
+
+    struct PendingImageCopy {
+        VkBuffer source = VK_NULL_HANDLE;
+        VkImage image = VK_NULL_HANDLE;
+        VkBufferImageCopy region = {};
+    };
+
+    // Sampled image registered in the bindless heap, shaders refer to it by bindlessIndex.
+    struct TextureRecord {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        MemoryAllocation allocation;
+        uint32_t bindlessIndex = VulkanBindlessHeap::InvalidIndex;
+    };
+
+    // Destination of the swapchain image copy when readback is enabled.
+    struct ReadbackTarget {
+        HostBuffer host;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // Command pool used by exactly one job system thread within a frame context, so secondaries record without locks.
+    struct ThreadCommandPool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> secondaries;
+        uint32_t used = 0;
+    };
+
+    // Everything a single frame needs while it is being recorded or executed on the GPU.
+    struct FrameContext {
+        // Graphics timeline value signalled by the last submission from this context.
+        uint64_t timelineValue = 0;
+        VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        // Only created when uploads run on a dedicated transfer queue.
+        VkCommandPool transferCommandPool = VK_NULL_HANDLE;
+        VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
+        // Transfer timeline value the graphics submit of this frame waits on, when uploadPending is set.
+        uint64_t uploadValue = 0;
+        bool uploadPending = false;
+        // Only created when the cull passes run on a dedicated compute queue.
+        VkCommandPool computeCommandPool = VK_NULL_HANDLE;
+        VkCommandBuffer computeCommandBuffer = VK_NULL_HANDLE;
+        // Compute timeline value the graphics submit of this frame waits on, when cullPending is set.
+        uint64_t cullValue = 0;
+        bool cullPending = false;
+        // Indexed by JobSystem::GetCurrentThreadIndex(), which no two threads share, so a pool is only ever
+        // recorded from by one thread at a time.
+        std::vector<ThreadCommandPool> threadPools;
+        // FrameStats::frameNumber of the last submission from this context.
+        uint64_t frameNumber = 0;
+        ReadbackTarget readback;
+        // Instance data of the sorted draw list, taken from the frame upload space.
+        LinearAllocation instances;
+        // Draw list version the instance data and the GPU culling input of this context were written for. The
+        // culling input also depends on the mesh table for the batch bounds, so it keeps the state version too.
+        uint64_t instancesVersion = 0;
+        uint64_t cullInputVersion = 0;
+        uint64_t cullStateVersion = 0;
+        // Scene draws recorded once and replayed while the draw list and draw state versions stay the same.
+        // The pool is never reset with the frame, only when the draws are recorded again.
+        VkCommandPool cachePool = VK_NULL_HANDLE;
+        VkCommandBuffer cachedDraws = VK_NULL_HANDLE;
+        uint64_t cachedListVersion = 0;
+        uint64_t cachedStateVersion = 0;
+    };
+
     class VulkanGraphicsDevice : public IGraphicsDevice {
         public:
         VulkanGraphicsDevice();
@@ -24,31 +134,86 @@ namespace RedPlasma {
 
         int Initialize() override;
         int Shutdown() override;
+        void Configure(const GraphicsDeviceSettings& settings) override;
+        void SetJobSystem(JobSystem* jobSystem) override;
+        void OnSurfaceResized() override;
+        void SetPresentMode(PresentMode mode) override;
         int UploadMeshData(const std::vector<Vertex>& vertices) override;
+        int UploadMeshData(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) override;
+        int CreateTexture(const TextureDesc& desc) override;
+        int CreateMaterial(const MaterialDesc& desc) override;
+        void SetViewProjection(const float viewProjection[16]) override;
+        int SubmitDraw(int mesh, int material, const float transform[16]) override;
+        int ReuseLastDrawList() override;
+        [[nodiscard]] PendingDrawList GetPendingDrawList() const override;
         int DrawFrame() override;
+        int ReadbackFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) override;
         const char* GetDeviceName() override;
+        [[nodiscard]] const FrameStats& GetFrameStats() const override;
+        [[nodiscard]] const std::vector<GpuZoneTiming>& GetGpuTimings() const override;
+        [[nodiscard]] GpuMemoryStats GetMemoryStats() const override;
+        [[nodiscard]] uint64_t GetCompletedFrameNumber() const override;
 
         int CreateSurface(IWindowSurface* windowHandle) override;
         void AddExtension(const std::vector<const char*> &extensions) override;
         int InitializeDevice(IWindowSurface* surface);
         int SetupSwapChain(IWindowSurface* surface);
+        int RecreateSwapChain();
         int CreateImageViews();
-        int CreateRenderPass();
         int CreateGraphicsPipeline();
-        int CreateFramebuffers();
         int CreateCommandPool();
         int CreateSyncObjects();
+        int CreateRenderFinishedSemaphores();
+        int CreateHostBuffer(HostBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage, bool preferCached);
+        void DestroyHostBuffer(HostBuffer& buffer);
+        int CreateDeviceBuffer(DeviceBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage);
+        void DestroyDeviceBuffer(DeviceBuffer& buffer);
+        int CreateMeshBuffers();
+        int CreateMaterialResources();
+        int AllocateFrameUpload(VkDeviceSize size, VkDeviceSize alignment, LinearAllocation& outAllocation);
         int RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
-        void WaitIdle();
+        int UploadDrawInstances(FrameContext& frame);
+        int UploadCullInput(FrameContext& frame);
+        int BeginDrawSecondary(VkCommandBuffer secondary, VkCommandBufferUsageFlags flags);
+        int RecordCachedDraws(FrameContext& frame, bool gpuCulling, uint32_t drawCount);
+        void BindDrawState(VkCommandBuffer commandBuffer, VkBuffer instanceBuffer, VkDeviceSize instanceOffset);
+        void RecordGpuCulledDraws(VkCommandBuffer commandBuffer);
+        void RecordDrawRange(VkCommandBuffer commandBuffer, const LinearAllocation& instances, uint32_t firstBatch, uint32_t lastBatch);
+        // Slot of the calling thread in the per thread pools and record timings.
+        [[nodiscard]] uint32_t GetRecordThreadIndex() const;
+        void RecordDrawsParallel(FrameContext& frame, std::vector<VkCommandBuffer>& outSecondaries);
+        VkCommandBuffer AcquireSecondaryCommandBuffer(ThreadCommandPool& threadPool);
+        void TakePendingUploads(std::vector<PendingCopy>& outCopies, std::vector<PendingImageCopy>& outImageCopies);
+        void RecordPendingUploads(VkCommandBuffer commandBuffer, const std::vector<PendingCopy>& copies);
+        int RecordTransferUploads(FrameContext& frame, const std::vector<PendingCopy>& copies);
+        void RecordUploadOwnership(VkCommandBuffer commandBuffer, const std::vector<PendingCopy>& copies, bool release);
+        int RecordComputeCulling(FrameContext& frame);
+        void RecordCullOwnership(VkCommandBuffer commandBuffer, bool release);
+        void RecordTextureUploads(VkCommandBuffer commandBuffer, const std::vector<PendingImageCopy>& copies);
+        void RecordReadback(VkCommandBuffer commandBuffer, uint32_t imageIndex, const ReadbackTarget& target);
+        void WaitIdle() override;
 
     private:
+        int FindQueueFamilies(VkSurfaceKHR surface);
+        void DestroyFrameContexts();
+        void DestroySwapChainResources();
+        void* AllocateStaging(VkDeviceSize size, VkDeviceSize alignment, VkBuffer& outSource, VkDeviceSize& outOffset);
+        int StageCopy(const void* data, VkDeviceSize size, VkBuffer destination, VkDeviceSize destinationOffset);
+        void DestroyTextures();
+        VkPresentModeKHR ChoosePresentMode(VkSurfaceKHR surface) const;
+        VkFormat ChooseDepthFormat() const;
+
+        GraphicsDeviceSettings m_Settings;
         VkInstance m_Instance = VK_NULL_HANDLE;
         VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
         VkDevice m_LogicalDevice = VK_NULL_HANDLE;
         VkQueue m_GraphicsQueue = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties m_DeviceProperties = {};
         const char* m_DeviceName = "Vulkan Backend";
         VkQueue m_PresentQueue = VK_NULL_HANDLE;
         VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
+        IWindowSurface* m_WindowSurface = nullptr;
+        bool m_SwapChainDirty = false;
         std::vector<const char*> m_EnableExtension;
         int m_graphicsFamilyIndex = 0;
         VkSwapchainKHR m_SwapChain = VK_NULL_HANDLE;
@@ -56,17 +221,84 @@ namespace RedPlasma {
         VkFormat m_SwapChainImageFormat;
         VkExtent2D m_SwapChainExtent;
         std::vector<VkImageView> m_SwapChainImageViews;
-        VkRenderPass m_RenderPass = VK_NULL_HANDLE;
+        VkFormat m_DepthFormat = VK_FORMAT_UNDEFINED;
         VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
         VkPipeline m_GraphicsPipeline = VK_NULL_HANDLE;
-        std::vector<VkFramebuffer> m_Framebuffers;
         int m_PresentFamilyIndex = -1;
-        VkCommandPool m_CommandPool = VK_NULL_HANDLE;
-        std::vector<VkCommandBuffer> m_CommandBuffers;
+        // -1 and a null queue when the device has no separate family, the work then stays on the graphics queue.
+        int m_TransferFamilyIndex = -1;
+        int m_ComputeFamilyIndex = -1;
+        VkQueue m_TransferQueue = VK_NULL_HANDLE;
+        VkQueue m_ComputeQueue = VK_NULL_HANDLE;
+        // Every graphics submission signals the next value, resource retirement and deferred destruction key off it.
+        VulkanTimeline m_GraphicsTimeline;
+        // Signalled by upload submissions on the transfer queue, only initialized when that queue exists.
+        VulkanTimeline m_TransferTimeline;
+        // Signalled by the cull submissions on the compute queue, only initialized when that queue exists.
+        VulkanTimeline m_ComputeTimeline;
+
+        std::vector<FrameContext> m_Frames;
+        uint32_t m_CurrentFrame = 0;
+        // Transient upload space of every frame context, indexed by m_CurrentFrame and reset when the frame retires.
+        VulkanLinearPool m_FramePool;
+        int m_LastSubmittedFrame = -1;
+        FrameStats m_FrameStats;
+        std::atomic<uint64_t> m_CompletedFrameNumber{0};
+        JobSystem* m_JobSystem = nullptr;
+        // Written by each recording thread into its own slot, copied into m_FrameStats after the frame.
+        std::vector<double> m_RecordThreadMs;
 
-        VkSemaphore m_ImageAvailableSemaphore;
-        VkSemaphore m_RenderFinishedSemaphore;
-        VkFence m_InFlightFence = VK_NULL_HANDLE;
+        // Guards everything UploadMeshData touches, uploads may come from other threads than DrawFrame.
+        std::mutex m_UploadMutex;
+        HostBuffer m_StagingBuffer;
+        VulkanStagingRing m_StagingRing;
+        std::vector<PendingCopy> m_PendingCopies;
+        std::vector<PendingImageCopy> m_PendingImageCopies;
+        std::vector<HostBuffer> m_PendingStaging;
+        DeviceBuffer m_VertexBuffer;
+        DeviceBuffer m_IndexBuffer;
+        VkDeviceSize m_VertexBufferUsed = 0;
+        VkDeviceSize m_IndexBufferUsed = 0;
+        std::vector<MeshRecord> m_Meshes;
+        std::vector<MeshRecord> m_DrawMeshes;
+        // Texture handle 0 is the built-in white texture.
+        std::vector<TextureRecord> m_Textures;
+        // Filled by SubmitDraw, sorted and consumed by the next frame.
+        DrawList m_DrawList;
+        // Bumped whenever the draw list changes. The state version covers everything else recorded draws
+        // depend on: view projection, pipeline, swapchain and the mesh table.
+        uint64_t m_DrawListVersion = 1;
+        uint64_t m_DrawStateVersion = 1;
+        uint64_t m_BuiltDrawListVersion = 0;
+        // Versions the last frame was recorded with, draws are only cached once they repeat.
+        uint64_t m_LastDrawListVersion = 0;
+        uint64_t m_LastDrawStateVersion = 0;
+        // Set once a frame consumed the list. The next SubmitDraw starts a new list, ReuseLastDrawList keeps it.
+        bool m_DrawListConsumed = false;
+        // The pending list is the previous frame's, kept by ReuseLastDrawList.
+        bool m_DrawListReused = false;
+        std::vector<MaterialDesc> m_Materials;
+        // Size of m_Materials, published after the push_back so SubmitDraw can check handles without the upload lock.
+        std::atomic<uint32_t> m_MaterialCount{0};
+        // GPU copy of m_Materials, one GpuMaterial per handle, read by the shaders through the bindless heap.
+        DeviceBuffer m_MaterialBuffer;
+        uint32_t m_MaterialBufferIndex = VulkanBindlessHeap::InvalidIndex;
+        VulkanBindlessHeap m_BindlessHeap;
+        float m_ViewProjection[16] = {
+            1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+        VulkanGpuProfiler m_GpuProfiler;
+        VulkanGpuCulling m_GpuCulling;
+        bool m_GpuCullingSupported = false;
+        VulkanMemoryAllocator m_MemoryAllocator;
+        VulkanPipelineCache m_PipelineCache;
+        VulkanRenderGraph m_RenderGraph;
+        bool m_ReadbackSupported = false;
+        // One per swapchain image, so a semaphore is never re-signalled while its present is still pending.
+        std::vector<VkSemaphore> m_RenderFinishedSemaphores;
     };
 } // RedPlasma
 
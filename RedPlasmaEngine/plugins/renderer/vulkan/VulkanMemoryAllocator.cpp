@@ -0,0 +1,409 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+
+#include "VulkanMemoryAllocator.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace RedPlasma {
+    namespace {
+        constexpr VkDeviceSize MinBlockSize = 256;
+        constexpr VkDeviceSize MaxBlockSize = 64ull * 1024 * 1024;
+        constexpr VkDeviceSize MinPoolBlockSize = 4ull * 1024 * 1024;
+        // Start of every linear pool region, no offset alignment limit in the spec goes above it.
+        constexpr VkDeviceSize LinearRegionAlignment = 256;
+
+        VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    void BuddyAllocator::Initialize(VkDeviceSize size, VkDeviceSize minBlockSize) {
+        m_Size = size;
+        m_MinBlockSize = minBlockSize;
+        m_AllocatedBytes = 0;
+        m_MaxOrder = 0;
+        while ((m_MinBlockSize << m_MaxOrder) < m_Size) {
+            m_MaxOrder++;
+        }
+
+        m_FreeLists.assign(m_MaxOrder + 1, {});
+        m_FreeLists[m_MaxOrder].insert(0);
+        m_AllocatedOrders.clear();
+    }
+
+    uint32_t BuddyAllocator::OrderForSize(VkDeviceSize size) const {
+        uint32_t order = 0;
+        while ((m_MinBlockSize << order) < size) {
+            order++;
+        }
+        return order;
+    }
+
+    bool BuddyAllocator::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset, VkDeviceSize& outBlockSize) {
+        uint32_t order = OrderForSize(std::max(size, alignment));
+        if (order > m_MaxOrder) {
+            return false;
+        }
+
+        uint32_t freeOrder = order;
+        while (freeOrder <= m_MaxOrder && m_FreeLists[freeOrder].empty()) {
+            freeOrder++;
+        }
+        if (freeOrder > m_MaxOrder) {
+            return false;
+        }
+
+        // Lowest offset first keeps allocations packed towards the start of the block.
+        VkDeviceSize offset = *m_FreeLists[freeOrder].begin();
+        m_FreeLists[freeOrder].erase(m_FreeLists[freeOrder].begin());
+        while (freeOrder > order) {
+            freeOrder--;
+            m_FreeLists[freeOrder].insert(offset + (m_MinBlockSize << freeOrder));
+        }
+
+        m_AllocatedOrders[offset] = order;
+        m_AllocatedBytes += m_MinBlockSize << order;
+        outOffset = offset;
+        outBlockSize = m_MinBlockSize << order;
+        return true;
+    }
+
+    void BuddyAllocator::Free(VkDeviceSize offset) {
+        auto it = m_AllocatedOrders.find(offset);
+        if (it == m_AllocatedOrders.end()) {
+            return;
+        }
+
+        uint32_t order = it->second;
+        m_AllocatedOrders.erase(it);
+        m_AllocatedBytes -= m_MinBlockSize << order;
+
+        while (order < m_MaxOrder) {
+            VkDeviceSize buddy = offset ^ (m_MinBlockSize << order);
+            auto buddyIt = m_FreeLists[order].find(buddy);
+            if (buddyIt == m_FreeLists[order].end()) {
+                break;
+            }
+            m_FreeLists[order].erase(buddyIt);
+            offset = std::min(offset, buddy);
+            order++;
+        }
+        m_FreeLists[order].insert(offset);
+    }
+
+    VkDeviceSize BuddyAllocator::GetLargestFreeBlock() const {
+        for (uint32_t order = m_MaxOrder + 1; order > 0; order--) {
+            if (!m_FreeLists[order - 1].empty()) {
+                return m_MinBlockSize << (order - 1);
+            }
+        }
+        return 0;
+    }
+
+    void VulkanMemoryAllocator::Initialize(VkPhysicalDevice physicalDevice, VkDevice device) {
+        m_Device = device;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_MemoryProperties);
+
+        m_Pools.clear();
+        m_Pools.resize(m_MemoryProperties.memoryTypeCount * 2);
+        for (uint32_t type = 0; type < m_MemoryProperties.memoryTypeCount; type++) {
+            // Small heaps (e.g. the 256 MiB BAR window) get smaller blocks so one block never eats most of the heap.
+            VkDeviceSize heapSize = m_MemoryProperties.memoryHeaps[m_MemoryProperties.memoryTypes[type].heapIndex].size;
+            VkDeviceSize blockSize = MaxBlockSize;
+            while (blockSize > MinPoolBlockSize && blockSize > heapSize / 8) {
+                blockSize /= 2;
+            }
+            m_Pools[type * 2].blockSize = blockSize;
+            m_Pools[type * 2 + 1].blockSize = blockSize;
+        }
+
+        m_AllocationCount = 0;
+        m_DedicatedCount = 0;
+        m_DedicatedBytes = 0;
+    }
+
+    void VulkanMemoryAllocator::Shutdown() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_AllocationCount != 0) {
+            std::cout << "Memory allocator shut down with " << m_AllocationCount << " live allocations" << std::endl;
+        }
+
+        for (auto& pool : m_Pools) {
+            for (auto& block : pool.blocks) {
+                FreeDeviceMemory(block->memory, block->mapped);
+            }
+            pool.blocks.clear();
+        }
+        m_Pools.clear();
+        m_Device = VK_NULL_HANDLE;
+    }
+
+    int VulkanMemoryAllocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+        for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; i++) {
+            if ((typeFilter & (1u << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    VulkanMemoryAllocator::Pool& VulkanMemoryAllocator::GetPool(uint32_t memoryType, ResourceKind kind) {
+        return m_Pools[memoryType * 2 + static_cast<uint32_t>(kind)];
+    }
+
+    int VulkanMemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags required,
+                                        VkMemoryPropertyFlags preferred, ResourceKind kind, MemoryAllocation& outAllocation) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        int memoryType = -1;
+        if (preferred != 0) {
+            memoryType = FindMemoryType(requirements.memoryTypeBits, required | preferred);
+            if (memoryType >= 0 && AllocateFromType(requirements, static_cast<uint32_t>(memoryType), kind, outAllocation) == 0) {
+                return 0;
+            }
+        }
+
+        memoryType = FindMemoryType(requirements.memoryTypeBits, required);
+        if (memoryType < 0) {
+            return -1;
+        }
+        return AllocateFromType(requirements, static_cast<uint32_t>(memoryType), kind, outAllocation);
+    }
+
+    int VulkanMemoryAllocator::AllocateFromType(const VkMemoryRequirements& requirements, uint32_t memoryType, ResourceKind kind,
+                                                MemoryAllocation& outAllocation) {
+        Pool& pool = GetPool(memoryType, kind);
+
+        if (requirements.size > pool.blockSize / 2) {
+            VkDeviceMemory memory;
+            void* mapped;
+            int result = AllocateDeviceMemory(requirements.size, memoryType, memory, mapped);
+            if (result != 0) {
+                return result;
+            }
+
+            outAllocation = {};
+            outAllocation.memory = memory;
+            outAllocation.size = requirements.size;
+            outAllocation.mapped = mapped;
+            outAllocation.memoryType = memoryType;
+            m_DedicatedCount++;
+            m_DedicatedBytes += requirements.size;
+            m_AllocationCount++;
+            return 0;
+        }
+
+        VkDeviceSize offset = 0;
+        VkDeviceSize blockSize = 0;
+        MemoryBlock* target = nullptr;
+        for (auto& block : pool.blocks) {
+            if (block->buddy.Allocate(requirements.size, requirements.alignment, offset, blockSize)) {
+                target = block.get();
+                break;
+            }
+        }
+
+        if (target == nullptr) {
+            auto block = std::make_unique<MemoryBlock>();
+            int result = AllocateDeviceMemory(pool.blockSize, memoryType, block->memory, block->mapped);
+            if (result != 0) {
+                return result;
+            }
+            block->memoryType = memoryType;
+            block->kind = kind;
+            block->buddy.Initialize(pool.blockSize, MinBlockSize);
+            block->buddy.Allocate(requirements.size, requirements.alignment, offset, blockSize);
+            target = block.get();
+            pool.blocks.push_back(std::move(block));
+        }
+
+        outAllocation = {};
+        outAllocation.memory = target->memory;
+        outAllocation.offset = offset;
+        outAllocation.size = requirements.size;
+        outAllocation.mapped = target->mapped ? static_cast<char*>(target->mapped) + offset : nullptr;
+        outAllocation.memoryType = memoryType;
+        outAllocation.block = target;
+        m_AllocationCount++;
+        return 0;
+    }
+
+    int VulkanMemoryAllocator::AllocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+                                                 MemoryAllocation& outAllocation) {
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_Device, buffer, &requirements);
+
+        int result = Allocate(requirements, required, preferred, ResourceKind::Linear, outAllocation);
+        if (result != 0) {
+            return result;
+        }
+        vkBindBufferMemory(m_Device, buffer, outAllocation.memory, outAllocation.offset);
+        return 0;
+    }
+
+    int VulkanMemoryAllocator::AllocateForImage(VkImage image, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+                                                MemoryAllocation& outAllocation) {
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(m_Device, image, &requirements);
+
+        int result = Allocate(requirements, required, preferred, ResourceKind::Optimal, outAllocation);
+        if (result != 0) {
+            return result;
+        }
+        vkBindImageMemory(m_Device, image, outAllocation.memory, outAllocation.offset);
+        return 0;
+    }
+
+    void VulkanMemoryAllocator::Free(MemoryAllocation& allocation) {
+        if (allocation.memory == VK_NULL_HANDLE) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (allocation.block == nullptr) {
+            FreeDeviceMemory(allocation.memory, allocation.mapped);
+            m_DedicatedCount--;
+            m_DedicatedBytes -= allocation.size;
+        } else {
+            MemoryBlock* block = allocation.block;
+            block->buddy.Free(allocation.offset);
+
+            // Keep one empty block per pool around so a pool that drains and refills does not hit the driver every time.
+            Pool& pool = GetPool(block->memoryType, block->kind);
+            if (block->buddy.IsEmpty() && pool.blocks.size() > 1) {
+                FreeDeviceMemory(block->memory, block->mapped);
+                pool.blocks.erase(std::find_if(pool.blocks.begin(), pool.blocks.end(),
+                                               [block](const std::unique_ptr<MemoryBlock>& entry) { return entry.get() == block; }));
+            }
+        }
+
+        m_AllocationCount--;
+        allocation = {};
+    }
+
+    int VulkanMemoryAllocator::AllocateDeviceMemory(VkDeviceSize size, uint32_t memoryType, VkDeviceMemory& outMemory, void*& outMapped) const {
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryType;
+
+        outMemory = VK_NULL_HANDLE;
+        outMapped = nullptr;
+        if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &outMemory) != VK_SUCCESS) {
+            return -2;
+        }
+
+        if (m_MemoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            if (vkMapMemory(m_Device, outMemory, 0, VK_WHOLE_SIZE, 0, &outMapped) != VK_SUCCESS) {
+                vkFreeMemory(m_Device, outMemory, nullptr);
+                outMemory = VK_NULL_HANDLE;
+                return -3;
+            }
+        }
+        return 0;
+    }
+
+    void VulkanMemoryAllocator::FreeDeviceMemory(VkDeviceMemory memory, void* mapped) const {
+        if (mapped != nullptr) {
+            vkUnmapMemory(m_Device, memory);
+        }
+        vkFreeMemory(m_Device, memory, nullptr);
+    }
+
+    GpuMemoryStats VulkanMemoryAllocator::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        GpuMemoryStats stats;
+        stats.dedicatedCount = m_DedicatedCount;
+        stats.allocationCount = m_AllocationCount;
+        stats.reservedBytes = m_DedicatedBytes;
+        stats.usedBytes = m_DedicatedBytes;
+
+        VkDeviceSize freeBytes = 0;
+        VkDeviceSize unusableBytes = 0;
+        for (const auto& pool : m_Pools) {
+            for (const auto& block : pool.blocks) {
+                VkDeviceSize blockFree = block->buddy.GetSize() - block->buddy.GetAllocatedBytes();
+                VkDeviceSize largest = block->buddy.GetLargestFreeBlock();
+                stats.blockCount++;
+                stats.reservedBytes += block->buddy.GetSize();
+                stats.usedBytes += block->buddy.GetAllocatedBytes();
+                stats.largestFreeBytes = std::max<uint64_t>(stats.largestFreeBytes, largest);
+                freeBytes += blockFree;
+                unusableBytes += blockFree - largest;
+            }
+        }
+
+        if (freeBytes > 0) {
+            stats.fragmentation = static_cast<double>(unusableBytes) / static_cast<double>(freeBytes);
+        }
+        return stats;
+    }
+
+    int VulkanLinearPool::Initialize(VkDevice device, VulkanMemoryAllocator& allocator, VkDeviceSize bytesPerFrame, uint32_t frameCount,
+                                     VkBufferUsageFlags usage) {
+        m_Device = device;
+        m_BytesPerFrame = AlignUp(std::max<VkDeviceSize>(bytesPerFrame, 1), LinearRegionAlignment);
+        m_Usage = usage;
+        m_Offsets.assign(frameCount, 0);
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = m_BytesPerFrame * frameCount;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateBuffer(m_Device, &bufferInfo, nullptr, &m_Buffer) != VK_SUCCESS) {
+            m_Buffer = VK_NULL_HANDLE;
+            return -1;
+        }
+
+        if (allocator.AllocateForBuffer(m_Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0,
+                                        m_Allocation) != 0) {
+            Shutdown(allocator);
+            return -2;
+        }
+        return 0;
+    }
+
+    void VulkanLinearPool::Shutdown(VulkanMemoryAllocator& allocator) {
+        if (m_Buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(m_Device, m_Buffer, nullptr);
+        }
+        allocator.Free(m_Allocation);
+        m_Buffer = VK_NULL_HANDLE;
+        m_BytesPerFrame = 0;
+        m_Offsets.clear();
+    }
+
+    bool VulkanLinearPool::Allocate(uint32_t frameSlot, VkDeviceSize size, VkDeviceSize alignment, LinearAllocation& outAllocation) {
+        if (m_Buffer == VK_NULL_HANDLE || frameSlot >= m_Offsets.size()) {
+            return false;
+        }
+
+        VkDeviceSize offset = AlignUp(m_Offsets[frameSlot], std::max<VkDeviceSize>(alignment, 1));
+        if (offset + size > m_BytesPerFrame) {
+            return false;
+        }
+        m_Offsets[frameSlot] = offset + size;
+
+        outAllocation.buffer = m_Buffer;
+        outAllocation.offset = m_BytesPerFrame * frameSlot + offset;
+        outAllocation.size = size;
+        outAllocation.mapped = static_cast<char*>(m_Allocation.mapped) + outAllocation.offset;
+        return true;
+    }
+}
@@ -0,0 +1,153 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANMEMORYALLOCATOR_H
+#define REDPLASMA_VULKANMEMORYALLOCATOR_H
+#include "renderer/IGraphicsDevice.h"
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    // Binary buddy allocator over an abstract range of offsets. Blocks are powers of two and naturally
+    // aligned to their size, so any power of two alignment up to the block size comes for free.
+    class BuddyAllocator {
+    public:
+        void Initialize(VkDeviceSize size, VkDeviceSize minBlockSize);
+
+        bool Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset, VkDeviceSize& outBlockSize);
+        void Free(VkDeviceSize offset);
+
+        [[nodiscard]] bool IsEmpty() const { return m_AllocatedBytes == 0; }
+        [[nodiscard]] VkDeviceSize GetSize() const { return m_Size; }
+        [[nodiscard]] VkDeviceSize GetAllocatedBytes() const { return m_AllocatedBytes; }
+        [[nodiscard]] VkDeviceSize GetLargestFreeBlock() const;
+
+    private:
+        [[nodiscard]] uint32_t OrderForSize(VkDeviceSize size) const;
+
+        VkDeviceSize m_Size = 0;
+        VkDeviceSize m_MinBlockSize = 0;
+        VkDeviceSize m_AllocatedBytes = 0;
+        uint32_t m_MaxOrder = 0;
+        // Free block offsets per order, order n holds blocks of m_MinBlockSize << n.
+        std::vector<std::set<VkDeviceSize>> m_FreeLists;
+        std::unordered_map<VkDeviceSize, uint32_t> m_AllocatedOrders;
+    };
+
+    // Buffers and linear images may share pages with each other but not with optimal images
+    // (bufferImageGranularity), so the two kinds are kept apart.
+    enum class ResourceKind : uint32_t {
+        Linear = 0,
+        Optimal = 1
+    };
+
+    // One vkAllocateMemory call that resources are sub-allocated from.
+    struct MemoryBlock {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+        uint32_t memoryType = 0;
+        ResourceKind kind = ResourceKind::Linear;
+        BuddyAllocator buddy;
+    };
+
+    struct MemoryAllocation {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        // Only set for host visible memory, which is mapped for as long as it is allocated.
+        void* mapped = nullptr;
+        uint32_t memoryType = 0;
+        // Null for dedicated allocations.
+        MemoryBlock* block = nullptr;
+    };
+
+    // Sub-allocates resources from large per memory type blocks, so the scene size is not bound to
+    // the driver's maxMemoryAllocationCount. Requests bigger than half a block get their own allocation.
+    class VulkanMemoryAllocator {
+    public:
+        void Initialize(VkPhysicalDevice physicalDevice, VkDevice device);
+        void Shutdown();
+
+        // Tries required | preferred first and falls back to required alone.
+        int Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+                     ResourceKind kind, MemoryAllocation& outAllocation);
+        int AllocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, MemoryAllocation& outAllocation);
+        int AllocateForImage(VkImage image, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, MemoryAllocation& outAllocation);
+        void Free(MemoryAllocation& allocation);
+
+        [[nodiscard]] int FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+        [[nodiscard]] GpuMemoryStats GetStats() const;
+
+    private:
+        struct Pool {
+            VkDeviceSize blockSize = 0;
+            std::vector<std::unique_ptr<MemoryBlock>> blocks;
+        };
+
+        int AllocateFromType(const VkMemoryRequirements& requirements, uint32_t memoryType, ResourceKind kind, MemoryAllocation& outAllocation);
+        int AllocateDeviceMemory(VkDeviceSize size, uint32_t memoryType, VkDeviceMemory& outMemory, void*& outMapped) const;
+        void FreeDeviceMemory(VkDeviceMemory memory, void* mapped) const;
+        Pool& GetPool(uint32_t memoryType, ResourceKind kind);
+
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties = {};
+        // Indexed by memoryType * 2 + kind.
+        std::vector<Pool> m_Pools;
+        uint64_t m_AllocationCount = 0;
+        uint64_t m_DedicatedCount = 0;
+        uint64_t m_DedicatedBytes = 0;
+        mutable std::mutex m_Mutex;
+    };
+
+    // Range of a linear pool's buffer. It belongs to the pool and goes away with its frame's region, there is no
+    // MemoryAllocation to hand to VulkanMemoryAllocator::Free.
+    struct LinearAllocation {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void* mapped = nullptr;
+    };
+
+    // Per-frame bump allocator over one persistently mapped host visible buffer, for transients that live exactly
+    // one frame. Every frame slot owns an equal region that is reset once that frame has retired. Being a single
+    // buffer, the allocator already keeps it apart from optimal images.
+    class VulkanLinearPool {
+    public:
+        int Initialize(VkDevice device, VulkanMemoryAllocator& allocator, VkDeviceSize bytesPerFrame, uint32_t frameCount,
+                       VkBufferUsageFlags usage);
+        void Shutdown(VulkanMemoryAllocator& allocator);
+
+        // Fails if the frame's region is full. The alignment has to be a power of two.
+        bool Allocate(uint32_t frameSlot, VkDeviceSize size, VkDeviceSize alignment, LinearAllocation& outAllocation);
+        void Reset(uint32_t frameSlot) { m_Offsets[frameSlot] = 0; }
+
+        [[nodiscard]] bool IsInitialized() const { return m_Buffer != VK_NULL_HANDLE; }
+        [[nodiscard]] VkDeviceSize GetBytesPerFrame() const { return m_BytesPerFrame; }
+        [[nodiscard]] uint32_t GetFrameCount() const { return static_cast<uint32_t>(m_Offsets.size()); }
+        [[nodiscard]] VkBufferUsageFlags GetUsage() const { return m_Usage; }
+        [[nodiscard]] VkDeviceSize GetUsed(uint32_t frameSlot) const { return m_Offsets[frameSlot]; }
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkBuffer m_Buffer = VK_NULL_HANDLE;
+        MemoryAllocation m_Allocation;
+        VkDeviceSize m_BytesPerFrame = 0;
+        VkBufferUsageFlags m_Usage = 0;
+        std::vector<VkDeviceSize> m_Offsets;
+    };
+}
+#endif //REDPLASMA_VULKANMEMORYALLOCATOR_H
\ No newline at end of file
@@ -0,0 +1,187 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+
+#include "VulkanPipelineCache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace RedPlasma {
+    namespace {
+        constexpr uint32_t CacheMagic = 0x43505052; // "RPPC"
+        constexpr uint32_t CacheFormatVersion = 1;
+
+        struct CacheFileHeader {
+            uint32_t magic;
+            uint32_t formatVersion;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint32_t driverVersion;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+            uint64_t dataSize;
+            uint64_t checksum;
+        };
+
+        // FNV-1a, only meant to catch truncated or damaged files.
+        uint64_t Checksum(const char* data, size_t size) {
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (size_t i = 0; i < size; i++) {
+                hash ^= static_cast<uint8_t>(data[i]);
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+    }
+
+    std::string VulkanPipelineCache::GetDefaultPath() {
+        std::filesystem::path directory;
+        if (const char* cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome != nullptr && cacheHome[0] != '\0') {
+            directory = cacheHome;
+        } else if (const char* home = std::getenv("HOME"); home != nullptr && home[0] != '\0') {
+            directory = std::filesystem::path(home) / ".cache";
+        } else {
+            directory = std::filesystem::temp_directory_path();
+        }
+        return (directory / "RedPlasma" / "pipeline_cache.bin").string();
+    }
+
+    int VulkanPipelineCache::Initialize(VkDevice device, const VkPhysicalDeviceProperties& properties, const std::string& path) {
+        m_Device = device;
+        m_Properties = properties;
+        m_Path = path.empty() ? GetDefaultPath() : path;
+
+        std::string data;
+        if (!LoadFile(data)) {
+            data.clear();
+        }
+
+        VkPipelineCacheCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = data.size();
+        createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+        if (vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_Cache) != VK_SUCCESS) {
+            // Some drivers still choke on data that passed our checks, retry empty before giving up.
+            createInfo.initialDataSize = 0;
+            createInfo.pInitialData = nullptr;
+            if (vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_Cache) != VK_SUCCESS) {
+                return -1;
+            }
+        }
+
+        if (!data.empty()) {
+            std::cout << "Loaded pipeline cache (" << data.size() << " bytes) from " << m_Path << std::endl;
+        }
+        return 0;
+    }
+
+    bool VulkanPipelineCache::LoadFile(std::string& outData) const {
+        std::ifstream file(m_Path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (contents.size() < sizeof(CacheFileHeader)) {
+            std::cout << "Pipeline cache is truncated, discarding it" << std::endl;
+            return false;
+        }
+
+        CacheFileHeader header;
+        std::memcpy(&header, contents.data(), sizeof(header));
+        const char* payload = contents.data() + sizeof(header);
+        size_t payloadSize = contents.size() - sizeof(header);
+
+        if (header.magic != CacheMagic || header.formatVersion != CacheFormatVersion ||
+            header.dataSize != payloadSize || header.checksum != Checksum(payload, payloadSize)) {
+            std::cout << "Pipeline cache is corrupt, discarding it" << std::endl;
+            return false;
+        }
+
+        if (header.vendorID != m_Properties.vendorID || header.deviceID != m_Properties.deviceID ||
+            header.driverVersion != m_Properties.driverVersion ||
+            std::memcmp(header.pipelineCacheUUID, m_Properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            std::cout << "Pipeline cache was written by another device or driver, discarding it" << std::endl;
+            return false;
+        }
+
+        outData.assign(payload, payloadSize);
+        return true;
+    }
+
+    int VulkanPipelineCache::Save() const {
+        if (m_Cache == VK_NULL_HANDLE) {
+            return -1;
+        }
+
+        size_t dataSize = 0;
+        if (vkGetPipelineCacheData(m_Device, m_Cache, &dataSize, nullptr) != VK_SUCCESS) {
+            return -2;
+        }
+        std::string data(dataSize, '\0');
+        if (dataSize > 0 && vkGetPipelineCacheData(m_Device, m_Cache, &dataSize, data.data()) != VK_SUCCESS) {
+            return -2;
+        }
+        data.resize(dataSize);
+
+        CacheFileHeader header = {};
+        header.magic = CacheMagic;
+        header.formatVersion = CacheFormatVersion;
+        header.vendorID = m_Properties.vendorID;
+        header.deviceID = m_Properties.deviceID;
+        header.driverVersion = m_Properties.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, m_Properties.pipelineCacheUUID, VK_UUID_SIZE);
+        header.dataSize = data.size();
+        header.checksum = Checksum(data.data(), data.size());
+
+        std::error_code error;
+        std::filesystem::path path(m_Path);
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file.good()) {
+                std::filesystem::remove(temporaryPath, error);
+                return -3;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error) {
+            std::filesystem::remove(temporaryPath, error);
+            return -4;
+        }
+        return 0;
+    }
+
+    void VulkanPipelineCache::Shutdown() {
+        if (m_Cache == VK_NULL_HANDLE) {
+            return;
+        }
+
+        if (Save() != 0) {
+            std::cout << "Failed to write pipeline cache to " << m_Path << std::endl;
+        }
+        vkDestroyPipelineCache(m_Device, m_Cache, nullptr);
+        m_Cache = VK_NULL_HANDLE;
+    }
+}
@@ -0,0 +1,46 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANPIPELINECACHE_H
+#define REDPLASMA_VULKANPIPELINECACHE_H
+#include <string>
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    // VkPipelineCache that survives restarts. The blob is stored behind our own header so a cache from another
+    // GPU, driver version or a half written file is thrown away instead of being handed to the driver.
+    class VulkanPipelineCache {
+    public:
+        // An empty path uses GetDefaultPath(). A missing or rejected file just starts with an empty cache.
+        int Initialize(VkDevice device, const VkPhysicalDeviceProperties& properties, const std::string& path = "");
+        // Saves the cache and destroys it.
+        void Shutdown();
+
+        // Writes to a temporary file and renames it over the old one, so readers never see a partial file.
+        int Save() const;
+
+        [[nodiscard]] VkPipelineCache GetHandle() const { return m_Cache; }
+
+        // $XDG_CACHE_HOME/RedPlasma/pipeline_cache.bin, falling back to ~/.cache.
+        static std::string GetDefaultPath();
+
+    private:
+        bool LoadFile(std::string& outData) const;
+
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkPipelineCache m_Cache = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties m_Properties = {};
+        std::string m_Path;
+    };
+}
+#endif //REDPLASMA_VULKANPIPELINECACHE_H
\ No newline at end of file
@@ -0,0 +1,619 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "VulkanRenderGraph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace RedPlasma {
+    namespace {
+        struct AccessInfo {
+            VkPipelineStageFlags2 stages;
+            VkAccessFlags2 access;
+            VkImageLayout layout;
+        };
+
+        AccessInfo GetAccessInfo(RenderAccess access) {
+            switch (access) {
+                case RenderAccess::ColorAttachmentWrite:
+                    return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+                case RenderAccess::DepthAttachmentWrite:
+                    return { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                             VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                             VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL };
+                case RenderAccess::DepthAttachmentRead:
+                    return { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                             VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                             VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL };
+                case RenderAccess::ShaderSampledRead:
+                    return { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                             VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+                case RenderAccess::ComputeStorageRead:
+                    return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_IMAGE_LAYOUT_GENERAL };
+                case RenderAccess::ComputeStorageWrite:
+                    return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                             VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                             VK_IMAGE_LAYOUT_GENERAL };
+                case RenderAccess::GraphicsStorageRead:
+                    return { VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                             VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_IMAGE_LAYOUT_GENERAL };
+                case RenderAccess::TransferRead:
+                    return { VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL };
+                case RenderAccess::TransferWrite:
+                    // Fills and updates run in the clear stage, copies in the copy stage.
+                    return { VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL };
+                case RenderAccess::VertexInputRead:
+                    return { VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT,
+                             VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT,
+                             VK_IMAGE_LAYOUT_UNDEFINED };
+                case RenderAccess::IndirectRead:
+                    return { VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED };
+                case RenderAccess::HostRead:
+                    return { VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED };
+                case RenderAccess::Present:
+                    break;
+            }
+            return { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR };
+        }
+
+        VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    RenderPassBuilder& RenderPassBuilder::Read(RenderResource resource, RenderAccess access) {
+        m_Graph.m_Passes[m_Pass].uses.push_back({ resource, access, false });
+        return *this;
+    }
+
+    RenderPassBuilder& RenderPassBuilder::Write(RenderResource resource, RenderAccess access) {
+        m_Graph.m_Passes[m_Pass].uses.push_back({ resource, access, true });
+        return *this;
+    }
+
+    RenderPassBuilder& RenderPassBuilder::SetColorAttachment(RenderResource resource, VkClearColorValue clearColor) {
+        VulkanRenderGraph::Attachment attachment;
+        attachment.resource = resource;
+        attachment.clear.color = clearColor;
+        m_Graph.m_Passes[m_Pass].colorAttachments.push_back(attachment);
+        return Write(resource, RenderAccess::ColorAttachmentWrite);
+    }
+
+    RenderPassBuilder& RenderPassBuilder::SetDepthAttachment(RenderResource resource, float clearDepth) {
+        VulkanRenderGraph::Attachment& attachment = m_Graph.m_Passes[m_Pass].depthAttachment;
+        attachment.resource = resource;
+        attachment.clear.depthStencil = { clearDepth, 0 };
+        return Write(resource, RenderAccess::DepthAttachmentWrite);
+    }
+
+    RenderPassBuilder& RenderPassBuilder::SetRenderingFlags(VkRenderingFlags flags) {
+        m_Graph.m_Passes[m_Pass].renderingFlags = flags;
+        return *this;
+    }
+
+    RenderPassBuilder& RenderPassBuilder::SetSideEffect() {
+        m_Graph.m_Passes[m_Pass].sideEffect = true;
+        return *this;
+    }
+
+    void VulkanRenderGraph::Initialize(VkDevice device, VulkanMemoryAllocator* allocator, uint32_t frameCount) {
+        m_Device = device;
+        m_Allocator = allocator;
+        m_Slots.resize(frameCount);
+    }
+
+    void VulkanRenderGraph::Shutdown() {
+        for (auto& slot : m_Slots) {
+            DestroyTransients(slot);
+        }
+        m_Slots.clear();
+        Reset();
+    }
+
+    void VulkanRenderGraph::Reset() {
+        m_Resources.clear();
+        m_Passes.clear();
+        m_FinalImageBarriers.clear();
+        m_FinalBufferBarriers.clear();
+    }
+
+    RenderResource VulkanRenderGraph::ImportImage(VkImage image, VkImageView view, VkFormat format, VkExtent2D extent,
+                                                  VkImageAspectFlags aspect, const RenderResourceState& initialState) {
+        Resource resource;
+        resource.type = ResourceType::Image;
+        resource.image = image;
+        resource.view = view;
+        resource.format = format;
+        resource.extent = extent;
+        resource.aspect = aspect;
+        resource.initialState = initialState;
+        m_Resources.push_back(resource);
+        return static_cast<RenderResource>(m_Resources.size() - 1);
+    }
+
+    RenderResource VulkanRenderGraph::ImportBuffer(VkBuffer buffer, const RenderResourceState& initialState) {
+        Resource resource;
+        resource.type = ResourceType::Buffer;
+        resource.buffer = buffer;
+        resource.initialState = initialState;
+        m_Resources.push_back(resource);
+        return static_cast<RenderResource>(m_Resources.size() - 1);
+    }
+
+    RenderResource VulkanRenderGraph::CreateTransientImage(const TransientImageDesc& desc) {
+        Resource resource;
+        resource.type = ResourceType::Image;
+        resource.transient = true;
+        resource.desc = desc;
+        resource.format = desc.format;
+        resource.extent = desc.extent;
+        resource.aspect = desc.aspect;
+        m_Resources.push_back(resource);
+        return static_cast<RenderResource>(m_Resources.size() - 1);
+    }
+
+    RenderPassBuilder VulkanRenderGraph::AddPass(const char* name, RenderPassExecute execute) {
+        Pass pass;
+        pass.name = name;
+        pass.execute = std::move(execute);
+        m_Passes.push_back(std::move(pass));
+        return RenderPassBuilder(*this, static_cast<uint32_t>(m_Passes.size() - 1));
+    }
+
+    void VulkanRenderGraph::MarkOutput(RenderResource resource, RenderAccess finalAccess) {
+        m_Resources[resource].isOutput = true;
+        m_Resources[resource].finalAccess = finalAccess;
+    }
+
+    int VulkanRenderGraph::Compile(uint32_t frameSlot) {
+        if (frameSlot >= m_Slots.size()) {
+            return -1;
+        }
+
+        CullPasses();
+        int result = AllocateTransients(m_Slots[frameSlot]);
+        if (result != 0) {
+            return result;
+        }
+        BuildBarriers(m_Slots[frameSlot]);
+        return 0;
+    }
+
+    void VulkanRenderGraph::CullPasses() {
+        // Walk backwards from the outputs, a pass survives if something downstream needs one of its writes.
+        // Every write is treated as partial, so earlier writers of a needed resource are kept as well.
+        std::vector<bool> needed(m_Resources.size(), false);
+        for (size_t i = 0; i < m_Resources.size(); i++) {
+            needed[i] = m_Resources[i].isOutput;
+        }
+
+        m_CulledPasses = 0;
+        for (size_t i = m_Passes.size(); i-- > 0;) {
+            Pass& pass = m_Passes[i];
+            bool alive = pass.sideEffect;
+            for (const ResourceUse& use : pass.uses) {
+                alive = alive || (use.write && needed[use.resource]);
+            }
+
+            pass.culled = !alive;
+            if (!alive) {
+                m_CulledPasses++;
+                continue;
+            }
+            for (const ResourceUse& use : pass.uses) {
+                if (!use.write) {
+                    needed[use.resource] = true;
+                }
+            }
+        }
+    }
+
+    int VulkanRenderGraph::AllocateTransients(TransientSlot& slot) {
+        // Lifetimes in pass indices, only surviving passes count.
+        std::vector<TransientImage> wanted;
+        for (size_t passIndex = 0; passIndex < m_Passes.size(); passIndex++) {
+            if (m_Passes[passIndex].culled) {
+                continue;
+            }
+            for (const ResourceUse& use : m_Passes[passIndex].uses) {
+                Resource& resource = m_Resources[use.resource];
+                if (!resource.transient) {
+                    continue;
+                }
+                if (resource.transientIndex == UINT32_MAX) {
+                    resource.transientIndex = static_cast<uint32_t>(wanted.size());
+                    TransientImage image;
+                    image.desc = resource.desc;
+                    image.firstPass = static_cast<uint32_t>(passIndex);
+                    wanted.push_back(image);
+                }
+                wanted[resource.transientIndex].lastPass = static_cast<uint32_t>(passIndex);
+            }
+        }
+
+        bool reusable = wanted.size() == slot.images.size();
+        for (size_t i = 0; reusable && i < wanted.size(); i++) {
+            reusable = wanted[i].desc == slot.images[i].desc &&
+                       wanted[i].firstPass == slot.images[i].firstPass &&
+                       wanted[i].lastPass == slot.images[i].lastPass;
+        }
+
+        if (!reusable) {
+            DestroyTransients(slot);
+            slot.images = std::move(wanted);
+
+            std::vector<VkMemoryRequirements> requirements(slot.images.size());
+            for (size_t i = 0; i < slot.images.size(); i++) {
+                TransientImage& image = slot.images[i];
+                VkImageCreateInfo imageInfo = {};
+                imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+                imageInfo.imageType = VK_IMAGE_TYPE_2D;
+                imageInfo.format = image.desc.format;
+                imageInfo.extent = { image.desc.extent.width, image.desc.extent.height, 1 };
+                imageInfo.mipLevels = 1;
+                imageInfo.arrayLayers = 1;
+                imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+                imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+                imageInfo.usage = image.desc.usage;
+                imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                if (vkCreateImage(m_Device, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
+                    DestroyTransients(slot);
+                    return -2;
+                }
+                vkGetImageMemoryRequirements(m_Device, image.image, &requirements[i]);
+                image.size = requirements[i].size;
+                slot.unaliasedBytes += requirements[i].size;
+            }
+
+            // Largest first, each image goes into the lowest gap not used by an image that is alive at the same time.
+            std::vector<uint32_t> order(slot.images.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return slot.images[a].size > slot.images[b].size;
+            });
+
+            VkMemoryRequirements combined = {};
+            combined.alignment = 1;
+            combined.memoryTypeBits = ~0u;
+            std::vector<uint32_t> placed;
+            for (uint32_t index : order) {
+                TransientImage& image = slot.images[index];
+                std::vector<std::pair<VkDeviceSize, VkDeviceSize>> occupied;
+                for (uint32_t other : placed) {
+                    const TransientImage& placedImage = slot.images[other];
+                    if (placedImage.firstPass <= image.lastPass && image.firstPass <= placedImage.lastPass) {
+                        occupied.emplace_back(placedImage.offset, placedImage.offset + placedImage.size);
+                    }
+                }
+                std::sort(occupied.begin(), occupied.end());
+
+                VkDeviceSize offset = 0;
+                for (const auto& [begin, end] : occupied) {
+                    if (AlignUp(offset, requirements[index].alignment) + image.size <= begin) {
+                        break;
+                    }
+                    offset = std::max(offset, end);
+                }
+                image.offset = AlignUp(offset, requirements[index].alignment);
+                placed.push_back(index);
+
+                combined.size = std::max(combined.size, image.offset + image.size);
+                combined.alignment = std::max(combined.alignment, requirements[index].alignment);
+                combined.memoryTypeBits &= requirements[index].memoryTypeBits;
+            }
+
+            for (size_t i = 0; i < slot.images.size(); i++) {
+                for (size_t j = 0; j < slot.images.size(); j++) {
+                    const TransientImage& earlier = slot.images[j];
+                    TransientImage& later = slot.images[i];
+                    bool sharesMemory = earlier.offset < later.offset + later.size && later.offset < earlier.offset + earlier.size;
+                    if (i != j && sharesMemory && earlier.lastPass < later.firstPass) {
+                        later.aliases.push_back(static_cast<uint32_t>(j));
+                    }
+                }
+            }
+
+            if (!slot.images.empty() && combined.memoryTypeBits != 0) {
+                if (m_Allocator->Allocate(combined, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, ResourceKind::Optimal, slot.allocation) != 0) {
+                    DestroyTransients(slot);
+                    return -3;
+                }
+                slot.bytes = combined.size;
+            } else if (!slot.images.empty()) {
+                // The images share no memory type, so nothing can alias. Every image gets memory of its own.
+                std::cout << "Render graph transients have no common memory type, aliasing disabled" << std::endl;
+                for (auto& image : slot.images) {
+                    image.offset = 0;
+                    image.aliases.clear();
+                    if (m_Allocator->AllocateForImage(image.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, image.ownAllocation) != 0) {
+                        DestroyTransients(slot);
+                        return -3;
+                    }
+                    slot.bytes += image.ownAllocation.size;
+                }
+            }
+
+            for (auto& image : slot.images) {
+                const MemoryAllocation& memory = image.ownAllocation.memory != VK_NULL_HANDLE ? image.ownAllocation : slot.allocation;
+                if (vkBindImageMemory(m_Device, image.image, memory.memory, memory.offset + image.offset) != VK_SUCCESS) {
+                    DestroyTransients(slot);
+                    return -4;
+                }
+
+                VkImageViewCreateInfo viewInfo = {};
+                viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                viewInfo.image = image.image;
+                viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+                viewInfo.format = image.desc.format;
+                viewInfo.subresourceRange = { image.desc.aspect, 0, 1, 0, 1 };
+                if (vkCreateImageView(m_Device, &viewInfo, nullptr, &image.view) != VK_SUCCESS) {
+                    DestroyTransients(slot);
+                    return -5;
+                }
+            }
+        }
+
+        for (auto& resource : m_Resources) {
+            if (resource.transient && resource.transientIndex != UINT32_MAX) {
+                resource.image = slot.images[resource.transientIndex].image;
+                resource.view = slot.images[resource.transientIndex].view;
+            }
+        }
+        m_TransientBytes = slot.bytes;
+        m_UnaliasedTransientBytes = slot.unaliasedBytes;
+        return 0;
+    }
+
+    void VulkanRenderGraph::DestroyTransients(TransientSlot& slot) {
+        for (auto& image : slot.images) {
+            vkDestroyImageView(m_Device, image.view, nullptr);
+            vkDestroyImage(m_Device, image.image, nullptr);
+            if (image.ownAllocation.memory != VK_NULL_HANDLE) {
+                m_Allocator->Free(image.ownAllocation);
+            }
+        }
+        slot.images.clear();
+        if (slot.allocation.memory != VK_NULL_HANDLE) {
+            m_Allocator->Free(slot.allocation);
+            slot.allocation = {};
+        }
+        slot.bytes = 0;
+        slot.unaliasedBytes = 0;
+    }
+
+    void VulkanRenderGraph::BuildBarriers(const TransientSlot& slot) {
+        std::vector<TrackedState> states(m_Resources.size());
+        std::vector<RenderResource> transientOwners(slot.images.size(), InvalidRenderResource);
+        std::vector<bool> touched(m_Resources.size(), false);
+        for (size_t i = 0; i < m_Resources.size(); i++) {
+            const Resource& resource = m_Resources[i];
+            states[i].writeStages = resource.initialState.stages;
+            states[i].writeAccess = resource.initialState.access;
+            states[i].layout = resource.initialState.layout;
+            if (resource.transient && resource.transientIndex != UINT32_MAX) {
+                transientOwners[resource.transientIndex] = static_cast<RenderResource>(i);
+            }
+        }
+
+        m_BarrierCount = 0;
+        for (size_t passIndex = 0; passIndex < m_Passes.size(); passIndex++) {
+            Pass& pass = m_Passes[passIndex];
+            pass.imageBarriers.clear();
+            pass.bufferBarriers.clear();
+            if (pass.culled) {
+                continue;
+            }
+
+            // Depth that nothing reads after this pass never has to reach memory.
+            const Resource* depth = pass.depthAttachment.resource != InvalidRenderResource ? &m_Resources[pass.depthAttachment.resource] : nullptr;
+            pass.discardDepth = depth != nullptr && depth->transient && slot.images[depth->transientIndex].lastPass == passIndex;
+
+            for (const ResourceUse& use : pass.uses) {
+                const Resource& resource = m_Resources[use.resource];
+                VkPipelineStageFlags2 aliasStages = VK_PIPELINE_STAGE_2_NONE;
+                VkAccessFlags2 aliasAccess = VK_ACCESS_2_NONE;
+                if (!touched[use.resource] && resource.transient) {
+                    // The memory still belongs to whatever lived there before, wait for its last use.
+                    for (uint32_t alias : slot.images[resource.transientIndex].aliases) {
+                        const TrackedState& previous = states[transientOwners[alias]];
+                        aliasStages |= previous.writeStages | previous.readStages;
+                        aliasAccess |= previous.writeAccess;
+                    }
+                }
+                touched[use.resource] = true;
+                AddBarrier(pass, resource, states[use.resource], use.access, use.write, aliasStages, aliasAccess);
+            }
+            m_BarrierCount += static_cast<uint32_t>(pass.imageBarriers.size() + pass.bufferBarriers.size());
+        }
+
+        Pass outputs;
+        for (size_t i = 0; i < m_Resources.size(); i++) {
+            if (m_Resources[i].isOutput) {
+                AddBarrier(outputs, m_Resources[i], states[i], m_Resources[i].finalAccess, false, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+            }
+        }
+        m_FinalImageBarriers = std::move(outputs.imageBarriers);
+        m_FinalBufferBarriers = std::move(outputs.bufferBarriers);
+        m_BarrierCount += static_cast<uint32_t>(m_FinalImageBarriers.size() + m_FinalBufferBarriers.size());
+    }
+
+    void VulkanRenderGraph::AddBarrier(Pass& pass, const Resource& resource, TrackedState& state, RenderAccess access, bool write,
+                                       VkPipelineStageFlags2 extraSrcStages, VkAccessFlags2 extraSrcAccess) {
+        AccessInfo info = GetAccessInfo(access);
+        bool isImage = resource.type == ResourceType::Image;
+        bool layoutChange = isImage && state.layout != info.layout;
+
+        VkPipelineStageFlags2 srcStages = extraSrcStages;
+        VkAccessFlags2 srcAccess = extraSrcAccess;
+        bool needed = layoutChange || extraSrcStages != VK_PIPELINE_STAGE_2_NONE;
+        if (write) {
+            // Write after write needs the earlier write finished, write after read only an execution dependency.
+            srcStages |= state.writeStages | state.readStages;
+            srcAccess |= state.writeAccess;
+            needed = needed || srcStages != VK_PIPELINE_STAGE_2_NONE;
+        } else {
+            // Reads only wait for a write that has not been made visible to them yet.
+            bool visible = (info.stages & ~state.visibleStages) == 0 && (info.access & ~state.visibleAccess) == 0;
+            bool pendingWrite = state.writeAccess != VK_ACCESS_2_NONE && !visible;
+            srcStages |= state.writeStages | (layoutChange ? state.readStages : VK_PIPELINE_STAGE_2_NONE);
+            srcAccess |= state.writeAccess;
+            needed = needed || pendingWrite;
+        }
+
+        if (write) {
+            state.writeStages = info.stages;
+            state.writeAccess = info.access;
+            state.readStages = VK_PIPELINE_STAGE_2_NONE;
+            state.visibleStages = info.stages;
+            state.visibleAccess = info.access;
+        } else {
+            state.readStages |= info.stages;
+            if (needed) {
+                state.visibleStages |= info.stages;
+                state.visibleAccess |= info.access;
+            }
+        }
+        VkImageLayout oldLayout = state.layout;
+        if (isImage) {
+            state.layout = info.layout;
+        }
+
+        if (!needed) {
+            return;
+        }
+
+        // A resource used twice in one pass gets a single barrier, barriers within one batch are unordered.
+        if (isImage) {
+            for (auto& barrier : pass.imageBarriers) {
+                if (barrier.image == resource.image) {
+                    barrier.dstStageMask |= info.stages;
+                    barrier.dstAccessMask |= info.access;
+                    barrier.newLayout = info.layout;
+                    return;
+                }
+            }
+            VkImageMemoryBarrier2 barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = srcStages;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstStageMask = info.stages;
+            barrier.dstAccessMask = info.access;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = info.layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = resource.image;
+            barrier.subresourceRange = { resource.aspect, 0, 1, 0, 1 };
+            pass.imageBarriers.push_back(barrier);
+        } else {
+            for (auto& barrier : pass.bufferBarriers) {
+                if (barrier.buffer == resource.buffer) {
+                    barrier.dstStageMask |= info.stages;
+                    barrier.dstAccessMask |= info.access;
+                    return;
+                }
+            }
+            VkBufferMemoryBarrier2 barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+            barrier.srcStageMask = srcStages;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstStageMask = info.stages;
+            barrier.dstAccessMask = info.access;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = resource.buffer;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+            pass.bufferBarriers.push_back(barrier);
+        }
+    }
+
+    void VulkanRenderGraph::RecordBarriers(VkCommandBuffer commandBuffer, const std::vector<VkImageMemoryBarrier2>& imageBarriers,
+                                           const std::vector<VkBufferMemoryBarrier2>& bufferBarriers) const {
+        if (imageBarriers.empty() && bufferBarriers.empty()) {
+            return;
+        }
+        VkDependencyInfo dependency = {};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+        dependency.pImageMemoryBarriers = imageBarriers.data();
+        dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+        dependency.pBufferMemoryBarriers = bufferBarriers.data();
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+    }
+
+    void VulkanRenderGraph::Execute(VkCommandBuffer commandBuffer, VulkanGpuProfiler& profiler) {
+        std::vector<VkRenderingAttachmentInfo> colorInfos;
+        for (Pass& pass : m_Passes) {
+            if (pass.culled) {
+                continue;
+            }
+            ScopedGpuZone zone(profiler, commandBuffer, pass.name);
+            RecordBarriers(commandBuffer, pass.imageBarriers, pass.bufferBarriers);
+
+            bool hasDepth = pass.depthAttachment.resource != InvalidRenderResource;
+            bool rendering = !pass.colorAttachments.empty() || hasDepth;
+            if (rendering) {
+                colorInfos.clear();
+                for (const Attachment& attachment : pass.colorAttachments) {
+                    VkRenderingAttachmentInfo info = {};
+                    info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+                    info.imageView = m_Resources[attachment.resource].view;
+                    info.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                    info.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                    info.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                    info.clearValue = attachment.clear;
+                    colorInfos.push_back(info);
+                }
+
+                VkRenderingAttachmentInfo depthInfo = {};
+                if (hasDepth) {
+                    depthInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+                    depthInfo.imageView = m_Resources[pass.depthAttachment.resource].view;
+                    depthInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+                    depthInfo.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                    depthInfo.storeOp = pass.discardDepth ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+                    depthInfo.clearValue = pass.depthAttachment.clear;
+                }
+
+                RenderResource first = pass.colorAttachments.empty() ? pass.depthAttachment.resource : pass.colorAttachments[0].resource;
+                VkRenderingInfo renderingInfo = {};
+                renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+                renderingInfo.flags = pass.renderingFlags;
+                renderingInfo.renderArea.offset = { 0, 0 };
+                renderingInfo.renderArea.extent = m_Resources[first].extent;
+                renderingInfo.layerCount = 1;
+                renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorInfos.size());
+                renderingInfo.pColorAttachments = colorInfos.data();
+                renderingInfo.pDepthAttachment = hasDepth ? &depthInfo : nullptr;
+                vkCmdBeginRendering(commandBuffer, &renderingInfo);
+            }
+
+            if (pass.execute) {
+                pass.execute(commandBuffer);
+            }
+
+            if (rendering) {
+                vkCmdEndRendering(commandBuffer);
+            }
+        }
+        RecordBarriers(commandBuffer, m_FinalImageBarriers, m_FinalBufferBarriers);
+    }
+}
@@ -0,0 +1,219 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANRENDERGRAPH_H
+#define REDPLASMA_VULKANRENDERGRAPH_H
+#include "VulkanGpuProfiler.h"
+#include "VulkanMemoryAllocator.h"
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    using RenderResource = uint32_t;
+    constexpr RenderResource InvalidRenderResource = UINT32_MAX;
+
+    // How a pass touches a resource. Each value maps to one stage/access/layout triple, see the table in the .cpp.
+    enum class RenderAccess : uint32_t {
+        ColorAttachmentWrite,
+        DepthAttachmentWrite,
+        DepthAttachmentRead,
+        ShaderSampledRead,
+        ComputeStorageRead,
+        ComputeStorageWrite,
+        GraphicsStorageRead,
+        TransferRead,
+        TransferWrite,
+        VertexInputRead,
+        IndirectRead,
+        HostRead,
+        Present
+    };
+
+    struct TransientImageDesc {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent = {};
+        VkImageUsageFlags usage = 0;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+
+        bool operator==(const TransientImageDesc& other) const {
+            return format == other.format && extent.width == other.extent.width && extent.height == other.extent.height &&
+                   usage == other.usage && aspect == other.aspect;
+        }
+    };
+
+    // Where an imported resource stands when the graph starts, so the first barrier waits for the right work.
+    struct RenderResourceState {
+        VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 access = VK_ACCESS_2_NONE;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+    using RenderPassExecute = std::function<void(VkCommandBuffer commandBuffer)>;
+
+    class VulkanRenderGraph;
+
+    // Declares what a pass reads and writes. Only valid until the next AddPass call.
+    class RenderPassBuilder {
+    public:
+        RenderPassBuilder(VulkanRenderGraph& graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+        RenderPassBuilder& Read(RenderResource resource, RenderAccess access);
+        RenderPassBuilder& Write(RenderResource resource, RenderAccess access);
+        // Attachments make this a rendering pass, the graph wraps its callback in vkCmdBeginRendering/vkCmdEndRendering.
+        RenderPassBuilder& SetColorAttachment(RenderResource resource, VkClearColorValue clearColor);
+        RenderPassBuilder& SetDepthAttachment(RenderResource resource, float clearDepth);
+        RenderPassBuilder& SetRenderingFlags(VkRenderingFlags flags);
+        // Never culled, for passes whose results leave the graph in other ways (queries, host writes, ...).
+        RenderPassBuilder& SetSideEffect();
+
+    private:
+        VulkanRenderGraph& m_Graph;
+        uint32_t m_Pass;
+    };
+
+    // Frame graph rebuilt every frame. Compile() culls passes that contribute nothing to an output, derives
+    // synchronization2 barriers from the declared accesses and places transient images whose lifetimes do not
+    // overlap in the same memory. Transients are kept per frame slot and only recreated when the layout changes.
+    class VulkanRenderGraph {
+    public:
+        void Initialize(VkDevice device, VulkanMemoryAllocator* allocator, uint32_t frameCount);
+        void Shutdown();
+
+        // Starts a new frame description, the transients of earlier frames stay cached.
+        void Reset();
+        RenderResource ImportImage(VkImage image, VkImageView view, VkFormat format, VkExtent2D extent,
+                                   VkImageAspectFlags aspect, const RenderResourceState& initialState);
+        RenderResource ImportBuffer(VkBuffer buffer, const RenderResourceState& initialState);
+        RenderResource CreateTransientImage(const TransientImageDesc& desc);
+        // The name has to outlive the frame, it doubles as the GPU profiler zone name.
+        RenderPassBuilder AddPass(const char* name, RenderPassExecute execute);
+        // Leaves the resource in the given access once the graph ran. Passes are kept alive through outputs.
+        void MarkOutput(RenderResource resource, RenderAccess finalAccess);
+
+        // The frame slot has to be retired, its transients are reused or replaced.
+        int Compile(uint32_t frameSlot);
+        void Execute(VkCommandBuffer commandBuffer, VulkanGpuProfiler& profiler);
+
+        [[nodiscard]] uint32_t GetCulledPassCount() const { return m_CulledPasses; }
+        [[nodiscard]] uint32_t GetBarrierCount() const { return m_BarrierCount; }
+        // Memory the current slot's transients occupy, and what they would take without aliasing.
+        [[nodiscard]] VkDeviceSize GetTransientBytes() const { return m_TransientBytes; }
+        [[nodiscard]] VkDeviceSize GetUnaliasedTransientBytes() const { return m_UnaliasedTransientBytes; }
+
+    private:
+        friend class RenderPassBuilder;
+
+        enum class ResourceType : uint32_t {
+            Image,
+            Buffer
+        };
+
+        struct Resource {
+            ResourceType type = ResourceType::Image;
+            bool transient = false;
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkFormat format = VK_FORMAT_UNDEFINED;
+            VkExtent2D extent = {};
+            VkImageAspectFlags aspect = 0;
+            TransientImageDesc desc;
+            RenderResourceState initialState;
+            // Index into the slot's transient images.
+            uint32_t transientIndex = UINT32_MAX;
+            bool isOutput = false;
+            RenderAccess finalAccess = RenderAccess::Present;
+        };
+
+        struct ResourceUse {
+            RenderResource resource;
+            RenderAccess access;
+            bool write;
+        };
+
+        struct Attachment {
+            RenderResource resource = InvalidRenderResource;
+            VkClearValue clear = {};
+        };
+
+        struct Pass {
+            const char* name = nullptr;
+            RenderPassExecute execute;
+            std::vector<ResourceUse> uses;
+            std::vector<Attachment> colorAttachments;
+            Attachment depthAttachment;
+            VkRenderingFlags renderingFlags = 0;
+            bool sideEffect = false;
+            bool culled = false;
+            bool discardDepth = false;
+            std::vector<VkImageMemoryBarrier2> imageBarriers;
+            std::vector<VkBufferMemoryBarrier2> bufferBarriers;
+        };
+
+        // Synchronization state of a resource while the barriers are derived.
+        struct TrackedState {
+            VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+            // Stages that read since the last write, a later write or layout change has to wait for them.
+            VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE;
+            // What the last write has already been made visible to.
+            VkPipelineStageFlags2 visibleStages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 visibleAccess = VK_ACCESS_2_NONE;
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        };
+
+        struct TransientImage {
+            TransientImageDesc desc;
+            uint32_t firstPass = 0;
+            uint32_t lastPass = 0;
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            VkDeviceSize offset = 0;
+            VkDeviceSize size = 0;
+            MemoryAllocation ownAllocation;
+            // Earlier transients sharing memory with this one, their last use has to finish before the first use here.
+            std::vector<uint32_t> aliases;
+        };
+
+        struct TransientSlot {
+            std::vector<TransientImage> images;
+            MemoryAllocation allocation;
+            VkDeviceSize bytes = 0;
+            VkDeviceSize unaliasedBytes = 0;
+        };
+
+        void CullPasses();
+        int AllocateTransients(TransientSlot& slot);
+        void DestroyTransients(TransientSlot& slot);
+        void BuildBarriers(const TransientSlot& slot);
+        void AddBarrier(Pass& pass, const Resource& resource, TrackedState& state, RenderAccess access, bool write,
+                        VkPipelineStageFlags2 extraSrcStages, VkAccessFlags2 extraSrcAccess);
+        void RecordBarriers(VkCommandBuffer commandBuffer, const std::vector<VkImageMemoryBarrier2>& imageBarriers,
+                            const std::vector<VkBufferMemoryBarrier2>& bufferBarriers) const;
+
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VulkanMemoryAllocator* m_Allocator = nullptr;
+        std::vector<Resource> m_Resources;
+        std::vector<Pass> m_Passes;
+        std::vector<TransientSlot> m_Slots;
+        // Barriers into the final access of outputs, recorded after the last pass.
+        std::vector<VkImageMemoryBarrier2> m_FinalImageBarriers;
+        std::vector<VkBufferMemoryBarrier2> m_FinalBufferBarriers;
+        uint32_t m_CulledPasses = 0;
+        uint32_t m_BarrierCount = 0;
+        VkDeviceSize m_TransientBytes = 0;
+        VkDeviceSize m_UnaliasedTransientBytes = 0;
+    };
+}
+#endif //REDPLASMA_VULKANRENDERGRAPH_H
\ No newline at end of file
@@ -0,0 +1,91 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+
+#include "VulkanShaders.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace RedPlasma {
+    namespace {
+        constexpr uint32_t SpirvMagic = 0x07230203;
+
+        bool LoadShaderOverride(const std::string& name, std::vector<uint32_t>& outCode) {
+            const char* directory = std::getenv("REDPLASMA_SHADER_DIR");
+            if (directory == nullptr || directory[0] == '\0') {
+                return false;
+            }
+
+            std::string path = std::string(directory) + "/" + name + ".spv";
+            std::ifstream file(path, std::ios::ate | std::ios::binary);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            size_t fileSize = static_cast<size_t>(file.tellg());
+            if (fileSize == 0 || fileSize % sizeof(uint32_t) != 0) {
+                std::cout << "Ignoring " << path << ", not a SPIR-V binary" << std::endl;
+                return false;
+            }
+
+            std::vector<uint32_t> code(fileSize / sizeof(uint32_t));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(code.data()), static_cast<std::streamsize>(fileSize));
+            if (!file.good() || code[0] != SpirvMagic) {
+                std::cout << "Ignoring " << path << ", not a SPIR-V binary" << std::endl;
+                return false;
+            }
+
+            outCode = std::move(code);
+            return true;
+        }
+    }
+
+    bool LoadShaderCode(const std::string& name, std::vector<uint32_t>& outCode) {
+        if (LoadShaderOverride(name, outCode)) {
+            return true;
+        }
+
+        for (size_t i = 0; i < EmbeddedShaderCount; i++) {
+            if (name == EmbeddedShaders[i].name) {
+                outCode.assign(EmbeddedShaders[i].code, EmbeddedShaders[i].code + EmbeddedShaders[i].wordCount);
+                return true;
+            }
+        }
+
+        std::cout << "Shader " << name << " is not part of the engine build" << std::endl;
+        return false;
+    }
+
+    VkShaderModule CreateShaderModule(VkDevice device, const std::string& name) {
+        std::vector<uint32_t> code;
+        if (!LoadShaderCode(name, code)) {
+            return VK_NULL_HANDLE;
+        }
+
+        VkShaderModuleCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = code.size() * sizeof(uint32_t);
+        createInfo.pCode = code.data();
+
+        VkShaderModule shaderModule;
+        if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+            return VK_NULL_HANDLE;
+        }
+
+        return shaderModule;
+    }
+}
@@ -0,0 +1,39 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANSHADERS_H
+#define REDPLASMA_VULKANSHADERS_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    struct EmbeddedShader {
+        // Source file name, e.g. "shader.vert".
+        const char* name;
+        const uint32_t* code;
+        size_t wordCount;
+    };
+
+    // Every shader in SHADER_SOURCES, compiled and embedded by the build (see shaders/EmbeddedShaders.cpp.in).
+    extern const EmbeddedShader EmbeddedShaders[];
+    extern const size_t EmbeddedShaderCount;
+
+    // When REDPLASMA_SHADER_DIR is set, <dir>/<name>.spv wins over the embedded copy so shaders can be
+    // iterated on without relinking the engine.
+    bool LoadShaderCode(const std::string& name, std::vector<uint32_t>& outCode);
+    VkShaderModule CreateShaderModule(VkDevice device, const std::string& name);
+}
+#endif //REDPLASMA_VULKANSHADERS_H
\ No newline at end of file
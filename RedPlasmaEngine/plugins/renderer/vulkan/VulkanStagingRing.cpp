@@ -0,0 +1,57 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+#include "VulkanStagingRing.h"
+
+#include <algorithm>
+
+namespace RedPlasma {
+
+    void VulkanStagingRing::Initialize(void* mapped, VkDeviceSize capacity, uint32_t frameCount) {
+        m_Mapped = static_cast<char*>(mapped);
+        m_Capacity = capacity;
+        m_Head = 0;
+        m_Tail = 0;
+        m_FrameHeads.assign(frameCount, 0);
+    }
+
+    void* VulkanStagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset) {
+        if (m_Mapped == nullptr || size > m_Capacity) {
+            return nullptr;
+        }
+
+        VkDeviceSize head = (m_Head + alignment - 1) & ~(alignment - 1);
+        VkDeviceSize position = head % m_Capacity;
+
+        // Allocations never straddle the end of the buffer, skip the remainder and start over at zero.
+        if (position + size > m_Capacity) {
+            head += m_Capacity - position;
+            position = 0;
+        }
+
+        if (head + size - m_Tail > m_Capacity) {
+            return nullptr;
+        }
+
+        m_Head = head + size;
+        outOffset = position;
+        return m_Mapped + position;
+    }
+
+    void VulkanStagingRing::OnFrameRecorded(uint32_t frameSlot) {
+        m_FrameHeads[frameSlot] = m_Head;
+    }
+
+    void VulkanStagingRing::OnFrameRetired(uint32_t frameSlot) {
+        m_Tail = std::max(m_Tail, m_FrameHeads[frameSlot]);
+    }
+}
@@ -0,0 +1,46 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANSTAGINGRING_H
+#define REDPLASMA_VULKANSTAGINGRING_H
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace RedPlasma {
+    // Bookkeeping for a persistently mapped staging buffer used as a ring. Allocations are handed out at
+    // the head; everything allocated before a frame was submitted is released once that frame retires.
+    class VulkanStagingRing {
+    public:
+        void Initialize(void* mapped, VkDeviceSize capacity, uint32_t frameCount);
+
+        // Returns nullptr if the ring has no room left until older frames retire.
+        void* Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset);
+
+        // The frame in this slot recorded the copies for everything allocated so far.
+        void OnFrameRecorded(uint32_t frameSlot);
+        // The frame in this slot finished on the GPU.
+        void OnFrameRetired(uint32_t frameSlot);
+
+        [[nodiscard]] VkDeviceSize GetCapacity() const { return m_Capacity; }
+        [[nodiscard]] VkDeviceSize GetUsed() const { return m_Head - m_Tail; }
+
+    private:
+        // Monotonic byte counters, the position in the buffer is counter % capacity.
+        VkDeviceSize m_Head = 0;
+        VkDeviceSize m_Tail = 0;
+        VkDeviceSize m_Capacity = 0;
+        char* m_Mapped = nullptr;
+        std::vector<VkDeviceSize> m_FrameHeads;
+    };
+}
+#endif //REDPLASMA_VULKANSTAGINGRING_H
\ No newline at end of file
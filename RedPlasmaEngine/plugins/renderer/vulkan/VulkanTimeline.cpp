@@ -0,0 +1,110 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#include "VulkanTimeline.h"
+
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+namespace RedPlasma {
+
+    int VulkanTimeline::Initialize(VkDevice device) {
+        m_Device = device;
+        m_LastSubmitted = 0;
+        m_Completed = 0;
+
+        VkSemaphoreTypeCreateInfo typeInfo = {};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+        if (vkCreateSemaphore(m_Device, &semaphoreInfo, nullptr, &m_Semaphore) != VK_SUCCESS) {
+            std::cout << "Failed to create a timeline semaphore" << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    void VulkanTimeline::Shutdown() {
+        std::vector<Deferred> deferred;
+        {
+            std::lock_guard<std::mutex> lock(m_DeferredMutex);
+            deferred.swap(m_Deferred);
+        }
+        for (auto& entry : deferred) {
+            entry.destroy();
+        }
+
+        if (m_Semaphore != VK_NULL_HANDLE) {
+            vkDestroySemaphore(m_Device, m_Semaphore, nullptr);
+            m_Semaphore = VK_NULL_HANDLE;
+        }
+        m_Device = VK_NULL_HANDLE;
+    }
+
+    uint64_t VulkanTimeline::Poll() {
+        uint64_t value = 0;
+        if (m_Semaphore != VK_NULL_HANDLE && vkGetSemaphoreCounterValue(m_Device, m_Semaphore, &value) == VK_SUCCESS) {
+            // Another thread may have seen a newer value in the meantime, never move backwards.
+            uint64_t completed = m_Completed;
+            while (value > completed && !m_Completed.compare_exchange_weak(completed, value)) {
+            }
+        }
+        return m_Completed;
+    }
+
+    bool VulkanTimeline::Wait(uint64_t value, uint64_t timeoutNs) {
+        if (IsComplete(value)) {
+            return true;
+        }
+
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_Semaphore;
+        waitInfo.pValues = &value;
+        if (vkWaitSemaphores(m_Device, &waitInfo, timeoutNs) != VK_SUCCESS) {
+            return false;
+        }
+        Poll();
+        return true;
+    }
+
+    void VulkanTimeline::Defer(uint64_t value, std::function<void()> destroy) {
+        std::lock_guard<std::mutex> lock(m_DeferredMutex);
+        m_Deferred.push_back({ value, std::move(destroy) });
+    }
+
+    void VulkanTimeline::Collect() {
+        uint64_t completed = Poll();
+
+        // Run outside the lock, destroy callbacks may take locks of their own.
+        std::vector<Deferred> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_DeferredMutex);
+            size_t count = 0;
+            while (count < m_Deferred.size() && m_Deferred[count].value <= completed) {
+                count++;
+            }
+            ready.assign(std::make_move_iterator(m_Deferred.begin()), std::make_move_iterator(m_Deferred.begin() + count));
+            m_Deferred.erase(m_Deferred.begin(), m_Deferred.begin() + count);
+        }
+        for (auto& entry : ready) {
+            entry.destroy();
+        }
+    }
+}
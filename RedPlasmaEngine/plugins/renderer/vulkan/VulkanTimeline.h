@@ -0,0 +1,68 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_VULKANTIMELINE_H
+#define REDPLASMA_VULKANTIMELINE_H
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    // Timeline semaphore for one queue. Every submission signals the next value, so "has this work finished"
+    // is a single counter compare instead of a fence per object.
+    class VulkanTimeline {
+    public:
+        int Initialize(VkDevice device);
+        // Expects the queue to be idle, runs whatever is still deferred.
+        void Shutdown();
+
+        // Value the next submission signals. Work recorded now retires once it is reached.
+        [[nodiscard]] uint64_t GetNextValue() const { return m_LastSubmitted + 1; }
+        // Claims the next value for a submission.
+        uint64_t Advance() { return ++m_LastSubmitted; }
+        [[nodiscard]] uint64_t GetLastSubmitted() const { return m_LastSubmitted; }
+
+        // Asks the GPU how far it got. Safe from any thread.
+        uint64_t Poll();
+        // Last value seen by Poll or Wait, without touching the GPU.
+        [[nodiscard]] uint64_t GetCompleted() const { return m_Completed; }
+        [[nodiscard]] bool IsComplete(uint64_t value) const { return value <= m_Completed; }
+        // Returns false on timeout or device loss.
+        bool Wait(uint64_t value, uint64_t timeoutNs = UINT64_MAX);
+
+        // Runs destroy once value has completed. Callable from any thread.
+        void Defer(uint64_t value, std::function<void()> destroy);
+        // Runs everything deferred up to the completed value.
+        void Collect();
+
+        [[nodiscard]] VkSemaphore GetSemaphore() const { return m_Semaphore; }
+
+    private:
+        struct Deferred {
+            uint64_t value;
+            std::function<void()> destroy;
+        };
+
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkSemaphore m_Semaphore = VK_NULL_HANDLE;
+        uint64_t m_LastSubmitted = 0;
+        std::atomic<uint64_t> m_Completed{0};
+        std::mutex m_DeferredMutex;
+        // Ordered by value, deferrals only ever target the next or an earlier submission.
+        std::vector<Deferred> m_Deferred;
+    };
+}
+#endif //REDPLASMA_VULKANTIMELINE_H
\ No newline at end of file
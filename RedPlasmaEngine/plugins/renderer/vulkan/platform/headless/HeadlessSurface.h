@@ -0,0 +1,65 @@
+// /*
+//  * Red Plasma Engine
+//  * Copyright (C) 2026  Kim Johansson
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation...
+//  *
+
+//
+// Created by Dueloss on 16.10.2026.
+//
+
+#ifndef REDPLASMA_HEADLESSSURFACE_H
+#define REDPLASMA_HEADLESSSURFACE_H
+#include "renderer/IWindowSurface.h"
+#include <vulkan/vulkan.h>
+
+namespace RedPlasma {
+    // Surface without a display server (VK_EXT_headless_surface). Presents are consumed by the driver,
+    // so the normal swapchain path runs unchanged on e.g. Mesa lavapipe in CI.
+    class HeadlessSurface : public IWindowSurface {
+    public:
+        HeadlessSurface(int width, int height) :
+        m_width(width),
+        m_height(height) {}
+
+        ~HeadlessSurface() override = default;
+
+        [[nodiscard]] std::vector<const char*> GetRequiredExtensions() const override {
+            return {
+                VK_KHR_SURFACE_EXTENSION_NAME,
+                VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME
+            };
+        }
+        VkSurfaceKHR CreateSurface(VkInstance instance) override {
+            // Extension entry points are not exported by the loader, resolve it through the instance.
+            auto createHeadlessSurface = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+                vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+            if (createHeadlessSurface == nullptr) {
+                return VK_NULL_HANDLE;
+            }
+
+            VkHeadlessSurfaceCreateInfoEXT createInfo = {};
+            createInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+            createHeadlessSurface(instance, &createInfo, nullptr, &m_Surface);
+            return m_Surface;
+        }
+        [[nodiscard]] void* GetSurfaceHandle() override { return m_Surface; }
+        void UpdateSize(int w, int h) {
+            m_width = w;
+            m_height = h;
+        }
+
+        [[nodiscard]] int GetWidth() const override { return m_width; }
+        [[nodiscard]] int GetHeight() const override { return m_height; }
+
+    private:
+        int m_width = 800;
+        int m_height = 600;
+        VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
+    };
+}
+#endif //REDPLASMA_HEADLESSSURFACE_H
\ No newline at end of file
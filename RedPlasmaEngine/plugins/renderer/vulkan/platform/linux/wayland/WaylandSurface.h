@@ -14,6 +14,7 @@
 #ifndef REDPLASMA_WAYLANDSURFACE_H
 #define REDPLASMA_WAYLANDSURFACE_H
 #include "renderer/IWindowSurface.h"
+#include <atomic>
 #include <vulkan/vulkan_wayland.h>
 
 namespace RedPlasma {
@@ -60,8 +61,9 @@ namespace RedPlasma {
     private:
         void* m_display;
         void* m_window;
-        int m_width = 800;
-        int m_height = 600;
+        // Written by the window system callbacks, read by the render thread in threaded mode.
+        std::atomic<int> m_width{800};
+        std::atomic<int> m_height{600};
         VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
     };
 }
@@ -1,8 +1,17 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTexture;
 layout(location = 0) out vec4 outColor;
 
+// Bindless sampler and images, see VulkanBindlessHeap.h.
+layout(set = 0, binding = 0) uniform sampler linearSampler;
+layout(set = 0, binding = 1) uniform texture2D textures[];
+
 void main() {
-    outColor = vec4(fragColor, 1.0);
+    // A flat input is not provably uniform across the draw, so the index is marked non-uniform.
+    vec4 texel = texture(sampler2D(textures[nonuniformEXT(fragTexture)], linearSampler), fragTexCoord);
+    outColor = vec4(fragColor * texel.rgb, 1.0);
 }
\ No newline at end of file
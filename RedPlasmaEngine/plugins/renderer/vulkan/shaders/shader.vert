@@ -1,12 +1,33 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
-layout(location = 0) out vec3 fragColor;
+layout(location = 0) in vec3 inPosition;
+// Per-instance model matrix, one column per location.
+layout(location = 1) in mat4 inModel;
+// Material index, resolved per instance by the CPU batches or the culling pass.
+layout(location = 5) in uint inMaterial;
 
-vec2 positions[3] = vec2[](
-    vec2(0.0, -0.5),
-    vec2(0.5, 0.5),
-    vec2(-0.5, 0.5)
-);
+// Must match GpuMaterial in VulkanGraphicsDevice.cpp.
+struct Material {
+    vec4 color;
+    uint texture;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+// Bindless storage buffers, see VulkanBindlessHeap.h.
+layout(std430, set = 0, binding = 2) readonly buffer MaterialBuffer { Material materials[]; } storageBuffers[];
+
+layout(push_constant) uniform DrawConstants {
+    mat4 viewProjection;
+    // Bindless index of the material buffer.
+    uint materialBuffer;
+} constants;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTexture;
 
 vec3 colors[3] = vec3[](
     vec3(1.0, 0.0, 0.0),
@@ -15,6 +36,10 @@ vec3 colors[3] = vec3[](
 );
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
+    Material material = storageBuffers[constants.materialBuffer].materials[inMaterial];
+    gl_Position = constants.viewProjection * inModel * vec4(inPosition, 1.0);
+    fragColor = colors[gl_VertexIndex % 3] * material.color.rgb;
+    // Vertices carry no texture coordinates yet, project the mesh space xy plane instead.
+    fragTexCoord = inPosition.xy * 0.5 + 0.5;
+    fragTexture = material.texture;
 }
\ No newline at end of file